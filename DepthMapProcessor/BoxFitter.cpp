@@ -0,0 +1,156 @@
+#include "BoxFitter.h"
+#include <cmath>
+#include "TraceRecorder.h"
+
+namespace
+{
+	const float Pi = 3.14159265359f;
+
+	const float Dot(const cv::Point2f& a, const cv::Point2f& b)
+	{
+		return a.x * b.x + a.y * b.y;
+	}
+
+	// moves a caliper forward while the next vertex is further along the direction
+	const int AdvanceCaliper(const std::vector<cv::Point2f>& hull, int index, const cv::Point2f& direction)
+	{
+		const int count = (int)hull.size();
+		for (int i = 0; i < count; i++)
+		{
+			const int nextIndex = (index + 1) % count;
+			if (Dot(hull[nextIndex], direction) <= Dot(hull[index], direction))
+				break;
+
+			index = nextIndex;
+		}
+
+		return index;
+	}
+}
+
+const BoxFootprint BoxFitter::FitImageContour(const ContourGeometry& contour, const CameraIntrinsics& intrinsics, const short depth)
+{
+	TRACE_SCOPE("BoxFitter::FitImageContour");
+
+	if (contour.IsEmpty() || depth <= 0)
+		return BoxFootprint{ 0, 0, 0 };
+
+	// deprojection at a single depth keeps the hull convex, so the contour's image space hull is used
+	const Contour& imageHull = contour.GetHull();
+
+	std::vector<cv::Point2f> worldHull;
+	worldHull.reserve(imageHull.size());
+	for (int i = 0; i < imageHull.size(); i++)
+	{
+		const float xWorld = (imageHull[i].x + 1 - intrinsics.PrincipalPointX) * depth / intrinsics.FocalLengthX;
+		const float yWorld = -(imageHull[i].y + 1 - intrinsics.PrincipalPointY) * depth / intrinsics.FocalLengthY;
+		worldHull.emplace_back(cv::Point2f(xWorld, yWorld));
+	}
+
+	return FitConvexPolygon(worldHull);
+}
+
+const BoxFootprint BoxFitter::FitWorldPoints(const std::vector<DepthValue>& points)
+{
+	TRACE_SCOPE("BoxFitter::FitWorldPoints");
+
+	if (points.empty())
+		return BoxFootprint{ 0, 0, 0 };
+
+	std::vector<cv::Point2f> worldPoints;
+	worldPoints.reserve(points.size());
+	for (int i = 0; i < points.size(); i++)
+		worldPoints.emplace_back(cv::Point2f((float)points[i].XWorld, (float)points[i].YWorld));
+
+	std::vector<cv::Point2f> worldHull;
+	cv::convexHull(worldPoints, worldHull);
+
+	return FitConvexPolygon(worldHull);
+}
+
+const BoxFootprint BoxFitter::FitConvexPolygon(const std::vector<cv::Point2f>& hull)
+{
+	const int count = (int)hull.size();
+	if (count < 2)
+		return BoxFootprint{ 0, 0, 0 };
+
+	// the normal of every edge has to point inside, which side that is depends on the orientation
+	float doubleArea = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const cv::Point2f& a = hull[i];
+		const cv::Point2f& b = hull[(i + 1) % count];
+		doubleArea += a.x * b.y - b.x * a.y;
+	}
+	const float normalSign = doubleArea < 0 ? -1.0f : 1.0f;
+
+	// one side of the best rectangle lies on a hull edge, the other three calipers only ever move forward
+	int maxAlongIndex = 0;
+	int minAlongIndex = 0;
+	int maxAcrossIndex = 0;
+	bool calipersArePlaced = false;
+
+	float bestArea = -1;
+	float bestAlongExtent = 0;
+	float bestAcrossExtent = 0;
+	cv::Point2f bestDirection(1, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		const cv::Point2f& edge = hull[(i + 1) % count] - hull[i];
+		const float edgeLength = std::sqrt(Dot(edge, edge));
+		if (edgeLength <= 0)
+			continue;
+
+		const cv::Point2f direction(edge.x / edgeLength, edge.y / edgeLength);
+		const cv::Point2f normal(-direction.y * normalSign, direction.x * normalSign);
+
+		if (!calipersArePlaced)
+		{
+			for (int k = 0; k < count; k++)
+			{
+				if (Dot(hull[k], direction) > Dot(hull[maxAlongIndex], direction))
+					maxAlongIndex = k;
+				if (Dot(hull[k], direction) < Dot(hull[minAlongIndex], direction))
+					minAlongIndex = k;
+				if (Dot(hull[k], normal) > Dot(hull[maxAcrossIndex], normal))
+					maxAcrossIndex = k;
+			}
+
+			calipersArePlaced = true;
+		}
+		else
+		{
+			maxAlongIndex = AdvanceCaliper(hull, maxAlongIndex, direction);
+			minAlongIndex = AdvanceCaliper(hull, minAlongIndex, -direction);
+			maxAcrossIndex = AdvanceCaliper(hull, maxAcrossIndex, normal);
+		}
+
+		const float alongExtent = Dot(hull[maxAlongIndex] - hull[minAlongIndex], direction);
+		const float acrossExtent = Dot(hull[maxAcrossIndex] - hull[i], normal);
+		const float area = alongExtent * acrossExtent;
+		if (bestArea >= 0 && area >= bestArea)
+			continue;
+
+		bestArea = area;
+		bestAlongExtent = alongExtent;
+		bestAcrossExtent = acrossExtent;
+		bestDirection = direction;
+	}
+
+	const bool edgeIsLength = bestAlongExtent >= bestAcrossExtent;
+	const cv::Point2f& lengthDirection = edgeIsLength ? bestDirection : cv::Point2f(-bestDirection.y, bestDirection.x);
+
+	float angle = std::atan2(lengthDirection.y, lengthDirection.x) * 180 / Pi;
+	if (angle < 0)
+		angle += 180;
+	if (angle >= 180)
+		angle -= 180;
+
+	BoxFootprint footprint{};
+	footprint.LengthMm = edgeIsLength ? bestAlongExtent : bestAcrossExtent;
+	footprint.WidthMm = edgeIsLength ? bestAcrossExtent : bestAlongExtent;
+	footprint.AngleDeg = angle;
+
+	return footprint;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include "Structures.h"
+#include "OpenCVInclude.h"
+#include "ContourGeometry.h"
+
+// smallest world space rectangle around a footprint, AngleDeg is the direction of its length side in [0, 180)
+struct BoxFootprint
+{
+	float LengthMm;
+	float WidthMm;
+	float AngleDeg;
+};
+
+// fits footprints in world space with rotating calipers over the convex hull's deprojected vertices
+class BoxFitter
+{
+public:
+	// the contour is taken to lie on a plane at the given depth
+	static const BoxFootprint FitImageContour(const ContourGeometry& contour, const CameraIntrinsics& intrinsics, const short depth);
+	// the points are already in world millimeters, each deprojected at its own depth
+	static const BoxFootprint FitWorldPoints(const std::vector<DepthValue>& points);
+	// the polygon must be convex, in either orientation
+	static const BoxFootprint FitConvexPolygon(const std::vector<cv::Point2f>& hull);
+};
@@ -1,16 +1,19 @@
 #include "CalculationUtils.h"
+#include <climits>
+#include "TraceRecorder.h"
 
-const std::vector<DepthValue> CalculationUtils::GetWorldDepthValues(const Contour& objectContour, const short*const depthMapBuffer,
+const std::vector<DepthValue> CalculationUtils::GetWorldDepthValues(const ContourGeometry& objectGeometry, const short*const depthMapBuffer,
 	const int mapWidth, const CameraIntrinsics& intrinsics)
 {
 	const double PI = 3.14159265359;
 
+	const Contour& objectContour = objectGeometry.GetContour();
 	std::vector<DepthValue> depthValues;
 	depthValues.reserve(objectContour.size());
 
-	const cv::Moments& m = cv::moments(objectContour);
-	const int cx = (int)(m.m10 / m.m00);
-	const int cy = (int)(m.m01 / m.m00);
+	const cv::Point2f& center = objectGeometry.GetCenter();
+	const int cx = (int)center.x;
+	const int cy = (int)center.y;
 
 	for (int i = 0; i < objectContour.size(); i++)
 	{
@@ -129,23 +132,38 @@ const std::vector<cv::Point> CalculationUtils::GetCameraPoints(const std::vector
 	return cameraPoints;
 }
 
-void CalculationUtils::GetWorldDepthValuesFromDepthMap(const int mapWidth, const int mapHeight, 
-	const short*const depthMapBuffer, const CameraIntrinsics& intrinsics, DepthValue*const worldDepthValues)
+
+const long long CalculationUtils::GetIntegratedVolume(const ContourGeometry& objectContour, const short*const depthMapBuffer,
+	const short*const floorDepths, const int mapWidth, const CameraIntrinsics& intrinsics, const short holeDepth)
 {
-	int throughIndex = 0;
+	TRACE_SCOPE("CalculationUtils::GetIntegratedVolume");
+
+	if (objectContour.GetContour().size() < 3)
+		return 0;
+
+	const cv::Rect& boundingRect = objectContour.GetBoundingRect();
+	cv::Mat objectMask = cv::Mat::zeros(boundingRect.height, boundingRect.width, CV_8UC1);
+	const std::vector<Contour> contours = { objectContour.GetContour() };
+	cv::drawContours(objectMask, contours, 0, cv::Scalar(255), cv::FILLED, cv::LINE_8, cv::Mat(), INT_MAX,
+		cv::Point(-boundingRect.x, -boundingRect.y));
+
+	// a pixel at depth d covers (d / fx) * (d / fy) square millimeters, so each column adds height * d^2 / (fx * fy)
+	long long weightedHeightSum = 0;
 
-	for (int j = 0; j < mapHeight; j++)
+	for (int j = 0; j < boundingRect.height; j++)
 	{
-		for (int i = 0; i < mapWidth; i++)
+		const byte* maskRow = objectMask.ptr<byte>(j);
+		const int rowOffset = (boundingRect.y + j) * mapWidth + boundingRect.x;
+		const short* depthRow = depthMapBuffer + rowOffset;
+		const short* floorRow = floorDepths + rowOffset;
+
+		for (int i = 0; i < boundingRect.width; i++)
 		{
-			const short depth = depthMapBuffer[j * mapWidth + i];
-			const int xWorld = (int)((i + 1 - intrinsics.PrincipalPointX) * depth / intrinsics.FocalLengthX);
-			const int yWorld = (int)(-(j + 1 - intrinsics.PrincipalPointY) * depth / intrinsics.FocalLengthY);
-
-			DepthValue& depthValue = worldDepthValues[throughIndex++];
-			depthValue.Value = depth;
-			depthValue.XWorld = xWorld;
-			depthValue.YWorld = yWorld;
+			const int depth = depthRow[i] > 0 ? depthRow[i] : holeDepth;
+			const int height = maskRow[i] > 0 ? std::max(floorRow[i] - depth, 0) : 0;
+			weightedHeightSum += (long long)height * depth * depth;
 		}
 	}
-}
+
+	return (long long)(weightedHeightSum / ((double)intrinsics.FocalLengthX * intrinsics.FocalLengthY));
+}
\ No newline at end of file
@@ -2,14 +2,15 @@
 
 #include <vector>
 #include "Structures.h"
+#include "ContourGeometry.h"
 
 class CalculationUtils
 {
 public:
-	static const std::vector<DepthValue> GetWorldDepthValues(const Contour& objectContour, const short*const depthMapBuffer,
+	static const std::vector<DepthValue> GetWorldDepthValues(const ContourGeometry& objectGeometry, const short*const depthMapBuffer,
 		const int mapWidth, const CameraIntrinsics& intrinsics);
 	static const std::vector<cv::Point> GetCameraPoints(const std::vector<DepthValue>& depthValues, const short targetDepth,
 		const CameraIntrinsics& intrinsics);
-	static void GetWorldDepthValuesFromDepthMap(const int mapWidth, const int mapHeight,
-		const short* const depthMapBuffer, const CameraIntrinsics& intrinsics, DepthValue*const worldDepthValues);
+	static const long long GetIntegratedVolume(const ContourGeometry& objectContour, const short*const depthMapBuffer,
+		const short*const floorDepths, const int mapWidth, const CameraIntrinsics& intrinsics, const short holeDepth);
 };
\ No newline at end of file
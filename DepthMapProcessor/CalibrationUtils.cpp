@@ -0,0 +1,481 @@
+#include "CalibrationUtils.h"
+#include "DmUtils.h"
+#include "FloorPlaneEstimator.h"
+#include "TraceRecorder.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+const short MinMeasurementDepth = 600;
+const short PolygonDepthOffset = 50;
+const float ZoneBorderMarginMm = 2.0f; // covers truncation of world coordinates to whole millimeters
+const int ZoneCrossingSearchWindow = 16; // depths around an outline crossing that are checked exactly
+const char CalibrationFileMagic[8] = { 'V', 'C', 'C', 'A', 'L', 'I', 'B', '2' };
+
+namespace
+{
+	const unsigned long long FnvOffsetBasis = 14695981039346656037ULL;
+	const unsigned long long FnvPrime = 1099511628211ULL;
+
+	void HashBytes(unsigned long long& hash, const void* data, const size_t length)
+	{
+		const byte* bytes = (const byte*)data;
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FnvPrime;
+		}
+	}
+
+	const unsigned long GetCurrentProcessNumber()
+	{
+#ifdef _WIN32
+		return GetCurrentProcessId();
+#else
+		return (unsigned long)getpid();
+#endif
+	}
+
+	template<typename T>
+	void WriteValue(std::ofstream& stream, const T& value)
+	{
+		stream.write((const char*)&value, sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadValue(std::ifstream& stream, T& value)
+	{
+		stream.read((char*)&value, sizeof(T));
+		return stream.good();
+	}
+}
+
+const unsigned long long CalibrationUtils::GetCalibrationKey(const CalibrationSettings& settings)
+{
+	unsigned long long hash = FnvOffsetBasis;
+
+	HashBytes(hash, CalibrationFileMagic, sizeof(CalibrationFileMagic));
+	HashBytes(hash, &settings.DepthIntrinsics, sizeof(CameraIntrinsics));
+	HashBytes(hash, &settings.MapWidth, sizeof(int));
+	HashBytes(hash, &settings.MapHeight, sizeof(int));
+	HashBytes(hash, &settings.FloorDepth, sizeof(short));
+	HashBytes(hash, &settings.CutOffDepth, sizeof(short));
+	HashBytes(hash, &settings.FloorPlane.Offset, sizeof(float));
+	HashBytes(hash, &settings.FloorPlane.SlopeX, sizeof(float));
+	HashBytes(hash, &settings.FloorPlane.SlopeY, sizeof(float));
+
+	const int pointCount = (int)settings.PolygonPoints.size();
+	HashBytes(hash, &pointCount, sizeof(int));
+	for (int i = 0; i < pointCount; i++)
+	{
+		HashBytes(hash, &settings.PolygonPoints[i].x, sizeof(float));
+		HashBytes(hash, &settings.PolygonPoints[i].y, sizeof(float));
+	}
+
+	return hash;
+}
+
+std::shared_ptr<const CalibrationState> CalibrationUtils::LoadOrBuildCalibration(const CalibrationSettings& settings,
+	const std::string& cacheDirectory)
+{
+	if (cacheDirectory == "")
+		return BuildCalibration(settings);
+
+	const unsigned long long key = GetCalibrationKey(settings);
+	const std::string& filepath = GetCalibrationFilePath(cacheDirectory, key);
+
+	std::shared_ptr<const CalibrationState> calibration = LoadCalibration(filepath, key);
+	if (calibration != nullptr)
+		return calibration;
+
+	calibration = BuildCalibration(settings);
+	SaveCalibration(filepath, *calibration);
+
+	return calibration;
+}
+
+std::shared_ptr<const CalibrationState> CalibrationUtils::BuildCalibration(const CalibrationSettings& settings)
+{
+	TRACE_SCOPE("CalibrationUtils::BuildCalibration");
+
+	const int mapWidth = settings.MapWidth;
+	const int mapHeight = settings.MapHeight;
+	const CameraIntrinsics& intrinsics = settings.DepthIntrinsics;
+
+	auto calibration = std::make_shared<CalibrationState>();
+	calibration->Key = GetCalibrationKey(settings);
+	calibration->MapWidth = mapWidth;
+	calibration->MapHeight = mapHeight;
+	calibration->ColumnFactors.resize(mapWidth);
+	for (int i = 0; i < mapWidth; i++)
+		calibration->ColumnFactors[i] = (i + 1 - intrinsics.PrincipalPointX) / intrinsics.FocalLengthX;
+
+	calibration->RowFactors.resize(mapHeight);
+	for (int j = 0; j < mapHeight; j++)
+		calibration->RowFactors[j] = -(j + 1 - intrinsics.PrincipalPointY) / intrinsics.FocalLengthY;
+
+	const int mapLength = mapWidth * mapHeight;
+	calibration->FloorDepths.assign(mapLength, settings.FloorDepth);
+	calibration->CutOffDepths.assign(mapLength, settings.CutOffDepth);
+
+	// with a tilted floor the cut-off keeps the same height above the floor under every pixel
+	short maxFloorDepth = settings.FloorDepth;
+	if (FloorPlaneEstimator::IsPlaneSet(settings.FloorPlane))
+	{
+		const short minObjectHeight = settings.FloorDepth - settings.CutOffDepth;
+		maxFloorDepth = 0;
+
+		for (int j = 0; j < mapHeight; j++)
+		{
+			for (int i = 0; i < mapWidth; i++)
+			{
+				const short floorDepth = FloorPlaneEstimator::GetFloorDepth(settings.FloorPlane,
+					calibration->ColumnFactors[i], calibration->RowFactors[j]);
+				calibration->FloorDepths[j * mapWidth + i] = floorDepth;
+				calibration->CutOffDepths[j * mapWidth + i] = floorDepth - minObjectHeight;
+				maxFloorDepth = std::max(maxFloorDepth, floorDepth);
+			}
+		}
+	}
+
+	calibration->Volume = GetMeasurementVolume(settings);
+	calibration->Volume.largerDepthValue = maxFloorDepth;
+
+	calibration->ZoneTable.assign(mapLength, ZoneStatus::OutOfZone);
+	calibration->MinZoneDepths.assign(mapLength, 1);
+	calibration->MaxZoneDepths.assign(mapLength, 0);
+
+	if (calibration->Volume.Points.size() < 3)
+		return calibration;
+
+	for (int j = 0; j < mapHeight; j++)
+	{
+		for (int i = 0; i < mapWidth; i++)
+		{
+			const int index = j * mapWidth + i;
+			calibration->ZoneTable[index] = GetPixelZoneRange(i, j, calibration->ColumnFactors[i], calibration->RowFactors[j],
+				calibration->CutOffDepths[index], settings.DepthIntrinsics, calibration->Volume,
+				calibration->MinZoneDepths[index], calibration->MaxZoneDepths[index]);
+		}
+	}
+
+	return calibration;
+}
+
+std::shared_ptr<const CalibrationState> CalibrationUtils::LoadCalibration(const std::string& filepath,
+	const unsigned long long key)
+{
+	std::ifstream stream(filepath, std::ios::binary);
+	if (!stream.good())
+		return nullptr;
+
+	char magic[sizeof(CalibrationFileMagic)];
+	stream.read(magic, sizeof(magic));
+	if (!stream.good() || memcmp(magic, CalibrationFileMagic, sizeof(magic)) != 0)
+		return nullptr;
+
+	auto calibration = std::make_shared<CalibrationState>();
+	int pointCount = 0;
+
+	const bool headerIsRead = ReadValue(stream, calibration->Key) && ReadValue(stream, calibration->MapWidth) &&
+		ReadValue(stream, calibration->MapHeight) && ReadValue(stream, calibration->Volume.smallerDepthValue) &&
+		ReadValue(stream, calibration->Volume.largerDepthValue) && ReadValue(stream, pointCount);
+	if (!headerIsRead || calibration->Key != key)
+		return nullptr;
+
+	const int mapWidth = calibration->MapWidth;
+	const int mapHeight = calibration->MapHeight;
+	const bool sizesAreValid = mapWidth > 0 && mapHeight > 0 && pointCount >= 0 && pointCount < 1024;
+	if (!sizesAreValid)
+		return nullptr;
+
+	calibration->Volume.Points.resize(pointCount);
+	for (int i = 0; i < pointCount; i++)
+	{
+		if (!ReadValue(stream, calibration->Volume.Points[i].x) || !ReadValue(stream, calibration->Volume.Points[i].y))
+			return nullptr;
+	}
+
+	calibration->ColumnFactors.resize(mapWidth);
+	calibration->RowFactors.resize(mapHeight);
+	calibration->ZoneTable.resize(mapWidth * mapHeight);
+	calibration->MinZoneDepths.resize(mapWidth * mapHeight);
+	calibration->MaxZoneDepths.resize(mapWidth * mapHeight);
+	calibration->FloorDepths.resize(mapWidth * mapHeight);
+	calibration->CutOffDepths.resize(mapWidth * mapHeight);
+
+	stream.read((char*)calibration->ColumnFactors.data(), mapWidth * sizeof(float));
+	stream.read((char*)calibration->RowFactors.data(), mapHeight * sizeof(float));
+	stream.read((char*)calibration->ZoneTable.data(), mapWidth * mapHeight * sizeof(byte));
+	stream.read((char*)calibration->MinZoneDepths.data(), mapWidth * mapHeight * sizeof(short));
+	stream.read((char*)calibration->MaxZoneDepths.data(), mapWidth * mapHeight * sizeof(short));
+	stream.read((char*)calibration->FloorDepths.data(), mapWidth * mapHeight * sizeof(short));
+	stream.read((char*)calibration->CutOffDepths.data(), mapWidth * mapHeight * sizeof(short));
+	if (!stream.good())
+		return nullptr;
+
+	return calibration;
+}
+
+const bool CalibrationUtils::SaveCalibration(const std::string& filepath, const CalibrationState& calibration)
+{
+	// written under a temporary name so that a concurrent reader never sees a partial file,
+	// the name is unique to the writing thread as other processors may share the cache directory
+	std::stringstream tempFilename;
+	const size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+	tempFilename << filepath << "." << GetCurrentProcessNumber() << "_" << std::hex << threadId << ".tmp";
+	const std::string& tempFilepath = tempFilename.str();
+
+	{
+		std::ofstream stream(tempFilepath, std::ios::binary | std::ios::trunc);
+		if (!stream.good())
+			return false;
+
+		const int pointCount = (int)calibration.Volume.Points.size();
+
+		stream.write(CalibrationFileMagic, sizeof(CalibrationFileMagic));
+		WriteValue(stream, calibration.Key);
+		WriteValue(stream, calibration.MapWidth);
+		WriteValue(stream, calibration.MapHeight);
+		WriteValue(stream, calibration.Volume.smallerDepthValue);
+		WriteValue(stream, calibration.Volume.largerDepthValue);
+		WriteValue(stream, pointCount);
+
+		for (int i = 0; i < pointCount; i++)
+		{
+			WriteValue(stream, calibration.Volume.Points[i].x);
+			WriteValue(stream, calibration.Volume.Points[i].y);
+		}
+
+		stream.write((const char*)calibration.ColumnFactors.data(), calibration.ColumnFactors.size() * sizeof(float));
+		stream.write((const char*)calibration.RowFactors.data(), calibration.RowFactors.size() * sizeof(float));
+		stream.write((const char*)calibration.ZoneTable.data(), calibration.ZoneTable.size() * sizeof(byte));
+		stream.write((const char*)calibration.MinZoneDepths.data(), calibration.MinZoneDepths.size() * sizeof(short));
+		stream.write((const char*)calibration.MaxZoneDepths.data(), calibration.MaxZoneDepths.size() * sizeof(short));
+		stream.write((const char*)calibration.FloorDepths.data(), calibration.FloorDepths.size() * sizeof(short));
+		stream.write((const char*)calibration.CutOffDepths.data(), calibration.CutOffDepths.size() * sizeof(short));
+
+		if (!stream.good())
+		{
+			stream.close();
+			std::remove(tempFilepath.c_str());
+			return false;
+		}
+	}
+
+	std::remove(filepath.c_str());
+
+	const bool fileIsRenamed = std::rename(tempFilepath.c_str(), filepath.c_str()) == 0;
+	if (!fileIsRenamed)
+		std::remove(tempFilepath.c_str());
+
+	return fileIsRenamed;
+}
+
+const std::string CalibrationUtils::GetCalibrationFilePath(const std::string& cacheDirectory, const unsigned long long key)
+{
+	std::stringstream filename;
+	filename << cacheDirectory << "/calibration_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+
+	return filename.str();
+}
+
+const MeasurementVolume CalibrationUtils::GetMeasurementVolume(const CalibrationSettings& settings)
+{
+	const CameraIntrinsics& intrinsics = settings.DepthIntrinsics;
+	const int polygonDepth = settings.FloorDepth + PolygonDepthOffset;
+
+	MeasurementVolume volume;
+	volume.largerDepthValue = settings.FloorDepth;
+	volume.smallerDepthValue = MinMeasurementDepth;
+	volume.Points.reserve(settings.PolygonPoints.size());
+
+	for (int i = 0; i < settings.PolygonPoints.size(); i++)
+	{
+		cv::Point point((int)(settings.PolygonPoints[i].x * settings.MapWidth), (int)(settings.PolygonPoints[i].y * settings.MapHeight));
+		const int x0World = (int)((point.x + 1 - intrinsics.PrincipalPointX) * polygonDepth / intrinsics.FocalLengthX);
+		const int y0World = (int)(-(point.y + 1 - intrinsics.PrincipalPointY) * polygonDepth / intrinsics.FocalLengthY);
+		volume.Points.emplace_back(cv::Point(x0World, y0World));
+	}
+
+	return volume;
+}
+
+const ZoneStatus CalibrationUtils::GetPixelZoneRange(const int x, const int y, const float columnFactor, const float rowFactor,
+	const short cutOffDepth, const CameraIntrinsics& intrinsics, const MeasurementVolume& volume, short& minDepth, short& maxDepth)
+{
+	const int nearDepth = volume.smallerDepthValue;
+	const int farDepth = std::min(volume.largerDepthValue, cutOffDepth);
+	if (nearDepth > farDepth)
+		return ZoneStatus::OutOfZone;
+
+	// the world points of a pixel over its depth range form a segment from the origin outwards
+	const auto getWorldPoint = [columnFactor, rowFactor](const float depth)
+	{
+		return cv::Point2f(columnFactor * depth, rowFactor * depth);
+	};
+
+	if (IsSegmentClearOfOutline(getWorldPoint((float)nearDepth), getWorldPoint((float)farDepth), volume))
+	{
+		if (!IsPixelInZone(x, y, (short)((nearDepth + farDepth) / 2), intrinsics, volume))
+			return ZoneStatus::OutOfZone;
+
+		minDepth = (short)nearDepth;
+		maxDepth = (short)farDepth;
+
+		return ZoneStatus::InZone;
+	}
+
+	// otherwise the segment must cross the outline exactly once to be described by a single depth range
+	int crossingCount = 0;
+	float crossingDepth = 0;
+
+	const int pointCount = (int)volume.Points.size();
+	for (int i = 0; i < pointCount; i++)
+	{
+		const cv::Point& edgeStart = volume.Points[i];
+		const cv::Point& edgeEnd = volume.Points[(i + 1) % pointCount];
+		const float edgeX = (float)(edgeEnd.x - edgeStart.x);
+		const float edgeY = (float)(edgeEnd.y - edgeStart.y);
+
+		const float denominator = columnFactor * edgeY - rowFactor * edgeX;
+		if (denominator == 0)
+			continue;
+
+		const float depth = (edgeStart.x * edgeY - edgeStart.y * edgeX) / denominator;
+		const float edgeLengthSquared = edgeX * edgeX + edgeY * edgeY;
+		const float edgePosition = ((columnFactor * depth - edgeStart.x) * edgeX + (rowFactor * depth - edgeStart.y) * edgeY) / edgeLengthSquared;
+
+		const bool crossingIsInRange = depth >= nearDepth && depth <= farDepth && edgePosition >= 0 && edgePosition <= 1;
+		if (!crossingIsInRange)
+			continue;
+
+		crossingCount++;
+		crossingDepth = depth;
+	}
+
+	if (crossingCount != 1)
+		return ZoneStatus::ZoneBorder;
+
+	const int windowStart = std::max(nearDepth, (int)crossingDepth - ZoneCrossingSearchWindow);
+	const int windowEnd = std::min(farDepth, (int)crossingDepth + ZoneCrossingSearchWindow);
+
+	const bool nearPartIsClear = windowStart == nearDepth ||
+		IsSegmentClearOfOutline(getWorldPoint((float)nearDepth), getWorldPoint((float)windowStart), volume);
+	const bool farPartIsClear = windowEnd == farDepth ||
+		IsSegmentClearOfOutline(getWorldPoint((float)windowEnd), getWorldPoint((float)farDepth), volume);
+	if (!nearPartIsClear || !farPartIsClear)
+		return ZoneStatus::ZoneBorder;
+
+	// within the window the exact per-depth check decides where the pixel switches sides
+	const bool nearIsInZone = IsPixelInZone(x, y, (short)windowStart, intrinsics, volume);
+	int switchDepth = -1;
+	bool previousIsInZone = nearIsInZone;
+
+	for (int depth = windowStart + 1; depth <= windowEnd; depth++)
+	{
+		const bool isInZone = IsPixelInZone(x, y, (short)depth, intrinsics, volume);
+		if (isInZone == previousIsInZone)
+			continue;
+
+		if (switchDepth >= 0)
+			return ZoneStatus::ZoneBorder;
+
+		switchDepth = depth;
+		previousIsInZone = isInZone;
+	}
+
+	if (switchDepth < 0)
+	{
+		if (!nearIsInZone)
+			return ZoneStatus::OutOfZone;
+
+		minDepth = (short)nearDepth;
+		maxDepth = (short)farDepth;
+	}
+	else
+	{
+		minDepth = (short)(nearIsInZone ? nearDepth : switchDepth);
+		maxDepth = (short)(nearIsInZone ? switchDepth - 1 : farDepth);
+	}
+
+	return ZoneStatus::InZone;
+}
+
+const bool CalibrationUtils::IsSegmentClearOfOutline(const cv::Point2f& segmentStart, const cv::Point2f& segmentEnd,
+	const MeasurementVolume& volume)
+{
+	const int pointCount = (int)volume.Points.size();
+	for (int i = 0; i < pointCount; i++)
+	{
+		const cv::Point& startPoint = volume.Points[i];
+		const cv::Point& endPoint = volume.Points[(i + 1) % pointCount];
+		const cv::Point2f edgeStart((float)startPoint.x, (float)startPoint.y);
+		const cv::Point2f edgeEnd((float)endPoint.x, (float)endPoint.y);
+
+		if (SegmentsIntersect(segmentStart, segmentEnd, edgeStart, edgeEnd))
+			return false;
+
+		const bool segmentIsNearEdge = GetDistanceToSegment(segmentStart, edgeStart, edgeEnd) < ZoneBorderMarginMm ||
+			GetDistanceToSegment(segmentEnd, edgeStart, edgeEnd) < ZoneBorderMarginMm ||
+			GetDistanceToSegment(edgeStart, segmentStart, segmentEnd) < ZoneBorderMarginMm ||
+			GetDistanceToSegment(edgeEnd, segmentStart, segmentEnd) < ZoneBorderMarginMm;
+		if (segmentIsNearEdge)
+			return false;
+	}
+
+	return true;
+}
+
+const bool CalibrationUtils::IsPixelInZone(const int x, const int y, const short depth, const CameraIntrinsics& intrinsics,
+	const MeasurementVolume& volume)
+{
+	// same rounding as the per-frame exact check
+	DepthValue worldPoint;
+	worldPoint.Value = depth;
+	worldPoint.XWorld = (int)((x + 1 - intrinsics.PrincipalPointX) * depth / intrinsics.FocalLengthX);
+	worldPoint.YWorld = (int)(-(y + 1 - intrinsics.PrincipalPointY) * depth / intrinsics.FocalLengthY);
+
+	return DmUtils::IsPointInZone(worldPoint, volume);
+}
+
+const float CalibrationUtils::GetDistanceToSegment(const cv::Point2f& point, const cv::Point2f& a, const cv::Point2f& b)
+{
+	const float dx = b.x - a.x;
+	const float dy = b.y - a.y;
+	const float lengthSquared = dx * dx + dy * dy;
+
+	float t = lengthSquared > 0 ? ((point.x - a.x) * dx + (point.y - a.y) * dy) / lengthSquared : 0;
+	t = std::max(0.0f, std::min(1.0f, t));
+
+	const float closestX = a.x + t * dx;
+	const float closestY = a.y + t * dy;
+
+	return (float)sqrt(pow(point.x - closestX, 2) + pow(point.y - closestY, 2));
+}
+
+const bool CalibrationUtils::SegmentsIntersect(const cv::Point2f& a1, const cv::Point2f& a2, const cv::Point2f& b1,
+	const cv::Point2f& b2)
+{
+	const auto cross = [](const cv::Point2f& o, const cv::Point2f& p, const cv::Point2f& q)
+	{
+		return (p.x - o.x) * (q.y - o.y) - (p.y - o.y) * (q.x - o.x);
+	};
+
+	const float d1 = cross(b1, b2, a1);
+	const float d2 = cross(b1, b2, a2);
+	const float d3 = cross(a1, a2, b1);
+	const float d4 = cross(a1, a2, b2);
+
+	return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
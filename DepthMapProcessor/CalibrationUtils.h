@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "Structures.h"
+
+class CalibrationUtils
+{
+public:
+	static const unsigned long long GetCalibrationKey(const CalibrationSettings& settings);
+	static std::shared_ptr<const CalibrationState> LoadOrBuildCalibration(const CalibrationSettings& settings,
+		const std::string& cacheDirectory);
+	static std::shared_ptr<const CalibrationState> BuildCalibration(const CalibrationSettings& settings);
+	static std::shared_ptr<const CalibrationState> LoadCalibration(const std::string& filepath, const unsigned long long key);
+	static const bool SaveCalibration(const std::string& filepath, const CalibrationState& calibration);
+	static const std::string GetCalibrationFilePath(const std::string& cacheDirectory, const unsigned long long key);
+
+private:
+	static const MeasurementVolume GetMeasurementVolume(const CalibrationSettings& settings);
+	static const ZoneStatus GetPixelZoneRange(const int x, const int y, const float columnFactor, const float rowFactor,
+		const short cutOffDepth, const CameraIntrinsics& intrinsics, const MeasurementVolume& volume, short& minDepth, short& maxDepth);
+	static const bool IsSegmentClearOfOutline(const cv::Point2f& segmentStart, const cv::Point2f& segmentEnd,
+		const MeasurementVolume& volume);
+	static const bool IsPixelInZone(const int x, const int y, const short depth, const CameraIntrinsics& intrinsics,
+		const MeasurementVolume& volume);
+	static const float GetDistanceToSegment(const cv::Point2f& point, const cv::Point2f& a, const cv::Point2f& b);
+	static const bool SegmentsIntersect(const cv::Point2f& a1, const cv::Point2f& a2, const cv::Point2f& b1, const cv::Point2f& b2);
+};
@@ -0,0 +1,101 @@
+#include "ColorBackgroundModel.h"
+#include <algorithm>
+
+ColorBackgroundModel::ColorBackgroundModel()
+{
+	_sampleCount = 0;
+}
+
+void ColorBackgroundModel::Update(const cv::Mat& image)
+{
+	if (image.empty())
+		return;
+
+	if (!MatchesImage(image))
+	{
+		Reset();
+		_mean = cv::Mat::zeros(image.size(), CV_32FC(image.channels()));
+		_variance = cv::Mat(image.size(), CV_32FC1, cv::Scalar(_minVariance));
+	}
+
+	cv::Mat frame;
+	image.convertTo(frame, _mean.type());
+
+	if (_sampleCount == 0)
+	{
+		frame.copyTo(_mean);
+		_sampleCount++;
+		return;
+	}
+
+	cv::Mat distance;
+	GetSquaredDistance(frame, _mean, distance);
+
+	// once the model is usable, pixels covered by something are not learned, so an object left
+	// on the table for a while does not fade into the background
+	cv::Mat backgroundMask;
+	if (IsReady())
+	{
+		ThresholdDistance(distance, _variance, backgroundMask);
+		backgroundMask = ~backgroundMask;
+	}
+
+	const double learningRate = std::max(1.0 / (_sampleCount + 1), _minLearningRate);
+	cv::accumulateWeighted(frame, _mean, learningRate, backgroundMask);
+	cv::accumulateWeighted(distance, _variance, learningRate, backgroundMask);
+
+	_sampleCount++;
+}
+
+void ColorBackgroundModel::Reset()
+{
+	_mean.release();
+	_variance.release();
+	_sampleCount = 0;
+}
+
+const bool ColorBackgroundModel::IsReady() const
+{
+	return _sampleCount >= _minSampleCount;
+}
+
+const bool ColorBackgroundModel::MatchesImage(const cv::Mat& image) const
+{
+	return !_mean.empty() && _mean.size() == image.size() && _mean.channels() == image.channels();
+}
+
+void ColorBackgroundModel::GetForegroundMask(const cv::Mat& image, const cv::Rect& rect, cv::Mat& mask) const
+{
+	if (!IsReady() || !MatchesImage(image))
+	{
+		mask = cv::Mat::zeros(rect.size(), CV_8UC1);
+		return;
+	}
+
+	cv::Mat frame;
+	image(rect).convertTo(frame, _mean.type());
+
+	cv::Mat distance;
+	GetSquaredDistance(frame, _mean(rect), distance);
+	ThresholdDistance(distance, _variance(rect), mask);
+}
+
+void ColorBackgroundModel::GetSquaredDistance(const cv::Mat& frame, const cv::Mat& mean, cv::Mat& distance) const
+{
+	cv::Mat difference;
+	cv::subtract(frame, mean, difference);
+	cv::multiply(difference, difference, difference);
+
+	// sums the channels
+	const cv::Mat& channelWeights = cv::Mat::ones(1, difference.channels(), CV_32FC1);
+	cv::transform(difference, distance, channelWeights);
+}
+
+void ColorBackgroundModel::ThresholdDistance(const cv::Mat& distance, const cv::Mat& variance, cv::Mat& mask) const
+{
+	cv::Mat threshold;
+	cv::max(variance, _minVariance, threshold);
+	threshold *= _thresholdFactor;
+
+	cv::compare(distance, threshold, mask, cv::CMP_GT);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "OpenCVInclude.h"
+
+// running per-pixel mean color and variance of the empty work area
+class ColorBackgroundModel
+{
+private:
+	const int _minSampleCount = 10;
+	const double _minLearningRate = 0.02;
+	const float _thresholdFactor = 9.0f; // 3 standard deviations, squared
+	const float _minVariance = 100.0f; // keeps uniformly lit pixels from reacting to sensor noise
+
+	cv::Mat _mean;
+	cv::Mat _variance;
+	int _sampleCount;
+
+public:
+	ColorBackgroundModel();
+
+	void Update(const cv::Mat& image);
+	void Reset();
+	const bool IsReady() const;
+	const bool MatchesImage(const cv::Mat& image) const;
+
+	void GetForegroundMask(const cv::Mat& image, const cv::Rect& rect, cv::Mat& mask) const;
+
+private:
+	void GetSquaredDistance(const cv::Mat& frame, const cv::Mat& mean, cv::Mat& distance) const;
+	void ThresholdDistance(const cv::Mat& distance, const cv::Mat& variance, cv::Mat& mask) const;
+};
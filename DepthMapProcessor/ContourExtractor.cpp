@@ -1,26 +1,73 @@
 #include "ContourExtractor.h"
 #include "DmUtils.h"
+#include "TraceRecorder.h"
 
 ContourExtractor::ContourExtractor()
 {
 	_debugDirectory = "";
+	_debugImageWriter = nullptr;
 }
 
-const Contour ContourExtractor::ExtractContourFromBinaryImage(const cv::Mat& image) const
+const ContourGeometry ContourExtractor::ExtractContourFromBinaryImage(const cv::Mat& image) const
 {
+	TRACE_SCOPE("ContourExtractor::ExtractContourFromBinaryImage");
+
 	std::vector<Contour> contours;
 	cv::findContours(image, contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
 
-	const std::vector<Contour>& validContours = DmUtils::GetValidContours(contours, 0.0001f, image.cols * image.rows);
+	const std::vector<ContourGeometry>& validContours = DmUtils::GetValidContours(contours, 0.0001f, image.cols * image.rows);
 
 	if (validContours.size() == 0)
-		return Contour();
+		return ContourGeometry();
+
+	return GetContourClosestToPoint(validContours, cv::Point(image.cols / 2, image.rows / 2));
+}
+
+const ContourGeometry ContourExtractor::ExtractContourFromBinaryImageRegion(const cv::Mat& image, const cv::Rect& region) const
+{
+	TRACE_SCOPE("ContourExtractor::ExtractContourFromBinaryImageRegion");
 
-	return GetContourClosestToCenter(validContours, image.cols, image.rows);
+	std::vector<Contour> contours;
+	cv::Mat regionImage = image(region);
+	cv::findContours(regionImage, contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE, region.tl());
+
+	// contours are validated against the whole image, as they would be without the region
+	const std::vector<ContourGeometry>& validContours = DmUtils::GetValidContours(contours, 0.0001f, image.cols * image.rows);
+
+	if (validContours.size() == 0)
+		return ContourGeometry();
+
+	return GetContourClosestToPoint(validContours, cv::Point(region.x + region.width / 2, region.y + region.height / 2));
+}
+
+const std::vector<ContourGeometry> ContourExtractor::ExtractContoursFromBinaryImage(const cv::Mat& image) const
+{
+	TRACE_SCOPE("ContourExtractor::ExtractContoursFromBinaryImage");
+
+	std::vector<Contour> contours;
+	cv::findContours(image, contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
+
+	std::vector<ContourGeometry> validContours = DmUtils::GetValidContours(contours, 0.0001f, image.cols * image.rows);
+
+	std::vector<int> order(validContours.size());
+	for (int i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(),
+		[&validContours](const int a, const int b) { return validContours[a].GetArea() > validContours[b].GetArea(); });
+
+	// largest first
+	std::vector<ContourGeometry> sortedContours;
+	sortedContours.reserve(validContours.size());
+	for (int i = 0; i < order.size(); i++)
+		sortedContours.emplace_back(std::move(validContours[order[i]]));
+
+	return sortedContours;
 }
 
 const Contour ContourExtractor::ExtractContourFromColorImage(const cv::Mat& image, const char* debugPath) const
 {
+	TRACE_SCOPE("ContourExtractor::ExtractContourFromColorImage");
+
 	const bool imageIsValid = image.cols > 0 && image.rows > 0 && image.data != nullptr;
 	if (!imageIsValid)
 		return Contour();
@@ -40,10 +87,45 @@ const Contour ContourExtractor::ExtractContourFromColorImage(const cv::Mat& imag
 			mergedContour.emplace_back(contours[i][j]);
 	}
 
-	if (_debugDirectory != "" && debugPath != "")
+	if (_debugDirectory != "" && debugPath != "" && _debugImageWriter != nullptr)
 	{
 		const std::string& path = std::string(debugPath);
-		cv::imwrite(_debugDirectory + "/" + path + ".png", cannied);
+		_debugImageWriter->EnqueueImage(cannied, _debugDirectory + "/" + path + ".png");
+	}
+
+	return mergedContour;
+}
+
+const Contour ContourExtractor::ExtractContourFromForegroundMask(const cv::Mat& mask, const char* debugPath) const
+{
+	TRACE_SCOPE("ContourExtractor::ExtractContourFromForegroundMask");
+
+	const bool maskIsValid = mask.cols > 0 && mask.rows > 0 && mask.data != nullptr;
+	if (!maskIsValid)
+		return Contour();
+
+	cv::Mat cleanMask;
+	const cv::Mat& kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+	cv::morphologyEx(mask, cleanMask, cv::MORPH_OPEN, kernel);
+
+	if (_debugDirectory != "" && debugPath != "" && _debugImageWriter != nullptr)
+	{
+		const std::string& path = std::string(debugPath);
+		_debugImageWriter->EnqueueImage(cleanMask, _debugDirectory + "/" + path + ".png");
+	}
+
+	std::vector<Contour> contours;
+	cv::findContours(cleanMask, contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
+
+	// an object may split into several blobs where it matches the table color, so all of them are kept
+	const std::vector<ContourGeometry>& validContours = DmUtils::GetValidContours(contours, _minForegroundBlobAreaRatio,
+		mask.cols * mask.rows);
+
+	Contour mergedContour;
+	for (int i = 0; i < validContours.size(); i++)
+	{
+		const Contour& contour = validContours[i].GetContour();
+		mergedContour.insert(mergedContour.end(), contour.begin(), contour.end());
 	}
 
 	return mergedContour;
@@ -54,33 +136,39 @@ void ContourExtractor::SetDebugDirectory(const std::string& path)
 	_debugDirectory = path;
 }
 
-const Contour ContourExtractor::GetContourClosestToCenter(const std::vector<Contour>& contours, const int width, const int height) const
+void ContourExtractor::SetDebugImageWriter(DebugImageWriter* writer)
+{
+	_debugImageWriter = writer;
+}
+
+const ContourGeometry ContourExtractor::GetContourClosestToPoint(const std::vector<ContourGeometry>& contours,
+	const cv::Point& point) const
 {
 	if (contours.size() == 0)
-		return Contour();
+		return ContourGeometry();
 
 	if (contours.size() == 1)
 		return contours[0];
 
-	const int centerX = width / 2;
-	const int centerY = height / 2;
+	const int centerX = point.x;
+	const int centerY = point.y;
 
 	float resultDistanceToCenter = (float)INT32_MAX;
-	Contour closestToCenterContour;
+	int closestToCenterIndex = 0;
 
 	for (uint i = 0; i < contours.size(); i++)
 	{
-		const cv::Moments& m = cv::moments(contours[i]);
-		const int cx = (int)(m.m10 / m.m00);
-		const int cy = (int)(m.m01 / m.m00);
+		const cv::Point2f& center = contours[i].GetCenter();
+		const int cx = (int)center.x;
+		const int cy = (int)center.y;
 		const float distanceToCenter = DmUtils::GetDistanceBetweenPoints(centerX, centerY, cx, cy);
 
 		if (distanceToCenter >= resultDistanceToCenter)
 			continue;
 
 		resultDistanceToCenter = distanceToCenter;
-		closestToCenterContour = contours[i];
+		closestToCenterIndex = i;
 	}
 
-	return closestToCenterContour;
+	return contours[closestToCenterIndex];
 }
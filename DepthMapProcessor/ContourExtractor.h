@@ -2,21 +2,29 @@
 
 #include "Structures.h"
 #include "OpenCVInclude.h"
+#include "DebugImageWriter.h"
+#include "ContourGeometry.h"
 
 class ContourExtractor
 {
 private:
 	const int _cannyThreshold1 = 50;
 	const int _cannyThreshold2 = 200;
+	const float _minForegroundBlobAreaRatio = 0.001f; // smaller blobs are noise or compression artifacts
 	std::string _debugDirectory;
+	DebugImageWriter* _debugImageWriter;
 
 public:
 	ContourExtractor();
 
-	const Contour ExtractContourFromBinaryImage(const cv::Mat& image) const;
+	const ContourGeometry ExtractContourFromBinaryImage(const cv::Mat& image) const;
+	const ContourGeometry ExtractContourFromBinaryImageRegion(const cv::Mat& image, const cv::Rect& region) const;
+	const std::vector<ContourGeometry> ExtractContoursFromBinaryImage(const cv::Mat& image) const;
 	const Contour ExtractContourFromColorImage(const cv::Mat& image, const char* debugPath = "") const;
+	const Contour ExtractContourFromForegroundMask(const cv::Mat& mask, const char* debugPath = "") const;
 	void SetDebugDirectory(const std::string& path);
+	void SetDebugImageWriter(DebugImageWriter* writer);
 
 private:
-	const Contour GetContourClosestToCenter(const std::vector<Contour>& contours, const int width, const int height) const;
+	const ContourGeometry GetContourClosestToPoint(const std::vector<ContourGeometry>& contours, const cv::Point& point) const;
 };
\ No newline at end of file
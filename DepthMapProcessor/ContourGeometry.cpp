@@ -0,0 +1,113 @@
+#include "ContourGeometry.h"
+
+ContourGeometry::ContourGeometry()
+{
+	ResetProperties();
+}
+
+ContourGeometry::ContourGeometry(Contour contour)
+	: _contour(std::move(contour))
+{
+	ResetProperties();
+}
+
+ContourGeometry::ContourGeometry(Contour contour, const double area)
+	: _contour(std::move(contour))
+{
+	ResetProperties();
+
+	_area = area;
+	_hasArea = true;
+}
+
+const Contour& ContourGeometry::GetContour() const
+{
+	return _contour;
+}
+
+const bool ContourGeometry::IsEmpty() const
+{
+	return _contour.empty();
+}
+
+const double ContourGeometry::GetArea() const
+{
+	if (!_hasArea)
+	{
+		_area = !_contour.empty() ? cv::contourArea(_contour) : 0;
+		_hasArea = true;
+	}
+
+	return _area;
+}
+
+const cv::Moments& ContourGeometry::GetMoments() const
+{
+	if (!_hasMoments)
+	{
+		_moments = !_contour.empty() ? cv::moments(_contour) : cv::Moments();
+		_hasMoments = true;
+	}
+
+	return _moments;
+}
+
+const cv::Point2f ContourGeometry::GetCenter() const
+{
+	const cv::Moments& moments = GetMoments();
+	if (moments.m00 > 0)
+		return cv::Point2f((float)(moments.m10 / moments.m00), (float)(moments.m01 / moments.m00));
+
+	const cv::Rect& boundingRect = GetBoundingRect();
+
+	return cv::Point2f(boundingRect.x + boundingRect.width / 2.0f, boundingRect.y + boundingRect.height / 2.0f);
+}
+
+const Contour& ContourGeometry::GetHull() const
+{
+	if (!_hasHull)
+	{
+		_hull.clear();
+		if (!_contour.empty())
+			cv::convexHull(_contour, _hull);
+		_hasHull = true;
+	}
+
+	return _hull;
+}
+
+const cv::RotatedRect& ContourGeometry::GetMinAreaRect() const
+{
+	// the rect of the hull is the rect of the contour
+	if (!_hasMinAreaRect)
+	{
+		_minAreaRect = !_contour.empty() ? cv::minAreaRect(GetHull()) : cv::RotatedRect();
+		_hasMinAreaRect = true;
+	}
+
+	return _minAreaRect;
+}
+
+const cv::Rect& ContourGeometry::GetBoundingRect() const
+{
+	if (!_hasBoundingRect)
+	{
+		_boundingRect = !_contour.empty() ? cv::boundingRect(_contour) : cv::Rect();
+		_hasBoundingRect = true;
+	}
+
+	return _boundingRect;
+}
+
+void ContourGeometry::ResetProperties()
+{
+	_hasArea = false;
+	_area = 0;
+	_hasMoments = false;
+	_moments = cv::Moments();
+	_hasHull = false;
+	_hasMinAreaRect = false;
+	_minAreaRect = cv::RotatedRect();
+	_hasBoundingRect = false;
+	_boundingRect = cv::Rect();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// an immutable contour whose measured properties are computed once, when they are first asked for
+class ContourGeometry
+{
+private:
+	Contour _contour;
+
+	// computed on demand, they do not change what the object describes
+	mutable bool _hasArea;
+	mutable double _area;
+	mutable bool _hasMoments;
+	mutable cv::Moments _moments;
+	mutable bool _hasHull;
+	mutable Contour _hull;
+	mutable bool _hasMinAreaRect;
+	mutable cv::RotatedRect _minAreaRect;
+	mutable bool _hasBoundingRect;
+	mutable cv::Rect _boundingRect;
+
+public:
+	ContourGeometry();
+	explicit ContourGeometry(Contour contour);
+	// for a contour whose area is already known
+	ContourGeometry(Contour contour, const double area);
+
+	const Contour& GetContour() const;
+	const bool IsEmpty() const;
+
+	const double GetArea() const;
+	const cv::Moments& GetMoments() const;
+	// the centroid, or the bounding rect's center for a contour without area
+	const cv::Point2f GetCenter() const;
+	const Contour& GetHull() const;
+	const cv::RotatedRect& GetMinAreaRect() const;
+	const cv::Rect& GetBoundingRect() const;
+
+private:
+	void ResetProperties();
+};
@@ -0,0 +1,123 @@
+#include "DebugImageWriter.h"
+#include "DmUtils.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+DebugImageWriter::DebugImageWriter()
+{
+	_queuedBytes = 0;
+	_isStopping = false;
+
+	_workerThread = std::thread(&DebugImageWriter::ProcessJobs, this);
+
+#ifdef _WIN32
+	SetThreadPriority(_workerThread.native_handle(), THREAD_PRIORITY_LOWEST);
+#endif
+}
+
+DebugImageWriter::~DebugImageWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+
+	// pending jobs are still written so that the last measurements keep their debug data
+	_jobsAvailable.notify_one();
+	_workerThread.join();
+}
+
+void DebugImageWriter::EnqueueContour(const Contour& contour, const int width, const int height, const std::string& filename)
+{
+	std::unique_ptr<DebugImageJob> job = AcquireJob();
+	job->IsContourJob = true;
+	job->Filename = filename;
+	job->ObjectContour.assign(contour.begin(), contour.end());
+	job->Width = width;
+	job->Height = height;
+	job->ByteSize = contour.size() * sizeof(cv::Point);
+
+	Enqueue(std::move(job));
+}
+
+void DebugImageWriter::EnqueueImage(const cv::Mat& image, const std::string& filename)
+{
+	std::unique_ptr<DebugImageJob> job = AcquireJob();
+	job->IsContourJob = false;
+	job->Filename = filename;
+	image.copyTo(job->Image);
+	job->ByteSize = image.total() * image.elemSize();
+
+	Enqueue(std::move(job));
+}
+
+std::unique_ptr<DebugImageWriter::DebugImageJob> DebugImageWriter::AcquireJob()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_freeJobs.empty())
+		return std::unique_ptr<DebugImageJob>(new DebugImageJob());
+
+	std::unique_ptr<DebugImageJob> job = std::move(_freeJobs.back());
+	_freeJobs.pop_back();
+
+	return job;
+}
+
+void DebugImageWriter::Enqueue(std::unique_ptr<DebugImageJob> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_queuedBytes += job->ByteSize;
+		_queuedJobs.emplace_back(std::move(job));
+
+		while (_queuedJobs.size() > 1 && (_queuedJobs.size() > _maxQueuedJobCount || _queuedBytes > _maxQueuedBytes))
+		{
+			_queuedBytes -= _queuedJobs.front()->ByteSize;
+			_freeJobs.emplace_back(std::move(_queuedJobs.front()));
+			_queuedJobs.pop_front();
+		}
+	}
+
+	_jobsAvailable.notify_one();
+}
+
+void DebugImageWriter::ProcessJobs()
+{
+	while (true)
+	{
+		std::unique_ptr<DebugImageJob> job;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobsAvailable.wait(lock, [this]() { return _isStopping || !_queuedJobs.empty(); });
+			if (_queuedJobs.empty())
+				return;
+
+			job = std::move(_queuedJobs.front());
+			_queuedJobs.pop_front();
+			_queuedBytes -= job->ByteSize;
+		}
+
+		try
+		{
+			if (job->IsContourJob)
+				DmUtils::DrawTargetContour(job->ObjectContour, job->Width, job->Height, job->Filename);
+			else
+				cv::imwrite(job->Filename, job->Image);
+		}
+		catch (...)
+		{
+			// a failed debug write must not take the worker down
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_freeJobs.size() < _maxQueuedJobCount)
+			_freeJobs.emplace_back(std::move(job));
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// Writes debug images on a low priority background thread.
+// The caller only copies the data to draw into a pooled job; once the queue exceeds its job count or byte budget,
+// the oldest pending jobs are dropped, so debug output never holds up a measurement.
+class DebugImageWriter
+{
+private:
+	struct DebugImageJob
+	{
+		bool IsContourJob;
+		std::string Filename;
+		Contour ObjectContour;
+		int Width;
+		int Height;
+		cv::Mat Image;
+		size_t ByteSize;
+	};
+
+	const size_t _maxQueuedJobCount = 32;
+	const size_t _maxQueuedBytes = 64 * 1024 * 1024;
+
+	std::mutex _mutex;
+	std::condition_variable _jobsAvailable;
+	std::deque<std::unique_ptr<DebugImageJob>> _queuedJobs;
+	std::vector<std::unique_ptr<DebugImageJob>> _freeJobs;
+	size_t _queuedBytes;
+	bool _isStopping;
+	std::thread _workerThread;
+
+public:
+	DebugImageWriter();
+	~DebugImageWriter();
+
+	void EnqueueContour(const Contour& contour, const int width, const int height, const std::string& filename);
+	void EnqueueImage(const cv::Mat& image, const std::string& filename);
+
+private:
+	std::unique_ptr<DebugImageJob> AcquireJob();
+	void Enqueue(std::unique_ptr<DebugImageJob> job);
+	void ProcessJobs();
+};
@@ -0,0 +1,78 @@
+#include "DepthColorRegistration.h"
+#include <cfloat>
+#include <cmath>
+
+DepthColorRegistration::DepthColorRegistration(const CameraIntrinsics& depthIntrinsics, const CameraIntrinsics& colorIntrinsics)
+	: _depthIntrinsics(depthIntrinsics), _colorIntrinsics(colorIntrinsics)
+{
+	// the cameras are considered coincident until the real transform is provided
+	_depthToColor = Extrinsics{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0 } };
+}
+
+void DepthColorRegistration::SetExtrinsics(const Extrinsics& depthToColor)
+{
+	_depthToColor = depthToColor;
+}
+
+const cv::Rect DepthColorRegistration::MapDepthRectToColor(const cv::Rect& depthRect, const short nearDepth, const short farDepth,
+	const cv::Size& colorImageSize) const
+{
+	const bool dataIsValid = depthRect.width > 0 && depthRect.height > 0 && nearDepth > 0 && farDepth >= nearDepth;
+	if (!dataIsValid)
+		return cv::Rect();
+
+	// a pixel's projection moves monotonically between its projections at the nearest and the farthest depth,
+	// so the corners at both depths bound the object wherever it is within the range
+	const float cornersX[2] = { (float)depthRect.x, (float)(depthRect.x + depthRect.width) };
+	const float cornersY[2] = { (float)depthRect.y, (float)(depthRect.y + depthRect.height) };
+	const short depths[2] = { nearDepth, farDepth };
+
+	float minX = FLT_MAX;
+	float minY = FLT_MAX;
+	float maxX = -FLT_MAX;
+	float maxY = -FLT_MAX;
+
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			for (int k = 0; k < 2; k++)
+			{
+				const cv::Point2f& colorPoint = ProjectDepthPixel(cornersX[i], cornersY[j], depths[k]);
+				minX = std::min(minX, colorPoint.x);
+				minY = std::min(minY, colorPoint.y);
+				maxX = std::max(maxX, colorPoint.x);
+				maxY = std::max(maxY, colorPoint.y);
+			}
+		}
+	}
+
+	const int x1 = std::max((int)std::floor(minX), 0);
+	const int y1 = std::max((int)std::floor(minY), 0);
+	const int x2 = std::min((int)std::ceil(maxX), colorImageSize.width);
+	const int y2 = std::min((int)std::ceil(maxY), colorImageSize.height);
+	if (x2 <= x1 || y2 <= y1)
+		return cv::Rect();
+
+	return cv::Rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+const cv::Point2f DepthColorRegistration::ProjectDepthPixel(const float x, const float y, const short depth) const
+{
+	const float depthX = (x - _depthIntrinsics.PrincipalPointX) * depth / _depthIntrinsics.FocalLengthX;
+	const float depthY = (y - _depthIntrinsics.PrincipalPointY) * depth / _depthIntrinsics.FocalLengthY;
+	const float depthZ = depth;
+
+	const float* r = _depthToColor.Rotation;
+	const float* t = _depthToColor.Translation;
+	const float colorX = r[0] * depthX + r[3] * depthY + r[6] * depthZ + t[0];
+	const float colorY = r[1] * depthX + r[4] * depthY + r[7] * depthZ + t[1];
+	const float colorZ = r[2] * depthX + r[5] * depthY + r[8] * depthZ + t[2];
+	if (colorZ <= 0)
+		return cv::Point2f(0, 0);
+
+	const float u = colorX * _colorIntrinsics.FocalLengthX / colorZ + _colorIntrinsics.PrincipalPointX;
+	const float v = colorY * _colorIntrinsics.FocalLengthY / colorZ + _colorIntrinsics.PrincipalPointY;
+
+	return cv::Point2f(u, v);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// Maps regions of the depth map into the color image using both cameras' intrinsics and the depth-to-color extrinsics.
+class DepthColorRegistration
+{
+private:
+	const CameraIntrinsics _depthIntrinsics;
+	const CameraIntrinsics _colorIntrinsics;
+	Extrinsics _depthToColor;
+
+public:
+	DepthColorRegistration(const CameraIntrinsics& depthIntrinsics, const CameraIntrinsics& colorIntrinsics);
+
+	void SetExtrinsics(const Extrinsics& depthToColor);
+
+	const cv::Rect MapDepthRectToColor(const cv::Rect& depthRect, const short nearDepth, const short farDepth,
+		const cv::Size& colorImageSize) const;
+
+private:
+	const cv::Point2f ProjectDepthPixel(const float x, const float y, const short depth) const;
+};
@@ -0,0 +1,85 @@
+#include "DepthDenoiser.h"
+#include <cstdlib>
+#include <cstring>
+#include "TraceRecorder.h"
+
+void DepthDenoiser::Apply(short*const mapData, const int mapWidth, const cv::Rect& region)
+{
+	TRACE_SCOPE("DepthDenoiser::Apply");
+
+	if (mapData == nullptr || region.area() == 0)
+		return;
+
+	// rows are padded with an empty pixel on both sides, pixels outside of the region count as missing
+	const int paddedWidth = region.width + 2;
+	const int rowLengthBytes = region.width * sizeof(short);
+	_rowBuffer.assign(paddedWidth * 3, 0);
+
+	short* rows[3] = { _rowBuffer.data(), _rowBuffer.data() + paddedWidth, _rowBuffer.data() + 2 * paddedWidth };
+	memcpy(rows[1] + 1, mapData + region.y * mapWidth + region.x, rowLengthBytes);
+
+	for (int j = 0; j < region.height; j++)
+	{
+		if (j + 1 < region.height)
+			memcpy(rows[2] + 1, mapData + (region.y + j + 1) * mapWidth + region.x, rowLengthBytes);
+		else
+			memset(rows[2], 0, paddedWidth * sizeof(short));
+
+		short*const outputRow = mapData + (region.y + j) * mapWidth + region.x;
+		for (int i = 0; i < region.width; i++)
+			outputRow[i] = GetDenoisedDepth(rows, i + 1);
+
+		short*const previousRow = rows[0];
+		rows[0] = rows[1];
+		rows[1] = rows[2];
+		rows[2] = previousRow;
+	}
+}
+
+const short DepthDenoiser::GetDenoisedDepth(short*const rows[3], const int x) const
+{
+	const short depth = rows[1][x];
+
+	short neighbours[8];
+	int neighbourCount = 0;
+	int supportingNeighbourCount = 0;
+
+	for (int dy = 0; dy < 3; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			const short neighbour = rows[dy][x + dx];
+			const bool isCenter = dy == 1 && dx == 0;
+			if (isCenter || neighbour <= 0)
+				continue;
+
+			neighbours[neighbourCount++] = neighbour;
+			if (std::abs(neighbour - depth) <= _supportingDepthDeltaMm)
+				supportingNeighbourCount++;
+		}
+	}
+
+	const bool depthIsValid = depth > 0;
+	if (depthIsValid && supportingNeighbourCount >= _minSupportingNeighbourCount)
+		return depth;
+
+	// holes and speckle take the depth of the neighbourhood when there is enough of it, speckle is dropped otherwise
+	if (neighbourCount >= _minHoleNeighbourCount)
+		return GetMedian(neighbours, neighbourCount);
+
+	return depthIsValid ? 0 : depth;
+}
+
+const short DepthDenoiser::GetMedian(short*const values, const int count)
+{
+	for (int i = 1; i < count; i++)
+	{
+		const short value = values[i];
+		int j = i - 1;
+		for (; j >= 0 && values[j] > value; j--)
+			values[j + 1] = values[j];
+		values[j + 1] = value;
+	}
+
+	return values[count / 2];
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// removes speckle and fills small holes in place, every pixel is judged by its original 3x3 neighbourhood
+class DepthDenoiser
+{
+private:
+	const short _supportingDepthDeltaMm = 30; // a neighbour this close in depth supports the pixel
+	const int _minSupportingNeighbourCount = 2; // a pixel with fewer supporting neighbours is speckle
+	const int _minHoleNeighbourCount = 5; // a pixel is filled only from this many valid neighbours
+
+	std::vector<short> _rowBuffer;
+
+public:
+	void Apply(short*const mapData, const int mapWidth, const cv::Rect& region);
+
+private:
+	const short GetDenoisedDepth(short*const rows[3], const int x) const;
+	static const short GetMedian(short*const values, const int count);
+};
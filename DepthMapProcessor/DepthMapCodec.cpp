@@ -0,0 +1,246 @@
+#include "DepthMapCodec.h"
+#include <cstring>
+
+// token layout (first byte):
+// 0zzzzzzz                   - residual, zigzag value below 128
+// 10rrrrrr                   - run of 1..64 zero pixels
+// 110rrrrr rrrrrrrr          - run of 1..8192 zero pixels
+// 1110zzzz zzzzzzzz          - residual, zigzag value below 4096
+// 11110000 llllllll hhhhhhhh - raw pixel value
+
+const byte CodecMagic[4] = { 'D', 'M', 'Z', '1' };
+const int MaxShortRunLength = 64;
+const int MaxLongRunLength = 8192;
+const int MaxBytesPerPixel = 3;
+
+namespace
+{
+	inline uint ZigZagEncode(const int value)
+	{
+		return (uint)((value << 1) ^ (value >> 31));
+	}
+
+	inline int ZigZagDecode(const uint value)
+	{
+		return (int)(value >> 1) ^ -(int)(value & 1);
+	}
+}
+
+DepthMapEncoder::DepthMapEncoder(const int width, const int height)
+	: _width(width), _height(height)
+{
+	Reset();
+}
+
+const int DepthMapEncoder::GetMaxEncodedLength(const int width, const int height)
+{
+	return DepthMapCodecHeaderLength + GetMaxEncodedRowsLength(width, height);
+}
+
+const int DepthMapEncoder::GetMaxEncodedRowsLength(const int width, const int rowCount)
+{
+	return width * rowCount * MaxBytesPerPixel;
+}
+
+const int DepthMapEncoder::WriteHeader(const int width, const int height, byte*const output, const int outputCapacity)
+{
+	if (outputCapacity < DepthMapCodecHeaderLength)
+		return -1;
+
+	memcpy(output, CodecMagic, sizeof(CodecMagic));
+	memcpy(output + 4, &width, sizeof(int));
+	memcpy(output + 8, &height, sizeof(int));
+
+	return DepthMapCodecHeaderLength;
+}
+
+const int DepthMapEncoder::EncodeRows(const short*const rows, const int rowCount, byte*const output, const int outputCapacity)
+{
+	if (rowCount <= 0 || _rowsEncoded + rowCount > _height)
+		return -1;
+
+	if (outputCapacity < GetMaxEncodedRowsLength(_width, rowCount))
+		return -1;
+
+	byte* outputPointer = output;
+	short predictor = _predictor;
+
+	for (int j = 0; j < rowCount; j++)
+	{
+		const short* row = rows + j * _width;
+		int zeroRunLength = 0;
+
+		for (int i = 0; i < _width; i++)
+		{
+			const short value = row[i];
+			if (value == 0)
+			{
+				zeroRunLength++;
+				continue;
+			}
+
+			if (zeroRunLength > 0)
+			{
+				outputPointer = WriteZeroRun(zeroRunLength, outputPointer);
+				zeroRunLength = 0;
+			}
+
+			const uint residual = ZigZagEncode(value - predictor);
+			if (residual < 0x80)
+			{
+				*outputPointer++ = (byte)residual;
+			}
+			else if (residual < 0x1000)
+			{
+				*outputPointer++ = (byte)(0xE0 | (residual >> 8));
+				*outputPointer++ = (byte)(residual & 0xFF);
+			}
+			else
+			{
+				*outputPointer++ = 0xF0;
+				*outputPointer++ = (byte)(value & 0xFF);
+				*outputPointer++ = (byte)((value >> 8) & 0xFF);
+			}
+
+			predictor = value;
+		}
+
+		if (zeroRunLength > 0)
+			outputPointer = WriteZeroRun(zeroRunLength, outputPointer);
+	}
+
+	_predictor = predictor;
+	_rowsEncoded += rowCount;
+
+	return (int)(outputPointer - output);
+}
+
+void DepthMapEncoder::Reset()
+{
+	_rowsEncoded = 0;
+	_predictor = 0;
+}
+
+byte* DepthMapEncoder::WriteZeroRun(int runLength, byte* output) const
+{
+	while (runLength > 0)
+	{
+		if (runLength <= MaxShortRunLength)
+		{
+			*output++ = (byte)(0x80 | (runLength - 1));
+			return output;
+		}
+
+		const int tokenLength = runLength < MaxLongRunLength ? runLength : MaxLongRunLength;
+		const int storedLength = tokenLength - 1;
+		*output++ = (byte)(0xC0 | (storedLength >> 8));
+		*output++ = (byte)(storedLength & 0xFF);
+		runLength -= tokenLength;
+	}
+
+	return output;
+}
+
+DepthMapDecoder::DepthMapDecoder(const int width, const int height)
+	: _width(width), _height(height)
+{
+	Reset();
+}
+
+const int DepthMapDecoder::ReadHeader(const byte*const input, const int inputLength, int& width, int& height)
+{
+	if (input == nullptr || inputLength < DepthMapCodecHeaderLength)
+		return -1;
+
+	if (memcmp(input, CodecMagic, sizeof(CodecMagic)) != 0)
+		return -1;
+
+	memcpy(&width, input + 4, sizeof(int));
+	memcpy(&height, input + 8, sizeof(int));
+
+	const bool dimsAreValid = width > 0 && height > 0;
+
+	return dimsAreValid ? DepthMapCodecHeaderLength : -1;
+}
+
+const int DepthMapDecoder::DecodeRows(const byte*const input, const int inputLength, short*const rows, const int rowCount)
+{
+	if (rowCount <= 0 || _rowsDecoded + rowCount > _height)
+		return -1;
+
+	const byte* inputPointer = input;
+	const byte*const inputEnd = input + inputLength;
+	short predictor = _predictor;
+
+	for (int j = 0; j < rowCount; j++)
+	{
+		short* row = rows + j * _width;
+		int i = 0;
+
+		while (i < _width)
+		{
+			if (inputPointer >= inputEnd)
+				return -1;
+
+			const byte token = *inputPointer++;
+
+			if ((token & 0x80) == 0)
+			{
+				predictor = (short)(predictor + ZigZagDecode(token));
+				row[i++] = predictor;
+				continue;
+			}
+
+			if ((token & 0xC0) == 0x80)
+			{
+				const int runLength = (token & 0x3F) + 1;
+				if (i + runLength > _width)
+					return -1;
+
+				memset(row + i, 0, runLength * sizeof(short));
+				i += runLength;
+				continue;
+			}
+
+			if (inputPointer >= inputEnd)
+				return -1;
+
+			if ((token & 0xE0) == 0xC0)
+			{
+				const int runLength = (((token & 0x1F) << 8) | *inputPointer++) + 1;
+				if (i + runLength > _width)
+					return -1;
+
+				memset(row + i, 0, runLength * sizeof(short));
+				i += runLength;
+				continue;
+			}
+
+			if ((token & 0xF0) == 0xE0)
+			{
+				const uint residual = ((token & 0x0F) << 8) | *inputPointer++;
+				predictor = (short)(predictor + ZigZagDecode(residual));
+				row[i++] = predictor;
+				continue;
+			}
+
+			if (token != 0xF0 || inputEnd - inputPointer < 2)
+				return -1;
+
+			predictor = (short)(inputPointer[0] | (inputPointer[1] << 8));
+			inputPointer += 2;
+			row[i++] = predictor;
+		}
+	}
+
+	_predictor = predictor;
+	_rowsDecoded += rowCount;
+
+	return (int)(inputPointer - input);
+}
+
+void DepthMapDecoder::Reset()
+{
+	_rowsDecoded = 0;
+	_predictor = 0;
+}
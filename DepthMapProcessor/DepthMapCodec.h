@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Structures.h"
+
+// lossless codec for 16-bit depth maps, rows are encoded independently of each other
+
+const int DepthMapCodecHeaderLength = 12;
+
+class DepthMapEncoder
+{
+private:
+	const int _width;
+	const int _height;
+	int _rowsEncoded;
+	short _predictor;
+
+public:
+	DepthMapEncoder(const int width, const int height);
+
+	static const int GetMaxEncodedLength(const int width, const int height);
+	static const int GetMaxEncodedRowsLength(const int width, const int rowCount);
+	static const int WriteHeader(const int width, const int height, byte*const output, const int outputCapacity);
+
+	const int EncodeRows(const short*const rows, const int rowCount, byte*const output, const int outputCapacity);
+	void Reset();
+
+private:
+	byte* WriteZeroRun(int runLength, byte* output) const;
+};
+
+class DepthMapDecoder
+{
+private:
+	const int _width;
+	const int _height;
+	int _rowsDecoded;
+	short _predictor;
+
+public:
+	DepthMapDecoder(const int width, const int height);
+
+	static const int ReadHeader(const byte*const input, const int inputLength, int& width, int& height);
+
+	const int DecodeRows(const byte*const input, const int inputLength, short*const rows, const int rowCount);
+	void Reset();
+};
@@ -4,12 +4,18 @@
 #include <climits>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
+#include <chrono>
 #include "DmUtils.h"
 #include <fstream>
 #include "CalculationUtils.h"
+#include "CalibrationUtils.h"
+#include "FloorPlaneEstimator.h"
+#include "BoxFitter.h"
+#include "TraceRecorder.h"
 
 DepthMapProcessor::DepthMapProcessor(CameraIntrinsics colorIntrinsics, CameraIntrinsics depthIntrinsics)
-	: _colorIntrinsics(colorIntrinsics), _depthIntrinsics(depthIntrinsics)
+	: _colorIntrinsics(colorIntrinsics), _depthIntrinsics(depthIntrinsics), _depthColorRegistration(depthIntrinsics, colorIntrinsics)
 {
 	_mapWidth = 0;
 	_mapHeight = 0;
@@ -18,29 +24,48 @@ DepthMapProcessor::DepthMapProcessor(CameraIntrinsics colorIntrinsics, CameraInt
 
 	_colorImageWidth = 0;
 	_colorImageHeight = 0;
-	_colorImageLengthBytes = 0;
 	_colorImageBytesPerPixel = 0;
+	_colorImageCvType = 0;
 
 	_colorRoiRect = RelRect();
 	_floorDepth = 0;
 	_cutOffDepth = 0;
 	_correctPerspective = false;
+	_colorSegmentationMode = ColorSegmentationMode::Canny;
+	_denoiseDepth = false;
 
 	_depthMapBuffer = nullptr;
 	_depthMaskBuffer = nullptr;
-	_colorImageBuffer = nullptr;
-	_worldDepthValuesBuffer = nullptr;
+	_colorImageData = nullptr;
+
+	_depthDecimationFactor = 1;
+	_depthDecimationFilter = DepthDecimationFilter::Min;
+	_decimatedMapWidth = 0;
+	_decimatedMapHeight = 0;
+	_depthRefinementRect = cv::Rect();
 
 	_sortedNonZeroMapValuesCount = 0;
 	_sortedNonZeroMapValuesBuffer = nullptr;
 
-	_needToUpdateMeasurementVolume = false;
+	_floorPlane = FloorPlane{};
+	_pendingCalibrationKey = 0;
+	_needToUpdateCalibration = false;
+
+	InvalidateFrameAnalysis();
 
 	_debugDirectory = "";
+	_calibrationCacheDirectory = "";
+
+	_debugImageWriter = std::unique_ptr<DebugImageWriter>(new DebugImageWriter());
+	_contourExtractor.SetDebugImageWriter(_debugImageWriter.get());
 }
 
 DepthMapProcessor::~DepthMapProcessor()
 {
+	if (_pendingCalibration.valid())
+		_pendingCalibration.wait();
+	ReleaseAbandonedCalibrations(true);
+
 	if (_depthMapBuffer != nullptr)
 	{
 		delete[] _depthMapBuffer;
@@ -53,23 +78,11 @@ DepthMapProcessor::~DepthMapProcessor()
 		_depthMaskBuffer = nullptr;
 	}
 
-	if (_colorImageBuffer != nullptr)
-	{
-		delete[] _colorImageBuffer;
-		_colorImageBuffer = nullptr;
-	}
-
 	if (_sortedNonZeroMapValuesBuffer != nullptr)
 	{
 		delete[] _sortedNonZeroMapValuesBuffer;
 		_sortedNonZeroMapValuesBuffer = nullptr;
 	}
-
-	if (_worldDepthValuesBuffer != nullptr)
-	{
-		delete[] _worldDepthValuesBuffer;
-		_worldDepthValuesBuffer = nullptr;
-	}
 }
 
 void DepthMapProcessor::SetAlgorithmSettings(const short floorDepth, const short cutOffDepth, 
@@ -89,7 +102,40 @@ void DepthMapProcessor::SetAlgorithmSettings(const short floorDepth, const short
 	for (int i = 0; i < polygonPointCount; i++)
 		_polygonPoints.emplace_back(cv::Point2f(polygonPoints[i].X, polygonPoints[i].Y));
 
-	_needToUpdateMeasurementVolume = true;
+	InvalidateFrameAnalysis();
+	StartCalibrationUpdate();
+}
+
+void DepthMapProcessor::SetFloorPlane(const FloorPlane& plane)
+{
+	_floorPlane = plane;
+	InvalidateFrameAnalysis();
+	StartCalibrationUpdate();
+}
+
+void DepthMapProcessor::SetDepthToColorExtrinsics(const Extrinsics& extrinsics)
+{
+	_depthColorRegistration.SetExtrinsics(extrinsics);
+	InvalidateFrameAnalysis();
+}
+
+void DepthMapProcessor::SetColorSegmentationMode(const ColorSegmentationMode mode)
+{
+	_colorSegmentationMode = mode;
+	InvalidateFrameAnalysis();
+}
+
+void DepthMapProcessor::SetDepthDecimation(const int factor, const DepthDecimationFilter filter)
+{
+	_depthDecimationFactor = std::min(std::max(factor, 1), MaxDepthDecimationFactor);
+	_depthDecimationFilter = filter;
+	InvalidateFrameAnalysis();
+}
+
+void DepthMapProcessor::SetDepthDenoising(const bool enabled)
+{
+	_denoiseDepth = enabled;
+	InvalidateFrameAnalysis();
 }
 
 void DepthMapProcessor::SetDebugDirectory(const char* path)
@@ -98,8 +144,15 @@ void DepthMapProcessor::SetDebugDirectory(const char* path)
 	_contourExtractor.SetDebugDirectory(_debugDirectory);
 }
 
+void DepthMapProcessor::SetCalibrationCacheDirectory(const char* path)
+{
+	_calibrationCacheDirectory = path;
+}
+
 NativeAlgorithmSelectionResult* DepthMapProcessor::SelectAlgorithm(const NativeAlgorithmSelectionData data)
 {
+	TRACE_SCOPE("DepthMapProcessor::SelectAlgorithm");
+
 	const bool dataIsValid = data.DepthMap->Data != nullptr && data.ColorImage->Data != nullptr;
 	if (!dataIsValid)
 		return new NativeAlgorithmSelectionResult{ AlgorithmSelectionStatus::DataIsInvalid, false };
@@ -108,14 +161,22 @@ NativeAlgorithmSelectionResult* DepthMapProcessor::SelectAlgorithm(const NativeA
 	if (!atLeastOneModeIsEnabled)
 		return new NativeAlgorithmSelectionResult{ AlgorithmSelectionStatus::NoAlgorithmsAllowed, false };
 
-	PrepareBuffers(data.DepthMap, data.ColorImage);
+	// flat objects may only be visible in the color image, so the depth probe can not rule them out
+	if (!data.RgbEnabled && IsSceneEmpty(*data.DepthMap))
+		return new NativeAlgorithmSelectionResult{ AlgorithmSelectionStatus::NoObjectFound, false };
+
+	AnalyzeFrame(data.DepthMap, data.ColorImage);
 
-	const Contour& colorObjectContour = data.RgbEnabled ? GetTargetContourFromColorImage(data.DebugFileName) : Contour();
-	const int colorContourArea = !colorObjectContour.empty() ? (int)cv::contourArea(colorObjectContour) : 0;
+	// the contours are the frame analysis' own, whatever is measured on them here is kept for the calculation
+	const ContourGeometry noContour;
+	const ContourGeometry& depthBlobContour = _frameAnalysis.DepthContour;
+
+	const ContourGeometry& colorObjectContour = data.RgbEnabled ? GetFrameColorContour(data.DebugFileName) : noContour;
+	const int colorContourArea = (int)colorObjectContour.GetArea();
 	const bool colorContourExists = colorContourArea > 3;
 
-	const Contour& depthObjectContour = (data.Dm1Enabled || data.Dm2Enabled) ? GetTargetContourFromDepthMap() : Contour();
-	const int depthContourArea = !depthObjectContour.empty() ? (int)cv::contourArea(depthObjectContour) : 0;
+	const ContourGeometry& depthObjectContour = (data.Dm1Enabled || data.Dm2Enabled) ? depthBlobContour : noContour;
+	const int depthContourArea = (int)depthObjectContour.GetArea();
 	const bool depthContourExists = depthContourArea > 3;
 
 	const bool atLeastOneContourExists = colorContourExists || depthContourExists;
@@ -134,7 +195,7 @@ NativeAlgorithmSelectionResult* DepthMapProcessor::SelectAlgorithm(const NativeA
 
 	const short rangeMeterDistance = data.CalculatedDistance;
 	const ContourPlanes& depthContourPlanes = depthContourExists
-		? GetDepthContourPlanes(depthObjectContour)
+		? GetFrameDepthPlanes()
 		: ContourPlanes{ 0, 0 };
 
 	bool rangeMeterWasUsed = false;
@@ -149,12 +210,13 @@ NativeAlgorithmSelectionResult* DepthMapProcessor::SelectAlgorithm(const NativeA
 	}
 
 	const int minObjHeight = 3;
-	short objectHeight = _floorDepth - contourTopPlaneDepth;
+	const short floorDepth = GetFloorDepthUnderContour(depthObjectContour);
+	short objectHeight = floorDepth - contourTopPlaneDepth;
 	if (contourTopPlaneDepth <= 0 || objectHeight <= 0)
 	{
 		if (data.RgbEnabled && colorContourExists)
 		{
-			contourTopPlaneDepth = _floorDepth - minObjHeight;
+			contourTopPlaneDepth = floorDepth - minObjHeight;
 			objectHeight = minObjHeight;
 		}
 		else
@@ -190,50 +252,54 @@ NativeAlgorithmSelectionResult* DepthMapProcessor::SelectAlgorithm(const NativeA
 		algorithm = planesAreWithinMargin ? AlgorithmSelectionStatus::Dm1 : AlgorithmSelectionStatus::Dm2;
 	}
 
-	// Saving debug data (by passing debug file name)
-	CalculateObjectBoundingRect(depthObjectContour, colorObjectContour, algorithm, contourTopPlaneDepth, data.DebugFileName);
+	WriteContourDebugImages(depthObjectContour, colorObjectContour, algorithm, contourTopPlaneDepth, data.DebugFileName);
 
 	return new NativeAlgorithmSelectionResult{ algorithm, rangeMeterWasUsed };
 }
 
 VolumeCalculationResult* DepthMapProcessor::CalculateObjectVolume(const VolumeCalculationData& data)
 {
+	TRACE_SCOPE("DepthMapProcessor::CalculateObjectVolume");
+
 	if (data.DepthMap == nullptr || data.DepthMap->Data == nullptr)
 		return nullptr;
 
 	if (data.ColorImage == nullptr || data.ColorImage->Data == nullptr)
 		return nullptr;
 
-	PrepareBuffers(data.DepthMap, data.ColorImage);
-
-	const Contour& colorObjectContour = data.SelectedAlgorithm == AlgorithmSelectionStatus::Rgb ? GetTargetContourFromColorImage() : Contour();
-	const int colorContourArea = !colorObjectContour.empty() ? (int)cv::contourArea(colorObjectContour) : 0;
-	const bool colorContourExists = colorContourArea > 3;
+	AnalyzeFrame(data.DepthMap, data.ColorImage);
 
-	const Contour& depthObjectContour = GetTargetContourFromDepthMap();
-	const int depthContourArea = !depthObjectContour.empty() ? (int)cv::contourArea(depthObjectContour) : 0;
+	const ContourGeometry noContour;
+	const ContourGeometry& depthObjectContour = _frameAnalysis.DepthContour;
+	const int depthContourArea = (int)depthObjectContour.GetArea();
 	const bool depthContourExists = depthContourArea > 3;
 
+	const ContourGeometry& colorObjectContour = data.SelectedAlgorithm == AlgorithmSelectionStatus::Rgb
+		? GetFrameColorContour()
+		: noContour;
+	const int colorContourArea = (int)colorObjectContour.GetArea();
+	const bool colorContourExists = colorContourArea > 3;
+
 	const bool atLeastOneContourExists = colorContourExists || depthContourExists;
 	if (!atLeastOneContourExists)
 		return nullptr;
 
 	// out of easy invalid cases
 
-	const short rangeMeterDistance = data.CalculatedDistance;
 	const ContourPlanes& depthContourPlanes = depthContourExists
-		? GetDepthContourPlanes(depthObjectContour)
+		? GetFrameDepthPlanes()
 		: ContourPlanes{ 0, 0 };
 
 	short contourTopPlaneDepth = depthContourPlanes.Top;
 
 	const int minObjHeight = 3;
-	short objectHeight = _floorDepth - contourTopPlaneDepth;
+	const short floorDepth = GetFloorDepthUnderContour(depthObjectContour);
+	short objectHeight = floorDepth - contourTopPlaneDepth;
 	if (contourTopPlaneDepth <= 0 || objectHeight <= 0)
 	{
 		if (data.SelectedAlgorithm == AlgorithmSelectionStatus::Rgb && colorContourExists)
 		{
-			contourTopPlaneDepth = _floorDepth - minObjHeight;
+			contourTopPlaneDepth = floorDepth - minObjHeight;
 			objectHeight = minObjHeight;
 		}
 		else
@@ -247,24 +313,253 @@ VolumeCalculationResult* DepthMapProcessor::CalculateObjectVolume(const VolumeCa
 	result->LengthMm = object2DSize.Length;
 	result->WidthMm = object2DSize.Width;
 	result->HeightMm = objectHeight;
+	result->FrameNumber = data.Timing.FrameNumber;
+	result->CaptureTimestampUs = data.Timing.CaptureTimestampUs;
+
+	// unfiltered depth keeps the low parts of the object that fall under the cut-off, sensor holes take the top plane depth
+	if (depthContourExists)
+	{
+		result->VolumeMm3 = CalculationUtils::GetIntegratedVolume(depthObjectContour, data.DepthMap->Data,
+			_calibration->FloorDepths.data(), _mapWidth, _depthIntrinsics, contourTopPlaneDepth);
+	}
+
+	return result;
+}
+
+MultiVolumeCalculationResult* DepthMapProcessor::CalculateObjectVolumes(const DepthMap& depthMap)
+{
+	TRACE_SCOPE("DepthMapProcessor::CalculateObjectVolumes");
+
+	if (depthMap.Data == nullptr)
+		return nullptr;
+
+	auto result = new MultiVolumeCalculationResult{ 0, nullptr };
+
+	if (IsSceneEmpty(depthMap))
+		return result;
+
+	PrepareDepthBuffer(&depthMap);
+
+	// a single labeling pass, every object shares the filtered map and the calibration
+	const cv::Mat imageForContourSearch(_mapHeight, _mapWidth, CV_8UC1, _depthMaskBuffer);
+	const std::vector<ContourGeometry>& objectContours = _contourExtractor.ExtractContoursFromBinaryImage(imageForContourSearch);
+	if (objectContours.empty())
+		return result;
+
+	const int contourCount = std::min((int)objectContours.size(), _maxMeasuredObjectCount);
+	result->Objects = new ObjectMeasurement[contourCount];
+
+	for (int i = 0; i < contourCount; i++)
+	{
+		if (MeasureDepthObject(objectContours[i], depthMap.Data, result->Objects[result->ObjectCount]))
+			result->ObjectCount++;
+	}
 
 	return result;
 }
 
+const int DepthMapProcessor::ProcessConveyorFrame(const DepthMap& depthMap, ConveyorMeasurement*const measurements,
+	const int capacity)
+{
+	TRACE_SCOPE("DepthMapProcessor::ProcessConveyorFrame");
+
+	if (depthMap.Data == nullptr || measurements == nullptr)
+		return 0;
+
+	cv::Rect boundingRects[MaxTrackedObjectCount];
+	cv::Point2f centers[MaxTrackedObjectCount];
+	int trackSlots[MaxTrackedObjectCount];
+
+	std::vector<ContourGeometry> objectContours;
+	if (!IsSceneEmpty(depthMap))
+	{
+		PrepareDepthBuffer(&depthMap);
+
+		const cv::Mat imageForContourSearch(_mapHeight, _mapWidth, CV_8UC1, _depthMaskBuffer);
+		objectContours = _contourExtractor.ExtractContoursFromBinaryImage(imageForContourSearch);
+	}
+
+	const int detectionCount = std::min((int)objectContours.size(), MaxTrackedObjectCount);
+	for (int i = 0; i < detectionCount; i++)
+	{
+		boundingRects[i] = objectContours[i].GetBoundingRect();
+		centers[i] = objectContours[i].GetCenter();
+	}
+
+	_objectTracker.AssociateDetections(boundingRects, centers, detectionCount, trackSlots);
+
+	// only objects that are still collecting samples are measured, which bounds the work per frame
+	for (int i = 0; i < detectionCount; i++)
+	{
+		if (!_objectTracker.NeedsSamples(trackSlots[i]) || !IsContourClearOfZoneEdge(objectContours[i].GetContour()))
+			continue;
+
+		ObjectMeasurement measurement;
+		if (MeasureDepthObject(objectContours[i], depthMap.Data, measurement))
+			_objectTracker.AddSample(trackSlots[i], measurement);
+	}
+
+	return _objectTracker.CollectMeasurements(measurements, capacity);
+}
+
+void DepthMapProcessor::ResetConveyorTracking()
+{
+	_objectTracker.Reset();
+}
+
+void DepthMapProcessor::SetConveyorSampleCount(const int sampleCount)
+{
+	_objectTracker.SetRequiredSampleCount(sampleCount);
+}
+
+void DepthMapProcessor::AnalyzeFrame(const DepthMap*const depthMap, const ColorImage*const colorImage)
+{
+	TRACE_SCOPE("DepthMapProcessor::AnalyzeFrame");
+
+	// the frames' sizes are part of the hashes, so a frame of another size never matches
+	const unsigned long long depthHash = DmUtils::GetDataHash((const byte*)depthMap->Data,
+		depthMap->Width * depthMap->Height * sizeof(short), ((unsigned long long)depthMap->Width << 32) | depthMap->Height);
+	const unsigned long long colorHash = DmUtils::GetDataHash(colorImage->Data,
+		colorImage->Width * colorImage->Height * colorImage->BytesPerPixel,
+		((unsigned long long)colorImage->Width << 32) | (colorImage->Height << 8) | colorImage->BytesPerPixel);
+
+	// the color contour may still have to be found in this call, from this call's image
+	SetColorImage(colorImage);
+
+	const bool frameWasAnalyzed = _frameAnalysis.IsValid && _frameAnalysis.DepthHash == depthHash &&
+		_frameAnalysis.ColorHash == colorHash;
+	if (frameWasAnalyzed)
+		return;
+
+	PrepareBuffers(depthMap, colorImage);
+
+	_frameAnalysis.DepthContour = GetTargetContourFromDepthMap();
+	_frameAnalysis.DepthHash = depthHash;
+	_frameAnalysis.ColorHash = colorHash;
+	_frameAnalysis.IsValid = true;
+}
+
+const ContourGeometry& DepthMapProcessor::GetFrameColorContour(const char* debugPath)
+{
+	if (!_frameAnalysis.HasColorContour)
+	{
+		_frameAnalysis.ColorContour = GetTargetContourFromColorImage(_frameAnalysis.DepthContour, debugPath);
+		_frameAnalysis.HasColorContour = true;
+	}
+
+	return _frameAnalysis.ColorContour;
+}
+
+const ContourPlanes& DepthMapProcessor::GetFrameDepthPlanes()
+{
+	if (!_frameAnalysis.HasDepthPlanes)
+	{
+		_frameAnalysis.DepthPlanes = GetDepthContourPlanes(_frameAnalysis.DepthContour);
+		_frameAnalysis.HasDepthPlanes = true;
+	}
+
+	return _frameAnalysis.DepthPlanes;
+}
+
+void DepthMapProcessor::InvalidateFrameAnalysis()
+{
+	_frameAnalysis.IsValid = false;
+	_frameAnalysis.DepthHash = 0;
+	_frameAnalysis.ColorHash = 0;
+	_frameAnalysis.DepthContour = ContourGeometry();
+	_frameAnalysis.HasColorContour = false;
+	_frameAnalysis.ColorContour = ContourGeometry();
+	_frameAnalysis.HasDepthPlanes = false;
+	_frameAnalysis.DepthPlanes = ContourPlanes{ 0, 0 };
+}
+
 void DepthMapProcessor::PrepareBuffers(const DepthMap*const depthMap, const ColorImage*const colorImage)
 {
-	FillDepthBufferFromDepthMap(depthMap);
-	DmUtils::FilterDepthMapByMaxDepth(_mapLength, _depthMapBuffer, _cutOffDepth);
-	FillColorBufferFromImage(colorImage);
+	SetColorImage(colorImage);
+
+	if (_depthDecimationFactor > 1)
+		PrepareDecimatedDepthBuffer(depthMap);
+	else
+		PrepareDepthBuffer(depthMap);
+}
+
+void DepthMapProcessor::PrepareDepthBuffer(const DepthMap*const depthMap)
+{
+	TRACE_SCOPE("DepthMapProcessor::PrepareDepthBuffer");
 
-	if (_needToUpdateMeasurementVolume)
+	// whatever was analyzed before is overwritten
+	InvalidateFrameAnalysis();
+	AllocateDepthBuffers(depthMap->Width, depthMap->Height);
+
+	// denoising works in place, otherwise the map is filtered straight from the source
+	const short* filterSource = depthMap->Data;
+	if (_denoiseDepth)
 	{
-		UpdateMeasurementVolume(depthMap->Width, depthMap->Height);
-		_needToUpdateMeasurementVolume = false;
+		memcpy(_depthMapBuffer, depthMap->Data, _mapLengthBytes);
+		_depthDenoiser.Apply(_depthMapBuffer, _mapWidth, cv::Rect(0, 0, _mapWidth, _mapHeight));
+		filterSource = _depthMapBuffer;
 	}
 
-	CalculationUtils::GetWorldDepthValuesFromDepthMap(_mapWidth, _mapHeight, _depthMapBuffer, _depthIntrinsics, _worldDepthValuesBuffer);
-	DmUtils::FilterDepthMapByMeasurementVolume(_mapLength, _depthMapBuffer, _worldDepthValuesBuffer, _measurementVolume);
+	UpdateCalibration();
+
+	// the mask is built along with the filtered map
+	_zoneFilter.Apply(_calibration, _depthIntrinsics, filterSource, _depthMapBuffer, _depthMaskBuffer);
+}
+
+void DepthMapProcessor::PrepareDecimatedDepthBuffer(const DepthMap*const depthMap)
+{
+	TRACE_SCOPE("DepthMapProcessor::PrepareDecimatedDepthBuffer");
+
+	InvalidateFrameAnalysis();
+	AllocateDepthBuffers(depthMap->Width, depthMap->Height);
+
+	UpdateCalibration();
+
+	const int factor = _depthDecimationFactor;
+	_decimatedMapWidth = (_mapWidth + factor - 1) / factor;
+	_decimatedMapHeight = (_mapHeight + factor - 1) / factor;
+	const int decimatedMapLength = _decimatedMapWidth * _decimatedMapHeight;
+	if ((int)_decimatedMaskBuffer.size() != decimatedMapLength)
+		_decimatedMaskBuffer.resize(decimatedMapLength);
+
+	DmUtils::ConvertDepthMapToDecimatedMask(_mapWidth, _mapHeight, depthMap->Data, *_calibration, _depthIntrinsics,
+		factor, _depthDecimationFilter, _decimatedMaskBuffer.data());
+
+	// outside of the refinement rect the buffers look like a filtered map with nothing in it
+	memset(_depthMapBuffer, 0, _mapLengthBytes);
+	memset(_depthMaskBuffer, 0, sizeof(byte) * _mapLength);
+
+	const cv::Mat decimatedMask(_decimatedMapHeight, _decimatedMapWidth, CV_8UC1, _decimatedMaskBuffer.data());
+	const ContourGeometry& coarseContour = _contourExtractor.ExtractContourFromBinaryImage(decimatedMask);
+	if (coarseContour.IsEmpty())
+	{
+		_depthRefinementRect = cv::Rect();
+		return;
+	}
+
+	// a block's selected value may miss object pixels next to it, hence the margin
+	const cv::Rect& coarseRect = coarseContour.GetBoundingRect();
+	const int margin = factor + 1;
+	const cv::Rect refinementRect(coarseRect.x * factor - margin, coarseRect.y * factor - margin,
+		coarseRect.width * factor + 2 * margin, coarseRect.height * factor + 2 * margin);
+	_depthRefinementRect = refinementRect & cv::Rect(0, 0, _mapWidth, _mapHeight);
+
+	// denoising works in place, so the rect is copied first and filtered from the copy
+	const short* refinementSource = depthMap->Data;
+	if (_denoiseDepth)
+	{
+		for (int j = _depthRefinementRect.y; j < _depthRefinementRect.y + _depthRefinementRect.height; j++)
+		{
+			const int rowOffset = j * _mapWidth + _depthRefinementRect.x;
+			memcpy(_depthMapBuffer + rowOffset, depthMap->Data + rowOffset, _depthRefinementRect.width * sizeof(short));
+		}
+
+		_depthDenoiser.Apply(_depthMapBuffer, _mapWidth, _depthRefinementRect);
+		refinementSource = _depthMapBuffer;
+	}
+
+	DmUtils::FilterDepthMapRegionByCalibration(_mapWidth, _depthRefinementRect, refinementSource, _depthMapBuffer,
+		_depthMaskBuffer, *_calibration, _depthIntrinsics);
 }
 
 const short DepthMapProcessor::CalculateFloorDepth(const DepthMap& depthMap)
@@ -278,34 +573,63 @@ const short DepthMapProcessor::CalculateFloorDepth(const DepthMap& depthMap)
 	return DmUtils::FindModeInSortedArray(nonZeroValues.data(), (int)nonZeroValues.size());
 }
 
-void DepthMapProcessor::FillColorBufferFromImage(const ColorImage* image)
+const bool DepthMapProcessor::CalculateFloorPlane(const DepthMap& depthMap, FloorPlane& plane) const
+{
+	TRACE_SCOPE("DepthMapProcessor::CalculateFloorPlane");
+
+	return FloorPlaneEstimator::EstimateFloorPlane(depthMap, _depthIntrinsics, plane);
+}
+
+const bool DepthMapProcessor::UpdateColorBackground(const DepthMap*const depthMap, const ColorImage*const colorImage)
+{
+	TRACE_SCOPE("DepthMapProcessor::UpdateColorBackground");
+
+	const bool dataIsValid = depthMap != nullptr && depthMap->Data != nullptr && colorImage != nullptr && colorImage->Data != nullptr;
+	if (!dataIsValid)
+		return false;
+
+	PrepareBuffers(depthMap, colorImage);
+
+	// only frames with nothing in the measurement zone are learned
+	const ContourGeometry& depthBlobContour = GetTargetContourFromDepthMap();
+	if (!depthBlobContour.IsEmpty())
+		return false;
+
+	const cv::Mat image(_colorImageHeight, _colorImageWidth, _colorImageCvType, _colorImageData);
+	_colorBackgroundModel.Update(image);
+	InvalidateFrameAnalysis();
+
+	return true;
+}
+
+void DepthMapProcessor::ResetColorBackground()
+{
+	_colorBackgroundModel.Reset();
+	InvalidateFrameAnalysis();
+}
+
+void DepthMapProcessor::SetColorImage(const ColorImage* image)
 {
 	const int newWidth = image->Width;
 	const int newHeight = image->Height;
 	const int bpp = image->BytesPerPixel;
 
-	const bool dimsAreTheSame = _colorImageWidth == newWidth && _colorImageHeight == newHeight && _colorImageLengthBytes == bpp;
+	// the pixel format is resolved here, once per change of the image format rather than for every use of the image
+	const bool dimsAreTheSame = _colorImageWidth == newWidth && _colorImageHeight == newHeight && _colorImageBytesPerPixel == bpp;
 	if (!dimsAreTheSame)
 	{
 		_colorImageWidth = newWidth;
 		_colorImageHeight = newHeight;
-		const int colorImageLength = newWidth * newHeight;
-		_colorImageLengthBytes = colorImageLength * bpp;
 		_colorImageBytesPerPixel = bpp;
-
-		if (_colorImageBuffer != nullptr)
-			delete[] _colorImageBuffer;
-		_colorImageBuffer = new byte[_colorImageLengthBytes];
+		_colorImageCvType = DmUtils::GetCvChannelsCodeFromBytesPerPixel(bpp);
 	}
 
-	memcpy(_colorImageBuffer, image->Data, _colorImageLengthBytes);
+	// nothing is copied, only the search rect is ever read, and only once
+	_colorImageData = image->Data;
 }
 
-void DepthMapProcessor::FillDepthBufferFromDepthMap(const DepthMap* depthMap)
+void DepthMapProcessor::AllocateDepthBuffers(const int newWidth, const int newHeight)
 {
-	const int newWidth = depthMap->Width;
-	const int newHeight = depthMap->Height;
-
 	const bool dimsAreTheSame = _mapWidth == newWidth && _mapHeight == newHeight;
 	if (!dimsAreTheSame)
 	{
@@ -321,112 +645,177 @@ void DepthMapProcessor::FillDepthBufferFromDepthMap(const DepthMap* depthMap)
 		if (_depthMaskBuffer != nullptr)
 			delete[] _depthMaskBuffer;
 		_depthMaskBuffer = new byte[_mapLength];
-
-		if (_worldDepthValuesBuffer != nullptr)
-			delete[] _worldDepthValuesBuffer;
-		_worldDepthValuesBuffer = new DepthValue[_mapLength];
 	}
-
-	memset(_depthMaskBuffer, 0, sizeof(byte) * _mapLength);
-	memset(_worldDepthValuesBuffer, 0, sizeof(DepthValue) * _mapLength);
-	memcpy(_depthMapBuffer, depthMap->Data, _mapLengthBytes);
 }
 
-const Contour DepthMapProcessor::GetTargetContourFromDepthMap() const
+const ContourGeometry DepthMapProcessor::GetTargetContourFromDepthMap() const
 {
-	DmUtils::ConvertDepthMapDataToBinaryMask(_mapLength, _depthMapBuffer, _depthMaskBuffer);
+	TRACE_SCOPE("DepthMapProcessor::GetTargetContourFromDepthMap");
+
+	// the decimated path has already built the mask, and only inside the refinement rect
+	if (_depthDecimationFactor > 1)
+	{
+		if (_depthRefinementRect.area() == 0)
+			return ContourGeometry();
+
+		const cv::Mat imageForContourSearch(_mapHeight, _mapWidth, CV_8UC1, _depthMaskBuffer);
+
+		return _contourExtractor.ExtractContourFromBinaryImageRegion(imageForContourSearch, _depthRefinementRect);
+	}
+
 	cv::Mat imageForContourSearch(_mapHeight, _mapWidth, CV_8UC1, _depthMaskBuffer);
 
 	return _contourExtractor.ExtractContourFromBinaryImage(imageForContourSearch);
 }
 
-const Contour DepthMapProcessor::GetTargetContourFromColorImage(const char* debugPath) const
+const ContourGeometry DepthMapProcessor::GetTargetContourFromColorImage(const ContourGeometry& depthObjectContour,
+	const char* debugPath)
 {
-	const int cvChannelsCode = DmUtils::GetCvChannelsCodeFromBytesPerPixel(_colorImageBytesPerPixel);
-	cv::Mat input(_colorImageHeight, _colorImageWidth, cvChannelsCode, _colorImageBuffer);
+	TRACE_SCOPE("DepthMapProcessor::GetTargetContourFromColorImage");
+
+	const cv::Mat input(_colorImageHeight, _colorImageWidth, _colorImageCvType, _colorImageData);
 
 	const cv::Rect& roi = DmUtils::GetAbsRoiFromRoiRect(_colorRoiRect, cv::Size(input.cols, input.rows));
-	const cv::Mat& inputRoi = input(roi);
+	const cv::Rect& searchRect = GetColorSearchRect(depthObjectContour, roi);
+	Contour contour = ExtractContourFromColorImage(input, searchRect, debugPath);
 
-	return _contourExtractor.ExtractContourFromColorImage(inputRoi, debugPath);
+	// the contour stays relative to the configured roi, whatever part of it was searched
+	const int offsetX = searchRect.x - roi.x;
+	const int offsetY = searchRect.y - roi.y;
+	for (int i = 0; i < contour.size(); i++)
+	{
+		contour[i].x += offsetX;
+		contour[i].y += offsetY;
+	}
+
+	return ContourGeometry(std::move(contour));
 }
 
-const TwoDimDescription DepthMapProcessor::Calculate2DContourDimensions(const Contour& depthObjectContour,
-	const Contour& colorObjectContour, const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth) const
+const Contour DepthMapProcessor::ExtractContourFromColorImage(const cv::Mat& image, const cv::Rect& searchRect,
+	const char* debugPath)
 {
-	const cv::RotatedRect& boundingRect = CalculateObjectBoundingRect(depthObjectContour, colorObjectContour,
-		selectedAlgorithm, contourTopPlaneDepth);
+	// falls back to edge detection until enough empty frames were seen
+	const bool backgroundModelIsUsable = _colorSegmentationMode == ColorSegmentationMode::BackgroundModel &&
+		_colorBackgroundModel.IsReady() && _colorBackgroundModel.MatchesImage(image);
+	if (!backgroundModelIsUsable)
+	{
+		// the edges are found on the luminance of the search rect, cropped and converted in a single pass
+		const cv::Mat& luma = _lumaConverter.Convert(image, searchRect);
 
-	const CameraIntrinsics& selectedInstrinsics = selectedAlgorithm == AlgorithmSelectionStatus::Rgb ? _colorIntrinsics : _depthIntrinsics;
+		return _contourExtractor.ExtractContourFromColorImage(luma, debugPath);
+	}
 
-	const TwoDimDescription& twoDimDescription = GetTwoDimDescription(boundingRect, selectedInstrinsics, contourTopPlaneDepth);
+	cv::Mat foregroundMask;
+	_colorBackgroundModel.GetForegroundMask(image, searchRect, foregroundMask);
 
-	TwoDimDescription result{};
-	result.Length = twoDimDescription.Length;
-	result.Width = twoDimDescription.Width;
+	return _contourExtractor.ExtractContourFromForegroundMask(foregroundMask, debugPath);
+}
 
-	return result;
+const cv::Rect DepthMapProcessor::GetColorSearchRect(const ContourGeometry& depthObjectContour, const cv::Rect& roi) const
+{
+	if (depthObjectContour.IsEmpty() || _calibration == nullptr)
+		return roi;
+
+	// flat or dark objects are often only partly seen in depth, a small depth object or one cut by the zone's edge
+	// may be a fragment of the object in the color image, so the whole roi is searched then
+	const bool depthObjectIsSmall = depthObjectContour.GetArea() < _mapLength * _minColorSearchObjectAreaRatio;
+	if (depthObjectIsSmall || !IsContourClearOfZoneEdge(depthObjectContour.GetContour()))
+		return roi;
+
+	const cv::Rect& depthRect = depthObjectContour.GetBoundingRect();
+	const cv::Rect& objectRect = _depthColorRegistration.MapDepthRectToColor(depthRect, _calibration->Volume.smallerDepthValue,
+		_calibration->Volume.largerDepthValue, cv::Size(_colorImageWidth, _colorImageHeight));
+	if (objectRect.area() == 0)
+		return roi;
+
+	const int marginX = std::max((int)(objectRect.width * _colorSearchMarginRatio), _minColorSearchMargin);
+	const int marginY = std::max((int)(objectRect.height * _colorSearchMarginRatio), _minColorSearchMargin);
+	const cv::Rect searchRect(objectRect.x - marginX, objectRect.y - marginY,
+		objectRect.width + 2 * marginX, objectRect.height + 2 * marginY);
+
+	const cv::Rect& croppedSearchRect = searchRect & roi;
+
+	return croppedSearchRect.area() > 0 ? croppedSearchRect : roi;
 }
 
-const cv::RotatedRect DepthMapProcessor::CalculateObjectBoundingRect(const Contour& depthObjectContour,
-	const Contour& colorObjectContour, const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth,
-	const char* debugFilename) const
+const TwoDimDescription DepthMapProcessor::Calculate2DContourDimensions(const ContourGeometry& depthObjectContour,
+	const ContourGeometry& colorObjectContour, const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth) const
 {
+	TRACE_SCOPE("DepthMapProcessor::Calculate2DContourDimensions");
+
+	BoxFootprint footprint{};
 	switch (selectedAlgorithm)
 	{
 	case AlgorithmSelectionStatus::Dm1:
+		footprint = BoxFitter::FitImageContour(depthObjectContour, _depthIntrinsics, contourTopPlaneDepth);
+		break;
+	case AlgorithmSelectionStatus::Dm2:
 	{
-		if (_debugDirectory != "" && debugFilename != "")
-		{
-			const std::string& filename = _debugDirectory + "/" + debugFilename + "_ctr_depth.png";
-			DmUtils::DrawTargetContour(depthObjectContour, _mapWidth, _mapHeight, filename);
-		}
-
-		return cv::minAreaRect(depthObjectContour);
+		// every contour point is deprojected at its own depth, the sides of the object may lean
+		const std::vector<DepthValue>& worldDepthValues = CalculationUtils::GetWorldDepthValues(depthObjectContour,
+			_depthMapBuffer, _mapWidth, _depthIntrinsics);
+		footprint = BoxFitter::FitWorldPoints(worldDepthValues);
+		break;
+	}
+	case AlgorithmSelectionStatus::Rgb:
+		footprint = BoxFitter::FitImageContour(colorObjectContour, _colorIntrinsics, contourTopPlaneDepth);
+		break;
+	default:
+		break;
 	}
+
+	TwoDimDescription result{};
+	result.Length = (int)footprint.LengthMm;
+	result.Width = (int)footprint.WidthMm;
+
+	return result;
+}
+
+void DepthMapProcessor::WriteContourDebugImages(const ContourGeometry& depthObjectContour, const ContourGeometry& colorObjectContour,
+	const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth, const char* debugFilename) const
+{
+	if (_debugDirectory == "" || debugFilename == "")
+		return;
+
+	const std::string& depthFilename = _debugDirectory + "/" + debugFilename + "_ctr_depth.png";
+
+	switch (selectedAlgorithm)
+	{
+	case AlgorithmSelectionStatus::Dm1:
+		_debugImageWriter->EnqueueContour(depthObjectContour.GetContour(), _mapWidth, _mapHeight, depthFilename);
+		break;
 	case AlgorithmSelectionStatus::Dm2:
 	{
 		const std::vector<DepthValue>& worldDepthValues = CalculationUtils::GetWorldDepthValues(depthObjectContour, _depthMapBuffer, _mapWidth, _depthIntrinsics);
 		const Contour& perspectiveCorrectedContour = CalculationUtils::GetCameraPoints(worldDepthValues, contourTopPlaneDepth, _depthIntrinsics);
-
-		if (_debugDirectory != "" && debugFilename != "")
-		{
-			const std::string& filename = _debugDirectory + "/" + debugFilename + "_ctr_depth.png";
-			DmUtils::DrawTargetContour(perspectiveCorrectedContour, _mapWidth, _mapHeight, filename);
-		}
-
-		return cv::minAreaRect(perspectiveCorrectedContour);
+		_debugImageWriter->EnqueueContour(perspectiveCorrectedContour, _mapWidth, _mapHeight, depthFilename);
+		break;
 	}
 	case AlgorithmSelectionStatus::Rgb:
 	{
-		if (_debugDirectory != "" && debugFilename != "")
-		{
-			const std::string& depthFilename = _debugDirectory + "/" + debugFilename + "_ctr_depth.png";
-			const std::string& colorFilename = _debugDirectory + "/" + debugFilename + "_ctr_color.png";
-			DmUtils::DrawTargetContour(depthObjectContour, _mapWidth, _mapHeight, depthFilename);
-			DmUtils::DrawTargetContour(colorObjectContour, _mapWidth, _mapHeight, colorFilename);
-		}
-
-		return cv::minAreaRect(colorObjectContour);
+		const std::string& colorFilename = _debugDirectory + "/" + debugFilename + "_ctr_color.png";
+		_debugImageWriter->EnqueueContour(depthObjectContour.GetContour(), _mapWidth, _mapHeight, depthFilename);
+		_debugImageWriter->EnqueueContour(colorObjectContour.GetContour(), _mapWidth, _mapHeight, colorFilename);
+		break;
 	}
 	default:
-		return cv::RotatedRect();
+		break;
 	}
 }
 
-const ContourPlanes DepthMapProcessor::GetDepthContourPlanes(const Contour& depthObjectContour)
+const ContourPlanes DepthMapProcessor::GetDepthContourPlanes(const ContourGeometry& depthObjectContour)
 {
+	TRACE_SCOPE("DepthMapProcessor::GetDepthContourPlanes");
+
 	ContourPlanes planes{};
 	planes.Top = 0;
 	planes.Bottom = 0;
 
-	if (depthObjectContour.size() == 0)
+	if (depthObjectContour.IsEmpty())
 		return planes;
 
-	const cv::RotatedRect& objectBoundingRect = cv::minAreaRect(depthObjectContour);
-
 	const std::vector<short>& contourNonZeroValues = DmUtils::GetNonZeroContourDepthValues(_mapWidth, _mapHeight, _depthMapBuffer,
-		objectBoundingRect, depthObjectContour);
+		depthObjectContour.GetBoundingRect(), depthObjectContour.GetContour());
 	if (contourNonZeroValues.size() == 0)
 		return planes;
 
@@ -443,77 +832,204 @@ const ContourPlanes DepthMapProcessor::GetDepthContourPlanes(const Contour& dept
 		memset(_sortedNonZeroMapValuesBuffer, 0, sizeof(short) * _sortedNonZeroMapValuesCount);
 	}
 
-	memcpy(_sortedNonZeroMapValuesBuffer, contourNonZeroValues.data(), _sortedNonZeroMapValuesCount * sizeof(short));
-	std::sort(_sortedNonZeroMapValuesBuffer, _sortedNonZeroMapValuesBuffer + _sortedNonZeroMapValuesCount);
+	// the buffer only grows, so it can be longer than this contour's values
+	memcpy(_sortedNonZeroMapValuesBuffer, contourNonZeroValues.data(), nonZeroValuesCount * sizeof(short));
+	std::sort(_sortedNonZeroMapValuesBuffer, _sortedNonZeroMapValuesBuffer + nonZeroValuesCount);
 
-	const int valueForMeasurementCount = _sortedNonZeroMapValuesCount / 20;
+	const int valueForMeasurementCount = nonZeroValuesCount / 20;
 
 	const short topMode = DmUtils::FindModeInSortedArray(_sortedNonZeroMapValuesBuffer, valueForMeasurementCount);
 	planes.Top = topMode;
 
-	const short* bottomValuesStartPointer = _sortedNonZeroMapValuesBuffer + _sortedNonZeroMapValuesCount - valueForMeasurementCount;
+	const short* bottomValuesStartPointer = _sortedNonZeroMapValuesBuffer + nonZeroValuesCount - valueForMeasurementCount;
 	const short bottomMode = DmUtils::FindModeInSortedArray(bottomValuesStartPointer, valueForMeasurementCount);
 	planes.Bottom = bottomMode;
 
 	return planes;
 }
 
-const TwoDimDescription DepthMapProcessor::GetTwoDimDescription(const cv::RotatedRect& contourBoundingRect, 
-	const CameraIntrinsics& intrinsics, const short contourTopPlaneDepth) const
+const bool DepthMapProcessor::IsContourClearOfZoneEdge(const Contour& contour) const
 {
-	const float fx = intrinsics.FocalLengthX;
-	const float fy = intrinsics.FocalLengthY;
-	const float ppx = intrinsics.PrincipalPointX;
-	const float ppy = intrinsics.PrincipalPointY;
+	const int offsetsX[4] = { -_zoneEdgeMargin, _zoneEdgeMargin, 0, 0 };
+	const int offsetsY[4] = { 0, 0, -_zoneEdgeMargin, _zoneEdgeMargin };
 
-	cv::Point2f points[4];
-	contourBoundingRect.points(points);
-
-	cv::Point2i pointsWorld[4];
-	for (int i = 0; i < 4; i++)
+	for (int i = 0; i < contour.size(); i++)
 	{
-		const int xWorld = (int)((points[i].x + 1 - ppx) * contourTopPlaneDepth / fx);
-		const int yWorld = (int)(-(points[i].y + 1 - ppy) * contourTopPlaneDepth / fy);
-		pointsWorld[i] = cv::Point(xWorld, yWorld);
+		for (int k = 0; k < 4; k++)
+		{
+			const int x = contour[i].x + offsetsX[k];
+			const int y = contour[i].y + offsetsY[k];
+
+			const bool pointIsInMap = x >= 0 && x < _mapWidth && y >= 0 && y < _mapHeight;
+			if (!pointIsInMap || _calibration->ZoneTable[y * _mapWidth + x] == ZoneStatus::OutOfZone)
+				return false;
+		}
 	}
 
-	const int objectWidth = (int)DmUtils::GetDistanceBetweenPoints(pointsWorld[0].x, pointsWorld[0].y, pointsWorld[1].x, pointsWorld[1].y);
-	const int objectHeight = (int)DmUtils::GetDistanceBetweenPoints(pointsWorld[0].x, pointsWorld[0].y, pointsWorld[3].x, pointsWorld[3].y);
+	return true;
+}
 
-	TwoDimDescription twoDimDescription{};
-	twoDimDescription.Length = objectWidth > objectHeight ? objectWidth : objectHeight;
-	twoDimDescription.Width = objectWidth < objectHeight ? objectWidth : objectHeight;
+const bool DepthMapProcessor::MeasureDepthObject(const ContourGeometry& contour, const short*const unfilteredDepthData,
+	ObjectMeasurement& measurement)
+{
+	TRACE_SCOPE("DepthMapProcessor::MeasureDepthObject");
+
+	const int contourArea = (int)contour.GetArea();
+	if (contourArea <= 3)
+		return false;
+
+	const ContourPlanes& planes = GetDepthContourPlanes(contour);
+	const short floorDepth = GetFloorDepthUnderContour(contour);
+	const short objectHeight = floorDepth - planes.Top;
+	if (planes.Top <= 0 || objectHeight <= 0)
+		return false;
+
+	const bool planesAreWithinMargin = planes.Bottom - planes.Top < _contourPlaneDepthDeltaForDm2;
+	const AlgorithmSelectionStatus algorithm = planesAreWithinMargin ? AlgorithmSelectionStatus::Dm1 : AlgorithmSelectionStatus::Dm2;
+	const TwoDimDescription& objectSize = Calculate2DContourDimensions(contour, ContourGeometry(), algorithm, planes.Top);
+
+	measurement.LengthMm = objectSize.Length;
+	measurement.WidthMm = objectSize.Width;
+	measurement.HeightMm = objectHeight;
+	measurement.VolumeMm3 = CalculationUtils::GetIntegratedVolume(contour, unfilteredDepthData,
+		_calibration->FloorDepths.data(), _mapWidth, _depthIntrinsics, planes.Top);
+
+	const cv::Point2f& center = contour.GetCenter();
+	measurement.Center.X = center.x / _mapWidth;
+	measurement.Center.Y = center.y / _mapHeight;
+
+	cv::Point2f footprintPoints[4];
+	contour.GetMinAreaRect().points(footprintPoints);
+	for (int i = 0; i < 4; i++)
+	{
+		measurement.Footprint[i].X = footprintPoints[i].x / _mapWidth;
+		measurement.Footprint[i].Y = footprintPoints[i].y / _mapHeight;
+	}
 
-	return twoDimDescription;
+	return true;
 }
 
 const bool DepthMapProcessor::IsObjectInZone(const std::vector<DepthValue>& contour) const
 {
+	if (_calibration == nullptr)
+		return false;
+
 	for (int i = 0; i < contour.size(); i++)
 	{
-		if (DmUtils::IsPointInZone(contour[i], _measurementVolume))
+		if (DmUtils::IsPointInZone(contour[i], _calibration->Volume))
 			return true;
 	}
 
 	return false;
 }
 
-void DepthMapProcessor::UpdateMeasurementVolume(const int mapWidth, const int mapHeight)
+const short DepthMapProcessor::GetFloorDepthUnderContour(const ContourGeometry& contour) const
+{
+	if (contour.IsEmpty() || _calibration == nullptr)
+		return _floorDepth;
+
+	const cv::Rect& boundingRect = contour.GetBoundingRect();
+	const int centerX = std::min(std::max(boundingRect.x + boundingRect.width / 2, 0), _mapWidth - 1);
+	const int centerY = std::min(std::max(boundingRect.y + boundingRect.height / 2, 0), _mapHeight - 1);
+
+	return _calibration->FloorDepths[centerY * _mapWidth + centerX];
+}
+
+const CalibrationSettings DepthMapProcessor::GetCalibrationSettings(const int mapWidth, const int mapHeight) const
+{
+	CalibrationSettings settings;
+	settings.DepthIntrinsics = _depthIntrinsics;
+	settings.MapWidth = mapWidth;
+	settings.MapHeight = mapHeight;
+	settings.FloorDepth = _floorDepth;
+	settings.CutOffDepth = _cutOffDepth;
+	settings.FloorPlane = _floorPlane;
+	settings.PolygonPoints = _polygonPoints;
+
+	return settings;
+}
+
+const bool DepthMapProcessor::IsSceneEmpty(const DepthMap& depthMap)
+{
+	TRACE_SCOPE("DepthMapProcessor::IsSceneEmpty");
+
+	// the calibration is bound to the buffers' resolution, frames of a new resolution take the full path
+	const bool resolutionIsKnown = depthMap.Width == _mapWidth && depthMap.Height == _mapHeight && _mapLength > 0;
+	if (!resolutionIsKnown)
+		return false;
+
+	UpdateCalibration();
+
+	return !DmUtils::IsZoneOccupied(_mapWidth, _mapHeight, depthMap.Data, *_calibration, _depthIntrinsics,
+		_occupancyProbeStride);
+}
+
+void DepthMapProcessor::StartCalibrationUpdate()
+{
+	_needToUpdateCalibration = true;
+
+	// until the first frame comes the map is assumed to be centered on the principal point,
+	// a wrong guess only leaves the build to the first frame
+	const bool resolutionIsKnown = _mapWidth > 0 && _mapHeight > 0;
+	const int mapWidth = resolutionIsKnown ? _mapWidth : (int)std::lround(_depthIntrinsics.PrincipalPointX * 2);
+	const int mapHeight = resolutionIsKnown ? _mapHeight : (int)std::lround(_depthIntrinsics.PrincipalPointY * 2);
+	if (mapWidth <= 0 || mapHeight <= 0)
+		return;
+
+	// a build that is still running is left to finish on its own, replacing its future would wait for it
+	if (_pendingCalibration.valid())
+		_abandonedCalibrations.emplace_back(std::move(_pendingCalibration));
+	ReleaseAbandonedCalibrations(false);
+
+	const CalibrationSettings& settings = GetCalibrationSettings(mapWidth, mapHeight);
+	const std::string cacheDirectory = _calibrationCacheDirectory;
+
+	_pendingCalibrationKey = CalibrationUtils::GetCalibrationKey(settings);
+	_pendingCalibration = std::async(std::launch::async, [settings, cacheDirectory]()
+	{
+		TRACE_SCOPE("CalibrationUtils::LoadOrBuildCalibration");
+
+		return CalibrationUtils::LoadOrBuildCalibration(settings, cacheDirectory);
+	});
+}
+
+void DepthMapProcessor::UpdateCalibration()
 {
-	_measurementVolume.largerDepthValue = _floorDepth;
-	_measurementVolume.smallerDepthValue = 600;
+	TRACE_SCOPE("DepthMapProcessor::UpdateCalibration");
+
+	if (!_needToUpdateCalibration && _calibration != nullptr &&
+		_calibration->MapWidth == _mapWidth && _calibration->MapHeight == _mapHeight)
+		return;
 
-	_measurementVolume.Points.clear();
-	_measurementVolume.Points.reserve(_polygonPoints.size());
+	const CalibrationSettings& settings = GetCalibrationSettings(_mapWidth, _mapHeight);
+	const unsigned long long key = CalibrationUtils::GetCalibrationKey(settings);
 
-	for (int i = 0; i < _polygonPoints.size(); i++)
+	// a build for a resolution that the frames do not have is left to finish on its own instead of being waited for
+	if (_pendingCalibration.valid())
 	{
-		cv::Point point((int)(_polygonPoints[i].x * mapWidth), (int)(_polygonPoints[i].y * mapHeight));
-		const int x0World = (int)((point.x + 1 - _depthIntrinsics.PrincipalPointX) * (_floorDepth + 50) / _depthIntrinsics.FocalLengthX);
-		const int y0World = (int)(-(point.y + 1 - _depthIntrinsics.PrincipalPointY) * (_floorDepth + 50) / _depthIntrinsics.FocalLengthY);
-		_measurementVolume.Points.emplace_back(cv::Point(x0World, y0World));
+		if (_pendingCalibrationKey == key)
+			_calibration = _pendingCalibration.get();
+		else
+			_abandonedCalibrations.emplace_back(std::move(_pendingCalibration));
+		ReleaseAbandonedCalibrations(false);
 	}
 
-	const int width = abs(_measurementVolume.Points[3].x - _measurementVolume.Points[0].x);
-	const int height = abs(_measurementVolume.Points[0].y - _measurementVolume.Points[1].y);
+	if (_calibration == nullptr || _calibration->Key != key)
+		_calibration = CalibrationUtils::LoadOrBuildCalibration(settings, _calibrationCacheDirectory);
+
+	_needToUpdateCalibration = false;
 }
+
+void DepthMapProcessor::ReleaseAbandonedCalibrations(const bool waitForBuilds)
+{
+	auto buildIsDone = [waitForBuilds](std::future<std::shared_ptr<const CalibrationState>>& build)
+	{
+		if (waitForBuilds)
+			build.wait();
+
+		return build.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
+
+	_abandonedCalibrations.erase(std::remove_if(_abandonedCalibrations.begin(), _abandonedCalibrations.end(), buildIsDone),
+		_abandonedCalibrations.end());
+}
\ No newline at end of file
@@ -1,8 +1,18 @@
 #pragma once
 
+#include <future>
+#include <memory>
 #include "Structures.h"
 #include "OpenCVInclude.h"
 #include "ContourExtractor.h"
+#include "ContourGeometry.h"
+#include "DebugImageWriter.h"
+#include "DepthColorRegistration.h"
+#include "DepthDenoiser.h"
+#include "LumaConverter.h"
+#include "ColorBackgroundModel.h"
+#include "ObjectTracker.h"
+#include "ZoneFilter.h"
 
 class DepthMapProcessor
 {
@@ -13,12 +23,32 @@ private:
 	const short _maxObjHeightForRgb = 300; // objects with height of 300mm and less are ok for rgb calculation
 	const short _contourPlaneDepthDeltaForDm2 = 100; // if object is taller than 100mm - use dm2, dm1 - otherwise
 
+	const float _colorSearchMarginRatio = 0.15f; // margin around the projected depth object, relative to its size
+	const int _minColorSearchMargin = 16;
+	const float _minColorSearchObjectAreaRatio = 0.005f; // smaller depth objects, relative to the map, do not narrow the search
+
+	// the empty scene check probes every 4th pixel of every 4th row, so it is guaranteed to see any object
+	// covering a 4x4 pixel square of the depth map, about 4 * depth / focal length mm on a side
+	// (16mm at 1.5m for a 367px focal length)
+	const int _occupancyProbeStride = 4;
+
+	const int _maxMeasuredObjectCount = 32;
+	const int _zoneEdgeMargin = 3; // an object closer than this to the zone's edge may be cut by it
+
 	ContourExtractor _contourExtractor;
+	DepthColorRegistration _depthColorRegistration;
+	ColorBackgroundModel _colorBackgroundModel;
+	ColorSegmentationMode _colorSegmentationMode;
+	ObjectTracker _objectTracker;
+	DepthDenoiser _depthDenoiser;
+	bool _denoiseDepth;
+	ZoneFilter _zoneFilter;
+	LumaConverter _lumaConverter;
 
 	int _colorImageWidth;
 	int _colorImageHeight;
 	int _colorImageBytesPerPixel;
-	int _colorImageLengthBytes;
+	int _colorImageCvType;
 	int _mapWidth;
 	int _mapHeight;
 	int _mapLength;
@@ -29,18 +59,49 @@ private:
 	RelRect _colorRoiRect;
 
 	std::string _debugDirectory;
+	std::unique_ptr<DebugImageWriter> _debugImageWriter;
+	std::string _calibrationCacheDirectory;
 
 	short* _depthMapBuffer;
-	DepthValue* _worldDepthValuesBuffer;
 	byte* _depthMaskBuffer;
-	byte* _colorImageBuffer;
+	// the caller's color image is read in place, it is only valid during the call that set it
+	byte* _colorImageData;
+
+	// with decimation the object is found on a reduced map first, and only the rect around it is filtered at full resolution
+	int _depthDecimationFactor;
+	DepthDecimationFilter _depthDecimationFilter;
+	int _decimatedMapWidth;
+	int _decimatedMapHeight;
+	std::vector<byte> _decimatedMaskBuffer;
+	cv::Rect _depthRefinementRect;
 
 	int _sortedNonZeroMapValuesCount;
 	short* _sortedNonZeroMapValuesBuffer;
 
+	// SelectAlgorithm and CalculateObjectVolume are usually called on the same frame one after the other, so the
+	// analysis of the frame the buffers were last prepared from is kept and reused while the frame's data stays the same;
+	// the parts that not every caller needs are computed on first use. Settings changes drop the analysis.
+	struct FrameAnalysis
+	{
+		bool IsValid;
+		unsigned long long DepthHash;
+		unsigned long long ColorHash;
+		ContourGeometry DepthContour;
+		bool HasColorContour;
+		ContourGeometry ColorContour;
+		bool HasDepthPlanes;
+		ContourPlanes DepthPlanes;
+	};
+
+	FrameAnalysis _frameAnalysis;
+
 	std::vector<cv::Point2f> _polygonPoints;
-	MeasurementVolume _measurementVolume;
-	bool _needToUpdateMeasurementVolume;
+	FloorPlane _floorPlane;
+	std::shared_ptr<const CalibrationState> _calibration;
+	std::future<std::shared_ptr<const CalibrationState>> _pendingCalibration;
+	unsigned long long _pendingCalibrationKey;
+	std::vector<std::future<std::shared_ptr<const CalibrationState>>> _abandonedCalibrations; // outdated builds still running
+	bool _needToUpdateCalibration;
 
 public:
 	DepthMapProcessor(CameraIntrinsics colorIntrinsics, CameraIntrinsics depthIntrinsics);
@@ -48,25 +109,51 @@ public:
 
 	void SetAlgorithmSettings(const short floorDepth, const short cutOffDepth, 
 		const RelPoint* polygonPoints, const int polygonPointCount, const RelRect& roiRect);
+	void SetFloorPlane(const FloorPlane& plane);
+	void SetDepthToColorExtrinsics(const Extrinsics& extrinsics);
+	void SetColorSegmentationMode(const ColorSegmentationMode mode);
+	void SetDepthDecimation(const int factor, const DepthDecimationFilter filter);
+	void SetDepthDenoising(const bool enabled);
 	void SetDebugDirectory(const char* path);
+	void SetCalibrationCacheDirectory(const char* path);
 
 	NativeAlgorithmSelectionResult* SelectAlgorithm(const NativeAlgorithmSelectionData data);
 	VolumeCalculationResult* CalculateObjectVolume(const VolumeCalculationData& data);
+	MultiVolumeCalculationResult* CalculateObjectVolumes(const DepthMap& depthMap);
+	const int ProcessConveyorFrame(const DepthMap& depthMap, ConveyorMeasurement*const measurements, const int capacity);
+	void ResetConveyorTracking();
+	void SetConveyorSampleCount(const int sampleCount);
 	void PrepareBuffers(const DepthMap*const depthMap, const ColorImage*const colorImage);
 	const short CalculateFloorDepth(const DepthMap& depthMap);
+	const bool CalculateFloorPlane(const DepthMap& depthMap, FloorPlane& plane) const;
+	const bool UpdateColorBackground(const DepthMap*const depthMap, const ColorImage*const colorImage);
+	void ResetColorBackground();
 
 private:
-	void FillColorBufferFromImage(const ColorImage* image);
-	void FillDepthBufferFromDepthMap(const DepthMap* depthMap);
-	const Contour GetTargetContourFromDepthMap() const;
-	const Contour GetTargetContourFromColorImage(const char* debugPath = "") const;
-	const TwoDimDescription Calculate2DContourDimensions(const Contour& depthObjectContour,
-		const Contour& colorObjectContour, const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth) const;
-	const cv::RotatedRect CalculateObjectBoundingRect(const Contour& depthObjectContour, const Contour& colorObjectContour,
+	void AnalyzeFrame(const DepthMap*const depthMap, const ColorImage*const colorImage);
+	const ContourGeometry& GetFrameColorContour(const char* debugPath = "");
+	const ContourPlanes& GetFrameDepthPlanes();
+	void InvalidateFrameAnalysis();
+	void PrepareDepthBuffer(const DepthMap*const depthMap);
+	void PrepareDecimatedDepthBuffer(const DepthMap*const depthMap);
+	void SetColorImage(const ColorImage* image);
+	void AllocateDepthBuffers(const int newWidth, const int newHeight);
+	const ContourGeometry GetTargetContourFromDepthMap() const;
+	const ContourGeometry GetTargetContourFromColorImage(const ContourGeometry& depthObjectContour, const char* debugPath = "");
+	const Contour ExtractContourFromColorImage(const cv::Mat& image, const cv::Rect& searchRect, const char* debugPath);
+	const cv::Rect GetColorSearchRect(const ContourGeometry& depthObjectContour, const cv::Rect& roi) const;
+	const TwoDimDescription Calculate2DContourDimensions(const ContourGeometry& depthObjectContour,
+		const ContourGeometry& colorObjectContour, const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth) const;
+	void WriteContourDebugImages(const ContourGeometry& depthObjectContour, const ContourGeometry& colorObjectContour,
 		const AlgorithmSelectionStatus selectedAlgorithm, const short contourTopPlaneDepth, const char* debugPath = "") const;
-	const ContourPlanes GetDepthContourPlanes(const Contour& contour);
-	const TwoDimDescription GetTwoDimDescription(const cv::RotatedRect& contourBoundingRect,
-		const CameraIntrinsics& intristics, const short contourTopPlaneDepth) const;
+	const ContourPlanes GetDepthContourPlanes(const ContourGeometry& contour);
+	const bool IsContourClearOfZoneEdge(const Contour& contour) const;
+	const bool MeasureDepthObject(const ContourGeometry& contour, const short*const unfilteredDepthData, ObjectMeasurement& measurement);
 	const bool IsObjectInZone(const std::vector<DepthValue>& contour) const;
-	void UpdateMeasurementVolume(const int mapWidth, const int mapHeight);
+	const short GetFloorDepthUnderContour(const ContourGeometry& contour) const;
+	const CalibrationSettings GetCalibrationSettings(const int mapWidth, const int mapHeight) const;
+	const bool IsSceneEmpty(const DepthMap& depthMap);
+	void StartCalibrationUpdate();
+	void UpdateCalibration();
+	void ReleaseAbandonedCalibrations(const bool waitForBuilds);
 };
\ No newline at end of file
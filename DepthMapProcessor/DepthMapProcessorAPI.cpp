@@ -1,5 +1,10 @@
 #include "DepthMapProcessorAPI.h"
 #include "DepthMapProcessor.h"
+#include "DepthMapCodec.h"
+#include "DepthPreviewRenderer.h"
+#include "LatencyTracker.h"
+#include "SampleAggregator.h"
+#include "TraceRecorder.h"
 
 DLL_EXPORT DepthMapProcessor* CreateDepthMapProcessor(CameraIntrinsics colorIntrinsics, CameraIntrinsics depthIntrinsics)
 {
@@ -12,14 +17,55 @@ DLL_EXPORT void SetAlgorithmSettings(DepthMapProcessor* processor, short floorDe
 	processor->SetAlgorithmSettings(floorDepth, cutOffDepth, polygonPoints, polygonPointCount, colorRoiRect);
 }
 
+DLL_EXPORT void SetDepthToColorExtrinsics(DepthMapProcessor* processor, Extrinsics extrinsics)
+{
+	processor->SetDepthToColorExtrinsics(extrinsics);
+}
+
+DLL_EXPORT void SetColorSegmentationMode(DepthMapProcessor* processor, int mode)
+{
+	processor->SetColorSegmentationMode((ColorSegmentationMode)mode);
+}
+
+DLL_EXPORT int UpdateColorBackground(DepthMapProcessor* processor, DepthMap depthMap, ColorImage colorImage)
+{
+	return processor->UpdateColorBackground(&depthMap, &colorImage) ? 1 : 0;
+}
+
+DLL_EXPORT void ResetColorBackground(DepthMapProcessor* processor)
+{
+	processor->ResetColorBackground();
+}
+
+DLL_EXPORT void SetDepthDecimation(DepthMapProcessor* processor, int factor, int filter)
+{
+	processor->SetDepthDecimation(factor, (DepthDecimationFilter)filter);
+}
+
+DLL_EXPORT void SetDepthDenoising(DepthMapProcessor* processor, int enabled)
+{
+	processor->SetDepthDenoising(enabled != 0);
+}
+
 DLL_EXPORT void SetDebugDirectory(DepthMapProcessor* processor, const char* path)
 {
 	processor->SetDebugDirectory(path);
 }
 
+DLL_EXPORT void SetCalibrationCacheDirectory(DepthMapProcessor* processor, const char* path)
+{
+	processor->SetCalibrationCacheDirectory(path);
+}
+
 DLL_EXPORT VolumeCalculationResult* CalculateObjectVolume(DepthMapProcessor* processor, VolumeCalculationData calculationData)
 {
-	return processor->CalculateObjectVolume(calculationData);
+	const long long processingStartUs = LatencyTracker::GetTimestampUs();
+	LatencyTracker::RecordProcessingStart(calculationData.Timing, processingStartUs);
+
+	VolumeCalculationResult* result = processor->CalculateObjectVolume(calculationData);
+	LatencyTracker::Record(LatencyStage::ProcessingToResult, LatencyTracker::GetTimestampUs() - processingStartUs);
+
+	return result;
 }
 
 void DisposeCalculationResult(VolumeCalculationResult* result)
@@ -31,6 +77,36 @@ void DisposeCalculationResult(VolumeCalculationResult* result)
 	}
 }
 
+DLL_EXPORT MultiVolumeCalculationResult* CalculateObjectVolumes(DepthMapProcessor* processor, DepthMap depthMap)
+{
+	return processor->CalculateObjectVolumes(depthMap);
+}
+
+void DisposeMultiVolumeCalculationResult(MultiVolumeCalculationResult* result)
+{
+	if (result)
+	{
+		delete[] result->Objects;
+		delete result;
+		result = 0;
+	}
+}
+
+DLL_EXPORT int ProcessConveyorFrame(DepthMapProcessor* processor, DepthMap depthMap, ConveyorMeasurement* measurements, int capacity)
+{
+	return processor->ProcessConveyorFrame(depthMap, measurements, capacity);
+}
+
+DLL_EXPORT void ResetConveyorTracking(DepthMapProcessor* processor)
+{
+	processor->ResetConveyorTracking();
+}
+
+DLL_EXPORT void SetConveyorSampleCount(DepthMapProcessor* processor, int sampleCount)
+{
+	processor->SetConveyorSampleCount(sampleCount);
+}
+
 DLL_EXPORT short CalculateFloorDepth(DepthMapProcessor* processor, DepthMap depthMap)
 {
 	if (depthMap.Data == nullptr)
@@ -39,12 +115,25 @@ DLL_EXPORT short CalculateFloorDepth(DepthMapProcessor* processor, DepthMap dept
 	return processor->CalculateFloorDepth(depthMap);
 }
 
+DLL_EXPORT int CalculateFloorPlane(DepthMapProcessor* processor, DepthMap depthMap, FloorPlane* plane)
+{
+	if (depthMap.Data == nullptr || plane == nullptr)
+		return 0;
+
+	return processor->CalculateFloorPlane(depthMap, *plane) ? 1 : 0;
+}
+
+DLL_EXPORT void SetFloorPlane(DepthMapProcessor* processor, FloorPlane plane)
+{
+	processor->SetFloorPlane(plane);
+}
+
 DLL_EXPORT NativeAlgorithmSelectionResult* SelectAlgorithm(DepthMapProcessor* processor, NativeAlgorithmSelectionData data)
 {
 	return processor->SelectAlgorithm(data);
 }
 
-void DisposeAlgorithmSelectionResult(VolumeCalculationResult* result)
+void DisposeAlgorithmSelectionResult(NativeAlgorithmSelectionResult* result)
 {
 	if (result)
 	{
@@ -58,3 +147,158 @@ DLL_EXPORT void DestroyDepthMapProcessor(DepthMapProcessor* processor)
 	delete processor;
 	processor = nullptr;
 }
+
+DLL_EXPORT void SetTracingEnabled(int enabled)
+{
+	TraceRecorder::SetEnabled(enabled != 0);
+}
+
+DLL_EXPORT int WriteTrace(const char* filepath)
+{
+	if (filepath == nullptr)
+		return 0;
+
+	return TraceRecorder::WriteTrace(filepath) ? 1 : 0;
+}
+
+DLL_EXPORT int GetLatencyStats(int stage, LatencyStats* stats)
+{
+	if (stats == nullptr)
+		return 0;
+
+	return LatencyTracker::GetStats((LatencyStage)stage, *stats) ? 1 : 0;
+}
+
+DLL_EXPORT void ResetLatencyStats()
+{
+	LatencyTracker::Reset();
+}
+
+DLL_EXPORT int GetMaxEncodedDepthMapLength(int width, int height)
+{
+	return DepthMapEncoder::GetMaxEncodedLength(width, height);
+}
+
+DLL_EXPORT int EncodeDepthMap(DepthMap depthMap, byte* output, int outputCapacity)
+{
+	if (depthMap.Data == nullptr || output == nullptr)
+		return -1;
+
+	const int headerLength = DepthMapEncoder::WriteHeader(depthMap.Width, depthMap.Height, output, outputCapacity);
+	if (headerLength < 0)
+		return -1;
+
+	DepthMapEncoder encoder(depthMap.Width, depthMap.Height);
+	const int dataLength = encoder.EncodeRows(depthMap.Data, depthMap.Height, output + headerLength, outputCapacity - headerLength);
+	if (dataLength < 0)
+		return -1;
+
+	return headerLength + dataLength;
+}
+
+DLL_EXPORT int ReadEncodedDepthMapHeader(const byte* input, int inputLength, int* width, int* height)
+{
+	return DepthMapDecoder::ReadHeader(input, inputLength, *width, *height);
+}
+
+DLL_EXPORT int DecodeDepthMap(const byte* input, int inputLength, DepthMap depthMap)
+{
+	if (depthMap.Data == nullptr)
+		return -1;
+
+	int width = 0;
+	int height = 0;
+	const int headerLength = DepthMapDecoder::ReadHeader(input, inputLength, width, height);
+	if (headerLength < 0 || width != depthMap.Width || height != depthMap.Height)
+		return -1;
+
+	DepthMapDecoder decoder(width, height);
+	const int dataLength = decoder.DecodeRows(input + headerLength, inputLength - headerLength, depthMap.Data, height);
+	if (dataLength < 0)
+		return -1;
+
+	return headerLength + dataLength;
+}
+
+DLL_EXPORT DepthMapEncoder* CreateDepthMapEncoder(int width, int height)
+{
+	return new DepthMapEncoder(width, height);
+}
+
+DLL_EXPORT int WriteEncodedDepthMapHeader(int width, int height, byte* output, int outputCapacity)
+{
+	return DepthMapEncoder::WriteHeader(width, height, output, outputCapacity);
+}
+
+DLL_EXPORT int EncodeDepthMapRows(DepthMapEncoder* encoder, const short* rows, int rowCount, byte* output, int outputCapacity)
+{
+	return encoder->EncodeRows(rows, rowCount, output, outputCapacity);
+}
+
+DLL_EXPORT void DestroyDepthMapEncoder(DepthMapEncoder* encoder)
+{
+	delete encoder;
+	encoder = nullptr;
+}
+
+DLL_EXPORT DepthMapDecoder* CreateDepthMapDecoder(int width, int height)
+{
+	return new DepthMapDecoder(width, height);
+}
+
+DLL_EXPORT int DecodeDepthMapRows(DepthMapDecoder* decoder, const byte* input, int inputLength, short* rows, int rowCount)
+{
+	return decoder->DecodeRows(input, inputLength, rows, rowCount);
+}
+
+DLL_EXPORT void DestroyDepthMapDecoder(DepthMapDecoder* decoder)
+{
+	delete decoder;
+	decoder = nullptr;
+}
+
+DLL_EXPORT DepthPreviewRenderer* CreateDepthPreviewRenderer(int previewWidth, int previewHeight, int palette)
+{
+	return new DepthPreviewRenderer(previewWidth, previewHeight, (PreviewPalette)palette);
+}
+
+DLL_EXPORT void SetPreviewDepthRange(DepthPreviewRenderer* renderer, short minDepth, short maxDepth, short cutOffDepth)
+{
+	renderer->SetDepthRange(minDepth, maxDepth, cutOffDepth);
+}
+
+DLL_EXPORT int RenderDepthPreview(DepthPreviewRenderer* renderer, DepthMap depthMap, const RelPoint* contourPoints,
+	int contourPointCount, byte* output, int outputCapacity)
+{
+	if (!renderer->Render(depthMap, contourPoints, contourPointCount, output, outputCapacity))
+		return -1;
+
+	return renderer->GetPreviewLength();
+}
+
+DLL_EXPORT void DestroyDepthPreviewRenderer(DepthPreviewRenderer* renderer)
+{
+	delete renderer;
+	renderer = nullptr;
+}
+
+DLL_EXPORT SampleAggregator* CreateSampleAggregator(int minSampleCount, int maxSampleCount, int toleranceMm)
+{
+	return new SampleAggregator(minSampleCount, maxSampleCount, toleranceMm);
+}
+
+DLL_EXPORT void AddAggregatedSample(SampleAggregator* aggregator, VolumeCalculationResult sample, SampleAggregate* aggregate)
+{
+	*aggregate = aggregator->AddSample(sample);
+}
+
+DLL_EXPORT void ResetSampleAggregator(SampleAggregator* aggregator)
+{
+	aggregator->Reset();
+}
+
+DLL_EXPORT void DestroySampleAggregator(SampleAggregator* aggregator)
+{
+	delete aggregator;
+	aggregator = nullptr;
+}
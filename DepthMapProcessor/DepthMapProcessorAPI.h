@@ -5,20 +5,76 @@
 #define DLL_EXPORT extern "C" _declspec(dllexport)
 
 class DepthMapProcessor;
+class DepthMapEncoder;
+class DepthMapDecoder;
+class DepthPreviewRenderer;
+class SampleAggregator;
 
 DLL_EXPORT DepthMapProcessor* CreateDepthMapProcessor(CameraIntrinsics colorIntrinsics, CameraIntrinsics depthIntrinsics);
 
 DLL_EXPORT void SetAlgorithmSettings(DepthMapProcessor* processor, short floorDepth, short cutOffDepth,
 	RelPoint* polygonPoints, int polygonPointCount, RelRect colorRoiRect);
 
+DLL_EXPORT void SetDepthToColorExtrinsics(DepthMapProcessor* processor, Extrinsics extrinsics);
+
+DLL_EXPORT void SetColorSegmentationMode(DepthMapProcessor* processor, int mode);
+DLL_EXPORT int UpdateColorBackground(DepthMapProcessor* processor, DepthMap depthMap, ColorImage colorImage);
+DLL_EXPORT void ResetColorBackground(DepthMapProcessor* processor);
+
+DLL_EXPORT void SetDepthDecimation(DepthMapProcessor* processor, int factor, int filter);
+DLL_EXPORT void SetDepthDenoising(DepthMapProcessor* processor, int enabled);
+
 DLL_EXPORT void SetDebugDirectory(DepthMapProcessor* processor, const char* path);
 
+DLL_EXPORT void SetCalibrationCacheDirectory(DepthMapProcessor* processor, const char* path);
+
 DLL_EXPORT NativeAlgorithmSelectionResult* SelectAlgorithm(DepthMapProcessor* processor, NativeAlgorithmSelectionData data);
-DLL_EXPORT void DisposeAlgorithmSelectionResult(VolumeCalculationResult* result);
+DLL_EXPORT void DisposeAlgorithmSelectionResult(NativeAlgorithmSelectionResult* result);
 
 DLL_EXPORT VolumeCalculationResult* CalculateObjectVolume(DepthMapProcessor* processor, VolumeCalculationData data);
 DLL_EXPORT void DisposeCalculationResult(VolumeCalculationResult* result);
 
+DLL_EXPORT MultiVolumeCalculationResult* CalculateObjectVolumes(DepthMapProcessor* processor, DepthMap depthMap);
+DLL_EXPORT void DisposeMultiVolumeCalculationResult(MultiVolumeCalculationResult* result);
+
+DLL_EXPORT int ProcessConveyorFrame(DepthMapProcessor* processor, DepthMap depthMap, ConveyorMeasurement* measurements, int capacity);
+DLL_EXPORT void ResetConveyorTracking(DepthMapProcessor* processor);
+DLL_EXPORT void SetConveyorSampleCount(DepthMapProcessor* processor, int sampleCount);
+
 DLL_EXPORT short CalculateFloorDepth(DepthMapProcessor* processor, DepthMap depthMap);
 
+DLL_EXPORT int CalculateFloorPlane(DepthMapProcessor* processor, DepthMap depthMap, FloorPlane* plane);
+DLL_EXPORT void SetFloorPlane(DepthMapProcessor* processor, FloorPlane plane);
+
 DLL_EXPORT void DestroyDepthMapProcessor(DepthMapProcessor* processor);
+
+DLL_EXPORT void SetTracingEnabled(int enabled);
+DLL_EXPORT int WriteTrace(const char* filepath);
+
+DLL_EXPORT int GetLatencyStats(int stage, LatencyStats* stats);
+DLL_EXPORT void ResetLatencyStats();
+
+DLL_EXPORT int GetMaxEncodedDepthMapLength(int width, int height);
+DLL_EXPORT int EncodeDepthMap(DepthMap depthMap, byte* output, int outputCapacity);
+DLL_EXPORT int ReadEncodedDepthMapHeader(const byte* input, int inputLength, int* width, int* height);
+DLL_EXPORT int DecodeDepthMap(const byte* input, int inputLength, DepthMap depthMap);
+
+DLL_EXPORT DepthMapEncoder* CreateDepthMapEncoder(int width, int height);
+DLL_EXPORT int WriteEncodedDepthMapHeader(int width, int height, byte* output, int outputCapacity);
+DLL_EXPORT int EncodeDepthMapRows(DepthMapEncoder* encoder, const short* rows, int rowCount, byte* output, int outputCapacity);
+DLL_EXPORT void DestroyDepthMapEncoder(DepthMapEncoder* encoder);
+
+DLL_EXPORT DepthMapDecoder* CreateDepthMapDecoder(int width, int height);
+DLL_EXPORT int DecodeDepthMapRows(DepthMapDecoder* decoder, const byte* input, int inputLength, short* rows, int rowCount);
+DLL_EXPORT void DestroyDepthMapDecoder(DepthMapDecoder* decoder);
+
+DLL_EXPORT DepthPreviewRenderer* CreateDepthPreviewRenderer(int previewWidth, int previewHeight, int palette);
+DLL_EXPORT void SetPreviewDepthRange(DepthPreviewRenderer* renderer, short minDepth, short maxDepth, short cutOffDepth);
+DLL_EXPORT int RenderDepthPreview(DepthPreviewRenderer* renderer, DepthMap depthMap, const RelPoint* contourPoints,
+	int contourPointCount, byte* output, int outputCapacity);
+DLL_EXPORT void DestroyDepthPreviewRenderer(DepthPreviewRenderer* renderer);
+
+DLL_EXPORT SampleAggregator* CreateSampleAggregator(int minSampleCount, int maxSampleCount, int toleranceMm);
+DLL_EXPORT void AddAggregatedSample(SampleAggregator* aggregator, VolumeCalculationResult sample, SampleAggregate* aggregate);
+DLL_EXPORT void ResetSampleAggregator(SampleAggregator* aggregator);
+DLL_EXPORT void DestroySampleAggregator(SampleAggregator* aggregator);
@@ -0,0 +1,164 @@
+#include "DepthPreviewRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+DepthPreviewRenderer::DepthPreviewRenderer(const int previewWidth, const int previewHeight, const PreviewPalette palette)
+	: _previewWidth(std::max(previewWidth, 1)), _previewHeight(std::max(previewHeight, 1)), _palette(palette),
+	_bytesPerPixel(palette == PreviewPalette::Color ? 3 : 1)
+{
+	_minDepth = 0;
+	_maxDepth = 0;
+	_cutOffDepth = 0;
+	_maxLutDepth = -1;
+
+	_sourceWidth = 0;
+	_sourceHeight = 0;
+
+	UpdateDepthLut();
+}
+
+void DepthPreviewRenderer::SetDepthRange(const short minDepth, const short maxDepth, const short cutOffDepth)
+{
+	const bool rangeIsTheSame = _minDepth == minDepth && _maxDepth == maxDepth && _cutOffDepth == cutOffDepth;
+	if (rangeIsTheSame)
+		return;
+
+	_minDepth = minDepth;
+	_maxDepth = maxDepth;
+	_cutOffDepth = cutOffDepth;
+
+	UpdateDepthLut();
+}
+
+const int DepthPreviewRenderer::GetPreviewLength() const
+{
+	return _previewWidth * _previewHeight * _bytesPerPixel;
+}
+
+const bool DepthPreviewRenderer::Render(const DepthMap& depthMap, const RelPoint*const contourPoints,
+	const int contourPointCount, byte*const output, const int outputCapacity)
+{
+	const bool mapIsValid = depthMap.Data != nullptr && depthMap.Width > 0 && depthMap.Height > 0;
+	if (!mapIsValid || output == nullptr || outputCapacity < GetPreviewLength())
+		return false;
+
+	UpdateSourceOffsets(depthMap.Width, depthMap.Height);
+
+	// negative depths turn into large unsigned values and land on the black entry with everything out of range
+	const unsigned int lutDepthCount = (unsigned int)(_maxLutDepth + 1);
+	const byte*const depthLut = _depthLut.data();
+	const int*const sourceColumns = _sourceColumns.data();
+
+	for (int j = 0; j < _previewHeight; j++)
+	{
+		const short*const sourceRow = depthMap.Data + _sourceRowOffsets[j];
+		byte* outputPixel = output + j * _previewWidth * _bytesPerPixel;
+
+		if (_bytesPerPixel == 1)
+		{
+			for (int i = 0; i < _previewWidth; i++)
+			{
+				const unsigned int depth = (unsigned short)sourceRow[sourceColumns[i]];
+				outputPixel[i] = depthLut[depth < lutDepthCount ? depth : lutDepthCount];
+			}
+
+			continue;
+		}
+
+		for (int i = 0; i < _previewWidth; i++)
+		{
+			const unsigned int depth = (unsigned short)sourceRow[sourceColumns[i]];
+			const byte*const color = depthLut + (depth < lutDepthCount ? depth : lutDepthCount) * 3;
+			outputPixel[0] = color[0];
+			outputPixel[1] = color[1];
+			outputPixel[2] = color[2];
+			outputPixel += 3;
+		}
+	}
+
+	if (contourPoints != nullptr && contourPointCount > 1)
+		DrawContour(contourPoints, contourPointCount, output);
+
+	return true;
+}
+
+void DepthPreviewRenderer::UpdateDepthLut()
+{
+	_maxLutDepth = std::max((int)std::min(_maxDepth, _cutOffDepth), -1);
+
+	const int lutDepthCount = _maxLutDepth + 1;
+	_depthLut.assign((lutDepthCount + 1) * _bytesPerPixel, 0);
+
+	for (int depth = 0; depth < lutDepthCount; depth++)
+	{
+		const byte intensity = GetIntensityFromDepth((short)depth, _minDepth, _maxDepth);
+
+		if (_bytesPerPixel == 1)
+			_depthLut[depth] = intensity;
+		else
+			GetPaletteColor(intensity, _depthLut.data() + depth * 3);
+	}
+}
+
+void DepthPreviewRenderer::UpdateSourceOffsets(const int sourceWidth, const int sourceHeight)
+{
+	const bool sizeIsTheSame = _sourceWidth == sourceWidth && _sourceHeight == sourceHeight;
+	if (sizeIsTheSame)
+		return;
+
+	_sourceWidth = sourceWidth;
+	_sourceHeight = sourceHeight;
+
+	// every preview pixel takes the source pixel under its center
+	_sourceColumns.resize(_previewWidth);
+	for (int i = 0; i < _previewWidth; i++)
+		_sourceColumns[i] = (int)(((long long)(2 * i + 1) * sourceWidth) / (2 * _previewWidth));
+
+	_sourceRowOffsets.resize(_previewHeight);
+	for (int j = 0; j < _previewHeight; j++)
+		_sourceRowOffsets[j] = (int)(((long long)(2 * j + 1) * sourceHeight) / (2 * _previewHeight)) * sourceWidth;
+}
+
+void DepthPreviewRenderer::DrawContour(const RelPoint*const contourPoints, const int contourPointCount,
+	byte*const output) const
+{
+	std::vector<std::vector<cv::Point>> contours(1);
+	contours[0].reserve(contourPointCount);
+	for (int i = 0; i < contourPointCount; i++)
+	{
+		const int x = (int)std::round(contourPoints[i].X * (_previewWidth - 1));
+		const int y = (int)std::round(contourPoints[i].Y * (_previewHeight - 1));
+		contours[0].emplace_back(cv::Point(x, y));
+	}
+
+	cv::Mat preview(_previewHeight, _previewWidth, CV_8UC(_bytesPerPixel), output);
+	cv::polylines(preview, contours, true, cv::Scalar::all(255));
+}
+
+const byte DepthPreviewRenderer::GetIntensityFromDepth(const short depth, const short minDepth, const short maxDepth)
+{
+	if (depth < minDepth || depth > maxDepth || maxDepth == 0)
+		return 0;
+
+	return (byte)(255 - 255 * (depth - minDepth) / maxDepth);
+}
+
+void DepthPreviewRenderer::GetPaletteColor(const byte intensity, byte*const color)
+{
+	// empty pixels stay black, the rest goes from blue (far) to red (near)
+	if (intensity == 0)
+	{
+		memset(color, 0, 3);
+		return;
+	}
+
+	const float t = intensity / 255.0f;
+	const float red = 1.5f - std::abs(4 * t - 3);
+	const float green = 1.5f - std::abs(4 * t - 2);
+	const float blue = 1.5f - std::abs(4 * t - 1);
+
+	color[0] = (byte)(std::min(std::max(red, 0.0f), 1.0f) * 255);
+	color[1] = (byte)(std::min(std::max(green, 0.0f), 1.0f) * 255);
+	color[2] = (byte)(std::min(std::max(blue, 0.0f), 1.0f) * 255);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// renders depth maps into preview images through a lookup table, grayscale matches DepthMapUtils
+class DepthPreviewRenderer
+{
+private:
+	const int _previewWidth;
+	const int _previewHeight;
+	const PreviewPalette _palette;
+	const int _bytesPerPixel;
+
+	short _minDepth;
+	short _maxDepth;
+	short _cutOffDepth;
+	// one entry per renderable depth value and a trailing black entry for everything else
+	std::vector<byte> _depthLut;
+	int _maxLutDepth;
+
+	int _sourceWidth;
+	int _sourceHeight;
+	std::vector<int> _sourceColumns;
+	std::vector<int> _sourceRowOffsets;
+
+public:
+	DepthPreviewRenderer(const int previewWidth, const int previewHeight, const PreviewPalette palette);
+
+	void SetDepthRange(const short minDepth, const short maxDepth, const short cutOffDepth);
+	const int GetPreviewLength() const;
+	const bool Render(const DepthMap& depthMap, const RelPoint*const contourPoints, const int contourPointCount,
+		byte*const output, const int outputCapacity);
+
+private:
+	void UpdateDepthLut();
+	void UpdateSourceOffsets(const int sourceWidth, const int sourceHeight);
+	void DrawContour(const RelPoint*const contourPoints, const int contourPointCount, byte*const output) const;
+	static const byte GetIntensityFromDepth(const short depth, const short minDepth, const short maxDepth);
+	static void GetPaletteColor(const byte intensity, byte*const color);
+};
@@ -1,12 +1,14 @@
 #include "DmUtils.h"
 #include <cmath>
 #include <climits>
+#include <cstring>
 #include <fstream>
+#include "TraceRecorder.h"
 
-const std::vector<Contour> DmUtils::GetValidContours(const std::vector<Contour>& contours, const float minAreaRatio, 
+const std::vector<ContourGeometry> DmUtils::GetValidContours(std::vector<Contour>& contours, const float minAreaRatio, 
 	const int imageDataLength)
 {
-	std::vector<Contour> contoursValid;
+	std::vector<ContourGeometry> contoursValid;
 
 	if (contours.size() == 0)
 		return contoursValid;
@@ -15,8 +17,10 @@ const std::vector<Contour> DmUtils::GetValidContours(const std::vector<Contour>&
 	const int minContourAreaPixels = (const int)(imageDataLength * minAreaRatio);
 	for (int i = 0; i < contours.size(); i++)
 	{
-		if (contourArea(contours[i]) >= minContourAreaPixels)
-			contoursValid.emplace_back(Contour(contours[i]));
+		// the area is kept with the contour, the contour itself is moved out of the found ones
+		const double area = cv::contourArea(contours[i]);
+		if (area >= minContourAreaPixels)
+			contoursValid.emplace_back(ContourGeometry(std::move(contours[i]), area));
 	}
 
 	return contoursValid;
@@ -31,33 +35,144 @@ const RelPoint DmUtils::AbsoluteToRelative(const cv::Point& abs, const int width
 	return res;
 }
 
-void DmUtils::ConvertDepthMapDataToBinaryMask(const int mapDataLength, const short*const mapData, byte*const maskData)
+void DmUtils::FilterDepthMapByMaxDepth(const int mapDataLength, short*const mapData,  const short value)
 {
 	for (int i = 0; i < mapDataLength; i++)
 	{
-		short mapValue = mapData[i];
-		maskData[i] = mapValue > 0 ? 255 : 0;
+		if (mapData[i] > value)
+			mapData[i] = 0;
 	}
 }
 
-void DmUtils::FilterDepthMapByMaxDepth(const int mapDataLength, short*const mapData,  const short value)
+void DmUtils::ConvertDepthMapToDecimatedMask(const int mapWidth, const int mapHeight, const short*const mapData,
+	const CalibrationState& calibration, const CameraIntrinsics& intrinsics, const int factor,
+	const DepthDecimationFilter filter, byte*const decimatedMask)
 {
-	for (int i = 0; i < mapDataLength; i++)
+	TRACE_SCOPE("DmUtils::ConvertDepthMapToDecimatedMask");
+
+	const int decimatedWidth = (mapWidth + factor - 1) / factor;
+	const int decimatedHeight = (mapHeight + factor - 1) / factor;
+
+	short blockDepths[MaxDepthDecimationFactor * MaxDepthDecimationFactor];
+	int blockIndices[MaxDepthDecimationFactor * MaxDepthDecimationFactor];
+	int blockOrder[MaxDepthDecimationFactor * MaxDepthDecimationFactor];
+
+	for (int blockY = 0; blockY < decimatedHeight; blockY++)
 	{
-		if (mapData[i] > value)
-			mapData[i] = 0;
+		const int top = blockY * factor;
+		const int bottom = std::min(top + factor, mapHeight);
+
+		for (int blockX = 0; blockX < decimatedWidth; blockX++)
+		{
+			const int left = blockX * factor;
+			const int right = std::min(left + factor, mapWidth);
+
+			int depthCount = 0;
+			for (int j = top; j < bottom; j++)
+			{
+				for (int i = left; i < right; i++)
+				{
+					const int index = j * mapWidth + i;
+					if (mapData[index] <= 0)
+						continue;
+
+					blockDepths[depthCount] = mapData[index];
+					blockIndices[depthCount] = index;
+					depthCount++;
+				}
+			}
+
+			// every block is reduced to one depth value, and the mask keeps whether that value is in the zone
+			const int decimatedIndex = blockY * decimatedWidth + blockX;
+			decimatedMask[decimatedIndex] = 0;
+			if (depthCount == 0)
+				continue;
+
+			// only the selected pixel is checked against the zone, which is where the decimation saves most of the work
+			int selected = 0;
+			if (filter == DepthDecimationFilter::Median)
+			{
+				for (int k = 0; k < depthCount; k++)
+					blockOrder[k] = k;
+
+				const int medianPosition = depthCount / 2;
+				std::nth_element(blockOrder, blockOrder + medianPosition, blockOrder + depthCount,
+					[&blockDepths](const int a, const int b) { return blockDepths[a] < blockDepths[b]; });
+				selected = blockOrder[medianPosition];
+			}
+			else
+			{
+				for (int k = 1; k < depthCount; k++)
+				{
+					if (blockDepths[k] < blockDepths[selected])
+						selected = k;
+				}
+			}
+
+			const int index = blockIndices[selected];
+			if (IsDepthInCalibratedZone(index % mapWidth, index / mapWidth, index, blockDepths[selected], calibration, intrinsics))
+				decimatedMask[decimatedIndex] = 255;
+		}
 	}
 }
 
-void DmUtils::FilterDepthMapByMeasurementVolume(const int mapLength, short*const mapData, DepthValue*const worldDepthValues, 
-	const MeasurementVolume& volume)
+void DmUtils::FilterDepthMapRegionByCalibration(const int mapWidth, const cv::Rect& region, const short*const sourceData,
+	short*const mapData, byte*const maskData, const CalibrationState& calibration, const CameraIntrinsics& intrinsics)
 {
-	for (int i = 0; i < mapLength; i++)
+	TRACE_SCOPE("DmUtils::FilterDepthMapRegionByCalibration");
+
+	for (int j = region.y; j < region.y + region.height; j++)
 	{
-		const bool pointIsInZone = IsPointInZone(worldDepthValues[i], volume);
-		if (!pointIsInZone)
-			mapData[i] = 0;
+		for (int i = region.x; i < region.x + region.width; i++)
+		{
+			const int index = j * mapWidth + i;
+			const short depth = sourceData[index];
+			const bool depthIsInZone = depth > 0 && IsDepthInCalibratedZone(i, j, index, depth, calibration, intrinsics);
+
+			mapData[index] = depthIsInZone ? depth : 0;
+			maskData[index] = depthIsInZone ? 255 : 0;
+		}
+	}
+}
+
+const bool DmUtils::IsZoneOccupied(const int mapWidth, const int mapHeight, const short*const mapData,
+	const CalibrationState& calibration, const CameraIntrinsics& intrinsics, const int stride)
+{
+	// every stride x stride square of the map holds exactly one probe, starting half a stride in centers them
+	const int start = stride / 2;
+
+	for (int j = start; j < mapHeight; j += stride)
+	{
+		for (int i = start; i < mapWidth; i += stride)
+		{
+			const int index = j * mapWidth + i;
+			const short depth = mapData[index];
+			if (depth == 0)
+				continue;
+
+			if (IsDepthInCalibratedZone(i, j, index, depth, calibration, intrinsics))
+				return true;
+		}
 	}
+
+	return false;
+}
+
+const bool DmUtils::IsDepthInCalibratedZone(const int x, const int y, const int index, const short depth,
+	const CalibrationState& calibration, const CameraIntrinsics& intrinsics)
+{
+	if (calibration.ZoneTable[index] != ZoneStatus::ZoneBorder)
+		return depth >= calibration.MinZoneDepths[index] && depth <= calibration.MaxZoneDepths[index];
+
+	if (depth > calibration.CutOffDepths[index])
+		return false;
+
+	DepthValue worldPoint;
+	worldPoint.Value = depth;
+	worldPoint.XWorld = (int)((x + 1 - intrinsics.PrincipalPointX) * depth / intrinsics.FocalLengthX);
+	worldPoint.YWorld = (int)(-(y + 1 - intrinsics.PrincipalPointY) * depth / intrinsics.FocalLengthY);
+
+	return IsPointInZone(worldPoint, calibration.Volume);
 }
 
 const std::vector<short> DmUtils::GetNonZeroContourDepthValues(const DepthMap& depthMap)
@@ -80,13 +195,13 @@ const std::vector<short> DmUtils::GetNonZeroContourDepthValues(const DepthMap& d
 }
 
 const std::vector<short> DmUtils::GetNonZeroContourDepthValues(const int mapWidth, const int mapHeight, 
-	const short*const mapData, const cv::RotatedRect& roi, const Contour& contour)
+	const short*const mapData, const cv::Rect& roi, const Contour& contour)
 {
 	std::vector<short> nonZeroValues;
 	if (contour.size() == 0)
 		return nonZeroValues;
 
-	const cv::Rect& boundingRect = roi.boundingRect();
+	const cv::Rect& boundingRect = roi & cv::Rect(0, 0, mapWidth, mapHeight);
 
 	nonZeroValues.reserve(boundingRect.width * boundingRect.height);
 
@@ -134,6 +249,36 @@ const int DmUtils::GetCvChannelsCodeFromBytesPerPixel(const int bytesPerPixel)
 	}
 }
 
+const unsigned long long DmUtils::GetDataHash(const byte*const data, const int lengthBytes, const unsigned long long seed)
+{
+	TRACE_SCOPE("DmUtils::GetDataHash");
+
+	// FNV-style multiply-xor; a change of any single word always changes the hash, it is not meant to resist collisions
+	// on purpose. Four independent lanes keep the multiplications from waiting on each other.
+	const unsigned long long prime = 0x100000001B3ULL;
+	unsigned long long lanes[4] = { seed ^ 0xCBF29CE484222325ULL, seed + 1, seed + 2, seed + 3 };
+
+	const int blockLength = sizeof(lanes);
+	const int blockCount = lengthBytes / blockLength;
+	for (int i = 0; i < blockCount; i++)
+	{
+		unsigned long long words[4];
+		memcpy(words, data + i * blockLength, blockLength);
+
+		for (int k = 0; k < 4; k++)
+			lanes[k] = (lanes[k] ^ words[k]) * prime;
+	}
+
+	unsigned long long hash = lanes[0];
+	for (int k = 1; k < 4; k++)
+		hash = (hash ^ (lanes[k] >> 29) ^ (lanes[k] << 35)) * prime;
+
+	for (int i = blockCount * blockLength; i < lengthBytes; i++)
+		hash = (hash ^ data[i]) * prime;
+
+	return hash;
+}
+
 const short DmUtils::FindModeInSortedArray(const short * const array, const int count)
 {
 	if (count == 0)
@@ -205,10 +350,10 @@ bool DmUtils::IsPointInZone(const DepthValue& worldPoint, const MeasurementVolum
 	return true;
 }
 
-bool DmUtils::IsObjectInBounds(const Contour& objectContour, const int width, const int height)
+bool DmUtils::IsObjectInBounds(const ContourGeometry& objectContour, const int width, const int height)
 {
 	const int borderDistance = 3;
-	const cv::RotatedRect& colorObjectBoundingRect = cv::minAreaRect(objectContour);
+	const cv::RotatedRect& colorObjectBoundingRect = objectContour.GetMinAreaRect();
 	const bool rectLowerXIsOk = colorObjectBoundingRect.center.x > (colorObjectBoundingRect.size.width / 2 + borderDistance);
 	const bool rectUpperXIsOk = colorObjectBoundingRect.center.x < (width - colorObjectBoundingRect.size.width / 2 - borderDistance);
 	const bool rectLowerYIsOk = colorObjectBoundingRect.center.y > (colorObjectBoundingRect.size.height / 2 + borderDistance);
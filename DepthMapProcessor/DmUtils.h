@@ -2,24 +2,32 @@
 
 #include "Structures.h"
 #include "OpenCVInclude.h"
+#include "ContourGeometry.h"
 
 class DmUtils
 {
 public:
 	static const RelPoint AbsoluteToRelative(const cv::Point& abs, const int width, const int height);
-	static const std::vector<Contour> GetValidContours(const std::vector<Contour>& contours, const float minAreaRatio, const int imageDataLength);
-	static void ConvertDepthMapDataToBinaryMask(const int mapDataLength, const short*const mapData, byte*const maskData);
+	static const std::vector<ContourGeometry> GetValidContours(std::vector<Contour>& contours, const float minAreaRatio, const int imageDataLength);
 	static void FilterDepthMapByMaxDepth(const int mapDataLength, short*const mapData, const short value);
-	static void FilterDepthMapByMeasurementVolume(const int mapLength, short*const mapData, DepthValue*const worldDepthValues,
-		const MeasurementVolume& volume);
+	static void ConvertDepthMapToDecimatedMask(const int mapWidth, const int mapHeight, const short*const mapData,
+		const CalibrationState& calibration, const CameraIntrinsics& intrinsics, const int factor,
+		const DepthDecimationFilter filter, byte*const decimatedMask);
+	static void FilterDepthMapRegionByCalibration(const int mapWidth, const cv::Rect& region, const short*const sourceData,
+		short*const mapData, byte*const maskData, const CalibrationState& calibration, const CameraIntrinsics& intrinsics);
+	static const bool IsZoneOccupied(const int mapWidth, const int mapHeight, const short*const mapData,
+		const CalibrationState& calibration, const CameraIntrinsics& intrinsics, const int stride);
 	static const std::vector<short> GetNonZeroContourDepthValues(const DepthMap& depthMap);
 	static const std::vector<short> GetNonZeroContourDepthValues(const int mapWidth, const int mapHeight, const short*const mapData,
-		const cv::RotatedRect& roi, const Contour& contour);
+		const cv::Rect& roi, const Contour& contour);
 	static const float GetDistanceBetweenPoints(const int x1, const int y1, const int x2, const int y2);
 	static const cv::Rect GetAbsRoiFromRoiRect(const RelRect& roiRect, const cv::Size& frameSize);
 	static const int GetCvChannelsCodeFromBytesPerPixel(const int bytesPerPixel);
 	static const short FindModeInSortedArray(const short*const array, const int count);
+	static const unsigned long long GetDataHash(const byte*const data, const int lengthBytes, const unsigned long long seed);
 	static void DrawTargetContour(const Contour& contour, const int width, const int height, const std::string& filename);
 	static bool IsPointInZone(const DepthValue& worldPoint, const MeasurementVolume& volume);
-	static bool IsObjectInBounds(const Contour& objectContour, const int width, const int height);
+	static bool IsObjectInBounds(const ContourGeometry& objectContour, const int width, const int height);
+	static const bool IsDepthInCalibratedZone(const int x, const int y, const int index, const short depth,
+		const CalibrationState& calibration, const CameraIntrinsics& intrinsics);
 };
@@ -0,0 +1,168 @@
+#include "FloorPlaneEstimator.h"
+#include <cmath>
+#include <climits>
+#include <random>
+
+const int SampleStep = 4;
+const int MinSampleCount = 100;
+const int RansacIterationCount = 64;
+const float InlierDistanceMm = 10.0f;
+const float MinInlierRatio = 0.3f;
+const float MaxFloorSlope = 0.5f; // about 27 degrees of camera tilt
+
+const bool FloorPlaneEstimator::EstimateFloorPlane(const DepthMap& depthMap, const CameraIntrinsics& intrinsics, FloorPlane& plane)
+{
+	plane = FloorPlane{};
+
+	std::vector<cv::Point3f> points;
+	points.reserve((depthMap.Width / SampleStep + 1) * (depthMap.Height / SampleStep + 1));
+
+	for (int j = 0; j < depthMap.Height; j += SampleStep)
+	{
+		const float rowFactor = -(j + 1 - intrinsics.PrincipalPointY) / intrinsics.FocalLengthY;
+		for (int i = 0; i < depthMap.Width; i += SampleStep)
+		{
+			const short depth = depthMap.Data[j * depthMap.Width + i];
+			if (depth <= 0)
+				continue;
+
+			const float columnFactor = (i + 1 - intrinsics.PrincipalPointX) / intrinsics.FocalLengthX;
+			points.emplace_back(cv::Point3f(columnFactor * depth, rowFactor * depth, depth));
+		}
+	}
+
+	const int pointCount = (int)points.size();
+	if (pointCount < MinSampleCount)
+		return false;
+
+	// fixed seed keeps the calibration reproducible for the same frame
+	std::mt19937 random(pointCount);
+	std::uniform_int_distribution<int> pointIndex(0, pointCount - 1);
+
+	FloorPlane bestModel{};
+	int bestInlierCount = 0;
+
+	for (int i = 0; i < RansacIterationCount; i++)
+	{
+		FloorPlane model;
+		if (!FitPlaneToPoints(points[pointIndex(random)], points[pointIndex(random)], points[pointIndex(random)], model))
+			continue;
+
+		const int inlierCount = CountInliers(points, model);
+		if (inlierCount > bestInlierCount)
+		{
+			bestInlierCount = inlierCount;
+			bestModel = model;
+		}
+	}
+
+	if (bestInlierCount < pointCount * MinInlierRatio)
+		return false;
+
+	if (!FitPlaneToInliers(points, bestModel, plane))
+		return false;
+
+	plane.InlierRatio = (float)CountInliers(points, plane) / pointCount;
+
+	return true;
+}
+
+const short FloorPlaneEstimator::GetFloorDepth(const FloorPlane& plane, const float columnFactor, const float rowFactor)
+{
+	// the pixel ray is (columnFactor * depth, rowFactor * depth, depth), intersected with the plane
+	const float denominator = 1 - plane.SlopeX * columnFactor - plane.SlopeY * rowFactor;
+	if (denominator <= 0)
+		return SHRT_MAX;
+
+	const float depth = plane.Offset / denominator;
+
+	return depth < SHRT_MAX ? (short)depth : SHRT_MAX;
+}
+
+const bool FloorPlaneEstimator::IsPlaneSet(const FloorPlane& plane)
+{
+	return plane.Offset > 0;
+}
+
+const bool FloorPlaneEstimator::FitPlaneToPoints(const cv::Point3f& a, const cv::Point3f& b, const cv::Point3f& c, FloorPlane& plane)
+{
+	const float abX = b.x - a.x;
+	const float abY = b.y - a.y;
+	const float abZ = b.z - a.z;
+	const float acX = c.x - a.x;
+	const float acY = c.y - a.y;
+	const float acZ = c.z - a.z;
+
+	const float normalX = abY * acZ - abZ * acY;
+	const float normalY = abZ * acX - abX * acZ;
+	const float normalZ = abX * acY - abY * acX;
+	if (std::abs(normalZ) < 1.0f)
+		return false;
+
+	plane.SlopeX = -normalX / normalZ;
+	plane.SlopeY = -normalY / normalZ;
+	plane.Offset = a.z - plane.SlopeX * a.x - plane.SlopeY * a.y;
+	plane.InlierRatio = 0;
+
+	const bool planeCanBeFloor = plane.Offset > 0 && std::abs(plane.SlopeX) <= MaxFloorSlope && std::abs(plane.SlopeY) <= MaxFloorSlope;
+
+	return planeCanBeFloor;
+}
+
+const bool FloorPlaneEstimator::FitPlaneToInliers(const std::vector<cv::Point3f>& points, const FloorPlane& model, FloorPlane& plane)
+{
+	// normal equations of depth = offset + slopeX * x + slopeY * y over the inliers of the model
+	double sxx = 0, sxy = 0, sx = 0, syy = 0, sy = 0, n = 0;
+	double sxz = 0, syz = 0, sz = 0;
+
+	for (int i = 0; i < points.size(); i++)
+	{
+		const cv::Point3f& point = points[i];
+		const float expectedDepth = model.Offset + model.SlopeX * point.x + model.SlopeY * point.y;
+		if (std::abs(point.z - expectedDepth) > InlierDistanceMm)
+			continue;
+
+		const double x = point.x;
+		const double y = point.y;
+		const double z = point.z;
+
+		sxx += x * x;
+		sxy += x * y;
+		sx += x;
+		syy += y * y;
+		sy += y;
+		n += 1;
+		sxz += x * z;
+		syz += y * z;
+		sz += z;
+	}
+
+	const double determinant = sxx * (syy * n - sy * sy) - sxy * (sxy * n - sy * sx) + sx * (sxy * sy - syy * sx);
+	if (std::abs(determinant) < 1e-6)
+		return false;
+
+	const double slopeX = (sxz * (syy * n - sy * sy) - sxy * (syz * n - sy * sz) + sx * (syz * sy - syy * sz)) / determinant;
+	const double slopeY = (sxx * (syz * n - sz * sy) - sxz * (sxy * n - sy * sx) + sx * (sxy * sz - syz * sx)) / determinant;
+	const double offset = (sxx * (syy * sz - syz * sy) - sxy * (sxy * sz - syz * sx) + sxz * (sxy * sy - syy * sx)) / determinant;
+
+	plane.Offset = (float)offset;
+	plane.SlopeX = (float)slopeX;
+	plane.SlopeY = (float)slopeY;
+	plane.InlierRatio = 0;
+
+	return plane.Offset > 0;
+}
+
+const int FloorPlaneEstimator::CountInliers(const std::vector<cv::Point3f>& points, const FloorPlane& plane)
+{
+	int inlierCount = 0;
+	for (int i = 0; i < points.size(); i++)
+	{
+		const cv::Point3f& point = points[i];
+		const float expectedDepth = plane.Offset + plane.SlopeX * point.x + plane.SlopeY * point.y;
+		if (std::abs(point.z - expectedDepth) <= InlierDistanceMm)
+			inlierCount++;
+	}
+
+	return inlierCount;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Structures.h"
+
+// fits the floor plane depth = Offset + SlopeX * x + SlopeY * y (world millimeters) to a depth map
+class FloorPlaneEstimator
+{
+public:
+	static const bool EstimateFloorPlane(const DepthMap& depthMap, const CameraIntrinsics& intrinsics, FloorPlane& plane);
+	static const short GetFloorDepth(const FloorPlane& plane, const float columnFactor, const float rowFactor);
+	static const bool IsPlaneSet(const FloorPlane& plane);
+
+private:
+	static const bool FitPlaneToPoints(const cv::Point3f& a, const cv::Point3f& b, const cv::Point3f& c, FloorPlane& plane);
+	static const bool FitPlaneToInliers(const std::vector<cv::Point3f>& points, const FloorPlane& model, FloorPlane& plane);
+	static const int CountInliers(const std::vector<cv::Point3f>& points, const FloorPlane& plane);
+};
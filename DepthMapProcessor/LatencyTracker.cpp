@@ -0,0 +1,136 @@
+#include "LatencyTracker.h"
+#include <chrono>
+
+namespace
+{
+	const int SubBucketBits = 3;
+	const int SubBucketCount = 1 << SubBucketBits;
+	const int MaxLatencyBits = 32; // a bit more than an hour, longer latencies go to the last bucket
+	const int BucketCount = (MaxLatencyBits - SubBucketBits + 1) * SubBucketCount;
+
+	struct LatencyHistogram
+	{
+		std::atomic<unsigned int> Buckets[BucketCount];
+		std::atomic<long long> MaxUs;
+	};
+
+	LatencyHistogram Histograms[LatencyStageCount];
+
+	const int GetBucketIndex(const long long latencyUs)
+	{
+		if (latencyUs < SubBucketCount)
+			return (int)latencyUs;
+
+		const long long clampedLatencyUs = std::min(latencyUs, (1LL << MaxLatencyBits) - 1);
+
+		int highestBit = SubBucketBits;
+		while ((clampedLatencyUs >> (highestBit + 1)) != 0)
+			highestBit++;
+
+		const int shift = highestBit - SubBucketBits;
+		const int subBucket = (int)((clampedLatencyUs >> shift) & (SubBucketCount - 1));
+
+		return (shift + 1) * SubBucketCount + subBucket;
+	}
+
+	const long long GetBucketUpperBound(const int bucketIndex)
+	{
+		if (bucketIndex < SubBucketCount)
+			return bucketIndex;
+
+		const int shift = bucketIndex / SubBucketCount - 1;
+		const long long lowerBound = (long long)(SubBucketCount + bucketIndex % SubBucketCount) << shift;
+
+		return lowerBound + (1LL << shift) - 1;
+	}
+}
+
+const long long LatencyTracker::GetTimestampUs()
+{
+	const auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count();
+}
+
+void LatencyTracker::RecordProcessingStart(const FrameTiming& timing, const long long processingStartUs)
+{
+	if (timing.CaptureTimestampUs > 0 && timing.ReceivedTimestampUs > 0)
+		Record(LatencyStage::CaptureToCallback, timing.ReceivedTimestampUs - timing.CaptureTimestampUs);
+
+	if (timing.ReceivedTimestampUs > 0)
+		Record(LatencyStage::CallbackToProcessing, processingStartUs - timing.ReceivedTimestampUs);
+}
+
+void LatencyTracker::Record(const LatencyStage stage, const long long latencyUs)
+{
+	// the system clock may be adjusted between two timestamps
+	if (latencyUs < 0)
+		return;
+
+	LatencyHistogram& histogram = Histograms[(int)stage];
+	histogram.Buckets[GetBucketIndex(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+
+	long long maxUs = histogram.MaxUs.load(std::memory_order_relaxed);
+	while (latencyUs > maxUs && !histogram.MaxUs.compare_exchange_weak(maxUs, latencyUs, std::memory_order_relaxed))
+	{
+	}
+}
+
+const bool LatencyTracker::GetStats(const LatencyStage stage, LatencyStats& stats)
+{
+	const int stageIndex = (int)stage;
+	if (stageIndex < 0 || stageIndex >= LatencyStageCount)
+		return false;
+
+	LatencyHistogram& histogram = Histograms[stageIndex];
+
+	// latencies recorded meanwhile may or may not be counted, the stats stay consistent with the snapshot either way
+	unsigned int counts[BucketCount];
+	long long count = 0;
+	for (int i = 0; i < BucketCount; i++)
+	{
+		counts[i] = histogram.Buckets[i].load(std::memory_order_relaxed);
+		count += counts[i];
+	}
+
+	stats = LatencyStats{ count, 0, 0, 0, 0 };
+	if (count == 0)
+		return true;
+
+	const long long maxUs = histogram.MaxUs.load(std::memory_order_relaxed);
+	const long long medianRank = (count + 1) / 2;
+	const long long p90Rank = (count * 90 + 99) / 100;
+	const long long p99Rank = (count * 99 + 99) / 100;
+
+	long long rank = 0;
+	for (int i = 0; i < BucketCount; i++)
+	{
+		if (counts[i] == 0)
+			continue;
+
+		const long long previousRank = rank;
+		rank += counts[i];
+
+		const long long upperBoundUs = std::min(GetBucketUpperBound(i), maxUs);
+		if (previousRank < medianRank && rank >= medianRank)
+			stats.MedianUs = upperBoundUs;
+		if (previousRank < p90Rank && rank >= p90Rank)
+			stats.P90Us = upperBoundUs;
+		if (previousRank < p99Rank && rank >= p99Rank)
+			stats.P99Us = upperBoundUs;
+	}
+
+	stats.MaxUs = maxUs;
+
+	return true;
+}
+
+void LatencyTracker::Reset()
+{
+	for (int i = 0; i < LatencyStageCount; i++)
+	{
+		for (int j = 0; j < BucketCount; j++)
+			Histograms[i].Buckets[j].store(0, std::memory_order_relaxed);
+		Histograms[i].MaxUs.store(0, std::memory_order_relaxed);
+	}
+}
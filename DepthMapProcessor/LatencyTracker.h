@@ -0,0 +1,18 @@
+#pragma once
+
+#include <atomic>
+#include "Structures.h"
+
+// process-wide latency histograms with logarithmic buckets, one per LatencyStage
+class LatencyTracker
+{
+public:
+	static const long long GetTimestampUs();
+
+	// records the stages a frame went through before its processing started, stages with missing timestamps are skipped
+	static void RecordProcessingStart(const FrameTiming& timing, const long long processingStartUs);
+	static void Record(const LatencyStage stage, const long long latencyUs);
+
+	static const bool GetStats(const LatencyStage stage, LatencyStats& stats);
+	static void Reset();
+};
@@ -0,0 +1,61 @@
+#include "LumaConverter.h"
+#include <cstring>
+#include "TraceRecorder.h"
+
+namespace
+{
+	// BT.601 weights in 14-bit fixed point, as OpenCV's own conversion has them
+	const int BlueWeight = 1868;
+	const int GreenWeight = 9617;
+	const int RedWeight = 4899;
+	const int WeightShift = 14;
+	const int RoundingOffset = 1 << (WeightShift - 1);
+
+	// integer arithmetic only and no control flow in the loop, so it vectorizes
+	template <int BytesPerPixel>
+	void ConvertRowToLuma(const byte*const source, byte*const luma, const int width)
+	{
+		for (int i = 0; i < width; i++)
+		{
+			const byte*const pixel = source + i * BytesPerPixel;
+			luma[i] = (byte)((pixel[0] * BlueWeight + pixel[1] * GreenWeight + pixel[2] * RedWeight + RoundingOffset) >> WeightShift);
+		}
+	}
+}
+
+const cv::Mat LumaConverter::Convert(const cv::Mat& image, const cv::Rect& rect)
+{
+	TRACE_SCOPE("LumaConverter::Convert");
+
+	const cv::Rect& imageRect = rect & cv::Rect(0, 0, image.cols, image.rows);
+	if (image.data == nullptr || imageRect.area() == 0 || image.depth() != CV_8U)
+		return cv::Mat();
+
+	const int lumaLength = imageRect.area();
+	if ((int)_lumaBuffer.size() < lumaLength)
+		_lumaBuffer.resize(lumaLength);
+
+	const int bytesPerPixel = image.channels();
+	for (int j = 0; j < imageRect.height; j++)
+	{
+		const byte*const sourceRow = image.ptr<byte>(imageRect.y + j) + imageRect.x * bytesPerPixel;
+		byte*const lumaRow = _lumaBuffer.data() + j * imageRect.width;
+
+		switch (bytesPerPixel)
+		{
+		case 3:
+			ConvertRowToLuma<3>(sourceRow, lumaRow, imageRect.width);
+			break;
+		case 4:
+			ConvertRowToLuma<4>(sourceRow, lumaRow, imageRect.width);
+			break;
+		default:
+			// single channel images already are luminance, other formats take their first channel
+			for (int i = 0; i < imageRect.width; i++)
+				lumaRow[i] = sourceRow[i * bytesPerPixel];
+			break;
+		}
+	}
+
+	return cv::Mat(imageRect.height, imageRect.width, CV_8UC1, _lumaBuffer.data());
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+// converts a rect of a BGR(A) image to luminance in one pass, the buffer is kept between frames
+class LumaConverter
+{
+private:
+	std::vector<byte> _lumaBuffer;
+
+public:
+	// the result points to the converter's buffer, it stays valid until the next conversion
+	const cv::Mat Convert(const cv::Mat& image, const cv::Rect& rect);
+};
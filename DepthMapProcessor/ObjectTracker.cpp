@@ -0,0 +1,218 @@
+#include "ObjectTracker.h"
+#include <cmath>
+
+namespace
+{
+	template <typename T>
+	T GetMedian(T* values, const int count)
+	{
+		std::nth_element(values, values + count / 2, values + count);
+		return values[count / 2];
+	}
+}
+
+ObjectTracker::ObjectTracker()
+{
+	_requiredSampleCount = 5;
+	Reset();
+}
+
+void ObjectTracker::Reset()
+{
+	for (int i = 0; i < MaxTrackedObjectCount; i++)
+		_tracks[i].IsActive = false;
+
+	_nextObjectId = 1;
+}
+
+void ObjectTracker::SetRequiredSampleCount(const int sampleCount)
+{
+	_requiredSampleCount = std::min(std::max(sampleCount, 1), MaxObjectSampleCount);
+}
+
+void ObjectTracker::AssociateDetections(const cv::Rect*const boundingRects, const cv::Point2f*const centers,
+	const int detectionCount, int*const trackSlots)
+{
+	const int count = std::min(detectionCount, MaxTrackedObjectCount);
+
+	float scores[MaxTrackedObjectCount][MaxTrackedObjectCount];
+	bool trackIsMatched[MaxTrackedObjectCount];
+
+	for (int i = 0; i < count; i++)
+		trackSlots[i] = -1;
+
+	for (int t = 0; t < MaxTrackedObjectCount; t++)
+	{
+		trackIsMatched[t] = false;
+		if (!_tracks[t].IsActive)
+			continue;
+
+		for (int d = 0; d < count; d++)
+			scores[t][d] = GetMatchScore(_tracks[t], boundingRects[d], centers[d]);
+	}
+
+	// greedy matching, the best remaining pair first
+	while (true)
+	{
+		float bestScore = 0.0f;
+		int bestTrack = -1;
+		int bestDetection = -1;
+
+		for (int t = 0; t < MaxTrackedObjectCount; t++)
+		{
+			if (!_tracks[t].IsActive || trackIsMatched[t])
+				continue;
+
+			for (int d = 0; d < count; d++)
+			{
+				if (trackSlots[d] >= 0 || scores[t][d] <= bestScore)
+					continue;
+
+				bestScore = scores[t][d];
+				bestTrack = t;
+				bestDetection = d;
+			}
+		}
+
+		if (bestTrack < 0)
+			break;
+
+		Track& track = _tracks[bestTrack];
+		track.Velocity = centers[bestDetection] - track.Center;
+		track.Center = centers[bestDetection];
+		track.BoundingRect = boundingRects[bestDetection];
+		track.WasSeen = true;
+
+		trackIsMatched[bestTrack] = true;
+		trackSlots[bestDetection] = bestTrack;
+	}
+
+	for (int d = 0; d < count; d++)
+	{
+		if (trackSlots[d] >= 0)
+			continue;
+
+		for (int t = 0; t < MaxTrackedObjectCount; t++)
+		{
+			if (_tracks[t].IsActive)
+				continue;
+
+			Track& track = _tracks[t];
+			track.IsActive = true;
+			track.WasSeen = true;
+			track.WasReported = false;
+			track.ObjectId = _nextObjectId++;
+			track.MissedFrameCount = 0;
+			track.BoundingRect = boundingRects[d];
+			track.Center = centers[d];
+			track.Velocity = cv::Point2f(0, 0);
+			track.SampleCount = 0;
+
+			trackSlots[d] = t;
+			break;
+		}
+	}
+}
+
+const bool ObjectTracker::NeedsSamples(const int trackSlot) const
+{
+	if (trackSlot < 0 || trackSlot >= MaxTrackedObjectCount)
+		return false;
+
+	const Track& track = _tracks[trackSlot];
+
+	return track.IsActive && !track.WasReported && track.SampleCount < MaxObjectSampleCount;
+}
+
+void ObjectTracker::AddSample(const int trackSlot, const ObjectMeasurement& measurement)
+{
+	if (!NeedsSamples(trackSlot))
+		return;
+
+	Track& track = _tracks[trackSlot];
+	track.Samples[track.SampleCount++] = measurement;
+}
+
+const int ObjectTracker::CollectMeasurements(ConveyorMeasurement*const measurements, const int capacity)
+{
+	int measurementCount = 0;
+
+	for (int t = 0; t < MaxTrackedObjectCount; t++)
+	{
+		Track& track = _tracks[t];
+		if (!track.IsActive)
+			continue;
+
+		const bool wasSeen = track.WasSeen;
+		track.WasSeen = false;
+		track.MissedFrameCount = wasSeen ? 0 : track.MissedFrameCount + 1;
+
+		const bool isLost = track.MissedFrameCount > _maxMissedFrameCount;
+		const bool isReadyToReport = !track.WasReported && track.SampleCount > 0 &&
+			(track.SampleCount >= _requiredSampleCount || isLost);
+
+		if (isReadyToReport)
+		{
+			// a full output keeps the track alive until the next frame
+			if (measurementCount == capacity)
+				continue;
+
+			ReportTrack(track, measurements[measurementCount++]);
+		}
+
+		if (isLost)
+			track.IsActive = false;
+	}
+
+	return measurementCount;
+}
+
+const float ObjectTracker::GetMatchScore(const Track& track, const cv::Rect& boundingRect, const cv::Point2f& center) const
+{
+	// conveyor motion is steady, so the last displacement predicts the next position well
+	const cv::Point2f& predictedCenter = track.Center + track.Velocity;
+	const cv::Rect predictedRect(track.BoundingRect.x + (int)track.Velocity.x, track.BoundingRect.y + (int)track.Velocity.y,
+		track.BoundingRect.width, track.BoundingRect.height);
+
+	const int overlapArea = (predictedRect & boundingRect).area();
+	if (overlapArea > 0)
+	{
+		const int smallerArea = std::max(std::min(predictedRect.area(), boundingRect.area()), 1);
+		return 1.0f + (float)overlapArea / smallerArea;
+	}
+
+	const float maxDistance = std::max(track.BoundingRect.width, track.BoundingRect.height) * _maxCenterDistanceRatio;
+	const float dx = center.x - predictedCenter.x;
+	const float dy = center.y - predictedCenter.y;
+	const float distance = std::sqrt(dx * dx + dy * dy);
+
+	return distance < maxDistance ? 1.0f - distance / maxDistance : 0.0f;
+}
+
+void ObjectTracker::ReportTrack(Track& track, ConveyorMeasurement& measurement) const
+{
+	const int sampleCount = track.SampleCount;
+
+	int lengths[MaxObjectSampleCount];
+	int widths[MaxObjectSampleCount];
+	int heights[MaxObjectSampleCount];
+	long long volumes[MaxObjectSampleCount];
+
+	for (int i = 0; i < sampleCount; i++)
+	{
+		lengths[i] = track.Samples[i].LengthMm;
+		widths[i] = track.Samples[i].WidthMm;
+		heights[i] = track.Samples[i].HeightMm;
+		volumes[i] = track.Samples[i].VolumeMm3;
+	}
+
+	measurement.ObjectId = track.ObjectId;
+	measurement.SampleCount = sampleCount;
+	measurement.Measurement = track.Samples[sampleCount - 1];
+	measurement.Measurement.LengthMm = GetMedian(lengths, sampleCount);
+	measurement.Measurement.WidthMm = GetMedian(widths, sampleCount);
+	measurement.Measurement.HeightMm = GetMedian(heights, sampleCount);
+	measurement.Measurement.VolumeMm3 = GetMedian(volumes, sampleCount);
+
+	track.WasReported = true;
+}
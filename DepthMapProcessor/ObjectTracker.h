@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Structures.h"
+#include "OpenCVInclude.h"
+
+const int MaxTrackedObjectCount = 32;
+const int MaxObjectSampleCount = 16;
+
+// follows depth blobs across the frames of a stream and reports every object's median measurement once
+class ObjectTracker
+{
+private:
+	struct Track
+	{
+		bool IsActive;
+		bool WasSeen;
+		bool WasReported;
+		int ObjectId;
+		int MissedFrameCount;
+		cv::Rect BoundingRect;
+		cv::Point2f Center;
+		cv::Point2f Velocity;
+		int SampleCount;
+		ObjectMeasurement Samples[MaxObjectSampleCount];
+	};
+
+	const int _maxMissedFrameCount = 3;
+	const float _maxCenterDistanceRatio = 1.0f; // relative to the larger side of the track's bounding rect
+
+	Track _tracks[MaxTrackedObjectCount];
+	int _requiredSampleCount;
+	int _nextObjectId;
+
+public:
+	ObjectTracker();
+
+	void Reset();
+	void SetRequiredSampleCount(const int sampleCount);
+
+	// assigns each detection a track slot, creating tracks for new objects; -1 if all slots are taken
+	void AssociateDetections(const cv::Rect*const boundingRects, const cv::Point2f*const centers, const int detectionCount,
+		int*const trackSlots);
+	const bool NeedsSamples(const int trackSlot) const;
+	void AddSample(const int trackSlot, const ObjectMeasurement& measurement);
+
+	// reports the objects that are done and ages out the ones that were not seen in this frame
+	const int CollectMeasurements(ConveyorMeasurement*const measurements, const int capacity);
+
+private:
+	const float GetMatchScore(const Track& track, const cv::Rect& boundingRect, const cv::Point2f& center) const;
+	void ReportTrack(Track& track, ConveyorMeasurement& measurement) const;
+};
@@ -0,0 +1,82 @@
+#include "SampleAggregator.h"
+#include <algorithm>
+
+SampleAggregator::SampleAggregator(const int minSampleCount, const int maxSampleCount, const int toleranceMm)
+	: _maxSampleCount(std::max(maxSampleCount, 1)), _minSampleCount(std::min(std::max(minSampleCount, 1), _maxSampleCount)),
+	_toleranceMm(std::max(toleranceMm, 0))
+{
+	_samples.reserve(_maxSampleCount);
+	_volumes.reserve(_maxSampleCount);
+}
+
+void SampleAggregator::Reset()
+{
+	_samples.clear();
+	_volumes.clear();
+}
+
+const SampleAggregate SampleAggregator::AddSample(const VolumeCalculationResult& sample)
+{
+	if ((int)_samples.size() < _maxSampleCount)
+	{
+		_samples.emplace_back(sample);
+		_volumes.insert(std::upper_bound(_volumes.begin(), _volumes.end(), sample.VolumeMm3), sample.VolumeMm3);
+	}
+
+	const int sampleCount = (int)_samples.size();
+
+	SampleAggregate aggregate;
+	aggregate.SampleCount = sampleCount;
+	aggregate.LengthSpreadMm = GetLatestSpread(&VolumeCalculationResult::LengthMm);
+	aggregate.WidthSpreadMm = GetLatestSpread(&VolumeCalculationResult::WidthMm);
+	aggregate.HeightSpreadMm = GetLatestSpread(&VolumeCalculationResult::HeightMm);
+
+	const bool latestSamplesAgree = aggregate.LengthSpreadMm <= _toleranceMm && aggregate.WidthSpreadMm <= _toleranceMm &&
+		aggregate.HeightSpreadMm <= _toleranceMm;
+	aggregate.IsConverged = sampleCount >= _minSampleCount && latestSamplesAgree;
+	aggregate.IsComplete = aggregate.IsConverged || sampleCount >= _maxSampleCount;
+
+	aggregate.Result.LengthMm = GetMode(&VolumeCalculationResult::LengthMm);
+	aggregate.Result.WidthMm = GetMode(&VolumeCalculationResult::WidthMm);
+	aggregate.Result.HeightMm = GetMode(&VolumeCalculationResult::HeightMm);
+	aggregate.Result.VolumeMm3 = _volumes[sampleCount / 2];
+
+	// the result is only complete with its last sample, so it is attributed to that sample's frame
+	aggregate.Result.FrameNumber = _samples.back().FrameNumber;
+	aggregate.Result.CaptureTimestampUs = _samples.back().CaptureTimestampUs;
+
+	return aggregate;
+}
+
+const int SampleAggregator::GetMode(int VolumeCalculationResult::*const dimension) const
+{
+	// ties go to the value that was measured first
+	int mode = 0;
+	int modeCount = 0;
+
+	for (int i = 0; i < (int)_samples.size(); i++)
+	{
+		const int value = _samples[i].*dimension;
+		const int count = (int)std::count_if(_samples.begin() + i, _samples.end(),
+			[dimension, value](const VolumeCalculationResult& sample) { return sample.*dimension == value; });
+
+		if (count > modeCount)
+		{
+			mode = value;
+			modeCount = count;
+		}
+	}
+
+	return mode;
+}
+
+const int SampleAggregator::GetLatestSpread(int VolumeCalculationResult::*const dimension) const
+{
+	const int latestSampleCount = std::min((int)_samples.size(), _minSampleCount);
+	const auto latestSamplesBegin = _samples.end() - latestSampleCount;
+
+	const auto range = std::minmax_element(latestSamplesBegin, _samples.end(),
+		[dimension](const VolumeCalculationResult& a, const VolumeCalculationResult& b) { return a.*dimension < b.*dimension; });
+
+	return (*range.second).*dimension - (*range.first).*dimension;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include "Structures.h"
+
+// aggregates the samples of a measurement, which converges once the latest ones agree within the tolerance
+class SampleAggregator
+{
+private:
+	const int _maxSampleCount;
+	const int _minSampleCount; // never above the maximum
+	const int _toleranceMm;
+
+	std::vector<VolumeCalculationResult> _samples;
+	std::vector<long long> _volumes;
+
+public:
+	SampleAggregator(const int minSampleCount, const int maxSampleCount, const int toleranceMm);
+
+	void Reset();
+	const SampleAggregate AddSample(const VolumeCalculationResult& sample);
+
+private:
+	const int GetMode(int VolumeCalculationResult::*const dimension) const;
+	const int GetLatestSpread(int VolumeCalculationResult::*const dimension) const;
+};
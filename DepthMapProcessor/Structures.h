@@ -17,11 +17,74 @@ enum class AlgorithmSelectionStatus
 	Rgb = 2,
 };
 
+enum class ColorSegmentationMode
+{
+	Canny = 0,
+	BackgroundModel = 1,
+};
+
+// how a block of the depth map is reduced to one value in the decimated mode
+enum class DepthDecimationFilter
+{
+	Min = 0,
+	Median = 1,
+};
+
+const int MaxDepthDecimationFactor = 4;
+
+enum class PreviewPalette
+{
+	Grayscale = 0,
+	Color = 1,
+};
+
+// stages of a frame's way from the sensor to a measurement result
+enum class LatencyStage
+{
+	CaptureToCallback = 0,
+	CallbackToProcessing = 1,
+	ProcessingToResult = 2,
+};
+
+const int LatencyStageCount = 3;
+
+struct LatencyStats
+{
+	long long Count;
+	long long MedianUs;
+	long long P90Us;
+	long long P99Us;
+	long long MaxUs;
+};
+
+// timestamps are microseconds of the host's system clock since the Unix epoch, 0 if unknown
+struct FrameTiming
+{
+	long long FrameNumber;
+	long long CaptureTimestampUs; // when the sensor captured the frame
+	long long ReceivedTimestampUs; // when the frame provider handed the frame out
+};
+
 struct VolumeCalculationResult
 {
 	int LengthMm;
 	int WidthMm;
 	int HeightMm;
+	long long VolumeMm3; // integrated over the depth blob, 0 if the object has no depth contour
+	long long FrameNumber; // of the depth map the object was measured on
+	long long CaptureTimestampUs;
+};
+
+// state of a measurement's samples so far, see SampleAggregator
+struct SampleAggregate
+{
+	int SampleCount;
+	int IsConverged; // the latest samples agree within the tolerance
+	int IsComplete; // converged or the maximum sample count was reached, no more samples are needed
+	int LengthSpreadMm; // max - min over the latest samples
+	int WidthSpreadMm;
+	int HeightSpreadMm;
+	VolumeCalculationResult Result;
 };
 
 struct TwoDimDescription
@@ -36,6 +99,30 @@ struct RelPoint
 	float Y;
 };
 
+// one object of a multi-object measurement, the center and the footprint corners are relative to the depth map
+struct ObjectMeasurement
+{
+	int LengthMm;
+	int WidthMm;
+	int HeightMm;
+	long long VolumeMm3;
+	RelPoint Center;
+	RelPoint Footprint[4];
+};
+
+struct ConveyorMeasurement
+{
+	int ObjectId;
+	int SampleCount;
+	ObjectMeasurement Measurement; // median over the samples taken while the object was fully inside the zone
+};
+
+struct MultiVolumeCalculationResult
+{
+	int ObjectCount;
+	ObjectMeasurement* Objects;
+};
+
 struct AbsRect
 {
 	int X;
@@ -84,6 +171,13 @@ struct CameraIntrinsics
 	float PrincipalPointY;
 };
 
+// rigid transform from depth to color camera space, the rotation is column-major, the translation is in millimeters
+struct Extrinsics
+{
+	float Rotation[9];
+	float Translation[3];
+};
+
 struct ColorImage
 {
 	int Width;
@@ -106,6 +200,15 @@ struct DepthValue
 	short Value;
 };
 
+// floor depth = Offset + SlopeX * x + SlopeY * y, with x and y in world millimeters
+struct FloorPlane
+{
+	float Offset;
+	float SlopeX;
+	float SlopeY;
+	float InlierRatio;
+};
+
 struct AbsPoint
 {
 	int X;
@@ -119,6 +222,40 @@ struct MeasurementVolume
 	short largerDepthValue;
 };
 
+enum ZoneStatus : byte
+{
+	OutOfZone = 0,
+	InZone = 1, // in zone for depths within the pixel's zone depth range
+	ZoneBorder = 2, // needs an exact per-depth check
+};
+
+struct CalibrationSettings
+{
+	CameraIntrinsics DepthIntrinsics;
+	int MapWidth;
+	int MapHeight;
+	short FloorDepth;
+	short CutOffDepth;
+	FloorPlane FloorPlane; // zero offset if the floor is considered parallel to the camera
+	std::vector<cv::Point2f> PolygonPoints;
+};
+
+// settings-derived lookup data, rebuilt only when settings or map resolution change
+struct CalibrationState
+{
+	unsigned long long Key;
+	int MapWidth;
+	int MapHeight;
+	MeasurementVolume Volume;
+	std::vector<float> ColumnFactors; // world X = factor * depth
+	std::vector<float> RowFactors; // world Y = factor * depth
+	std::vector<byte> ZoneTable; // ZoneStatus of every pixel
+	std::vector<short> MinZoneDepths; // per-pixel depth range inside the zone, cut-off depth included
+	std::vector<short> MaxZoneDepths;
+	std::vector<short> FloorDepths; // expected floor depth of every pixel
+	std::vector<short> CutOffDepths;
+};
+
 struct ContourPlanes
 {
 	short Top;
@@ -131,6 +268,7 @@ struct VolumeCalculationData
 	const ColorImage* ColorImage;
 	const AlgorithmSelectionStatus SelectedAlgorithm;
 	const short CalculatedDistance;
+	const FrameTiming Timing; // of the depth map
 };
 
 struct NativeAlgorithmSelectionData
@@ -0,0 +1,175 @@
+#include "TraceRecorder.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// must be a power of two, 16k events take 384 KB per traced thread
+	const unsigned int TraceBufferCapacity = 16384;
+	const unsigned int TraceBufferMask = TraceBufferCapacity - 1;
+
+	struct TraceEvent
+	{
+		const char* Name;
+		long long StartUs;
+		long long DurationUs;
+	};
+
+	// single producer (the owning thread), single consumer (the flushing thread, serialized by BuffersMutex)
+	struct TraceBuffer
+	{
+		TraceEvent Events[TraceBufferCapacity];
+		std::atomic<unsigned int> WriteIndex;
+		std::atomic<unsigned int> ReadIndex;
+		std::atomic<unsigned int> DroppedCount;
+		std::atomic<bool> Retired;
+		unsigned int ThreadId;
+	};
+
+	struct ThreadBufferHolder
+	{
+		std::shared_ptr<TraceBuffer> Buffer;
+
+		~ThreadBufferHolder()
+		{
+			if (Buffer)
+				Buffer->Retired.store(true, std::memory_order_release);
+		}
+	};
+
+	std::mutex BuffersMutex;
+	std::vector<std::shared_ptr<TraceBuffer>> Buffers;
+	thread_local ThreadBufferHolder CurrentThreadBuffer;
+
+	const std::chrono::steady_clock::time_point TraceEpoch = std::chrono::steady_clock::now();
+
+	TraceBuffer* GetCurrentThreadBuffer()
+	{
+		if (CurrentThreadBuffer.Buffer)
+			return CurrentThreadBuffer.Buffer.get();
+
+		auto buffer = std::make_shared<TraceBuffer>();
+		buffer->WriteIndex.store(0);
+		buffer->ReadIndex.store(0);
+		buffer->DroppedCount.store(0);
+		buffer->Retired.store(false);
+		buffer->ThreadId = (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id());
+
+		{
+			std::lock_guard<std::mutex> lock(BuffersMutex);
+			Buffers.emplace_back(buffer);
+		}
+
+		CurrentThreadBuffer.Buffer = buffer;
+
+		return buffer.get();
+	}
+
+	// must be called with BuffersMutex held
+	void RemoveRetiredBuffers()
+	{
+		for (auto it = Buffers.begin(); it != Buffers.end();)
+		{
+			TraceBuffer& buffer = **it;
+			const bool isDrained = buffer.ReadIndex.load(std::memory_order_relaxed) ==
+				buffer.WriteIndex.load(std::memory_order_acquire);
+
+			if (buffer.Retired.load(std::memory_order_acquire) && isDrained)
+				it = Buffers.erase(it);
+			else
+				++it;
+		}
+	}
+}
+
+std::atomic<bool> TraceRecorder::_enabled(false);
+
+void TraceRecorder::SetEnabled(const bool enabled)
+{
+	const bool wasEnabled = _enabled.exchange(enabled);
+	if (!enabled || wasEnabled)
+		return;
+
+	// a new session should not start with the leftovers of the previous one
+	std::lock_guard<std::mutex> lock(BuffersMutex);
+	for (auto& buffer : Buffers)
+	{
+		buffer->ReadIndex.store(buffer->WriteIndex.load(std::memory_order_acquire), std::memory_order_release);
+		buffer->DroppedCount.store(0, std::memory_order_relaxed);
+	}
+
+	RemoveRetiredBuffers();
+}
+
+const long long TraceRecorder::GetTimestampUs()
+{
+	const auto elapsed = std::chrono::steady_clock::now() - TraceEpoch;
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void TraceRecorder::RecordEvent(const char* name, const long long startUs, const long long durationUs)
+{
+	TraceBuffer* buffer = GetCurrentThreadBuffer();
+
+	const unsigned int writeIndex = buffer->WriteIndex.load(std::memory_order_relaxed);
+	const unsigned int readIndex = buffer->ReadIndex.load(std::memory_order_acquire);
+	if (writeIndex - readIndex >= TraceBufferCapacity)
+	{
+		buffer->DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	TraceEvent& traceEvent = buffer->Events[writeIndex & TraceBufferMask];
+	traceEvent.Name = name;
+	traceEvent.StartUs = startUs;
+	traceEvent.DurationUs = durationUs;
+
+	buffer->WriteIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+const bool TraceRecorder::WriteTrace(const std::string& filepath)
+{
+	std::ofstream stream(filepath, std::ios::trunc);
+	if (!stream.is_open())
+		return false;
+
+	std::lock_guard<std::mutex> lock(BuffersMutex);
+
+	unsigned long long droppedCount = 0;
+	bool isFirstEvent = true;
+
+	stream << "{\"traceEvents\":[";
+
+	for (auto& buffer : Buffers)
+	{
+		const unsigned int readIndex = buffer->ReadIndex.load(std::memory_order_relaxed);
+		const unsigned int writeIndex = buffer->WriteIndex.load(std::memory_order_acquire);
+
+		for (unsigned int i = readIndex; i != writeIndex; i++)
+		{
+			const TraceEvent& traceEvent = buffer->Events[i & TraceBufferMask];
+
+			if (!isFirstEvent)
+				stream << ",";
+			isFirstEvent = false;
+
+			stream << "\n{\"name\":\"" << traceEvent.Name << "\",\"ph\":\"X\",\"ts\":" << traceEvent.StartUs
+				<< ",\"dur\":" << traceEvent.DurationUs << ",\"pid\":0,\"tid\":" << buffer->ThreadId << "}";
+		}
+
+		buffer->ReadIndex.store(writeIndex, std::memory_order_release);
+		droppedCount += buffer->DroppedCount.exchange(0, std::memory_order_relaxed);
+	}
+
+	stream << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":\"" << droppedCount << "\"}}\n";
+
+	RemoveRetiredBuffers();
+
+	return stream.good();
+}
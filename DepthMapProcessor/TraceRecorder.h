@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+// lock-free scope tracing into per-thread rings, written out as Chrome trace-event JSON; names must be literals
+
+class TraceRecorder
+{
+private:
+	static std::atomic<bool> _enabled;
+
+public:
+	static inline bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+	static void SetEnabled(const bool enabled);
+	static const long long GetTimestampUs();
+	static void RecordEvent(const char* name, const long long startUs, const long long durationUs);
+	static const bool WriteTrace(const std::string& filepath);
+};
+
+class TraceScope
+{
+private:
+	const char*const _name;
+	const long long _startUs;
+
+public:
+	explicit TraceScope(const char* name)
+		: _name(TraceRecorder::IsEnabled() ? name : nullptr), _startUs(_name ? TraceRecorder::GetTimestampUs() : 0)
+	{
+	}
+
+	~TraceScope()
+	{
+		if (_name)
+			TraceRecorder::RecordEvent(_name, _startUs, TraceRecorder::GetTimestampUs() - _startUs);
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
@@ -0,0 +1,96 @@
+#include "ZoneFilter.h"
+#include "DmUtils.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+	inline void FilterByZoneRanges(const int mapLength, const short*const sourceData, short*const mapData,
+		byte*const maskData, const short*const minDepths, const short*const maxDepths)
+	{
+		// out of zone and border pixels have an empty range; the comparisons are combined without branching,
+		// which keeps the loop free of control flow, so it vectorizes
+		for (int i = 0; i < mapLength; i++)
+		{
+			const short depth = sourceData[i];
+			const int depthIsInRange = (depth >= minDepths[i]) & (depth <= maxDepths[i]);
+			const short filteredDepth = (short)(depth * depthIsInRange);
+			mapData[i] = filteredDepth;
+			maskData[i] = (byte)((filteredDepth > 0) * 255);
+		}
+	}
+
+	template <int MapWidth, int MapHeight>
+	void FilterByZoneRangesFixed(const int, const short*const sourceData, short*const mapData, byte*const maskData,
+		const short*const minDepths, const short*const maxDepths)
+	{
+		FilterByZoneRanges(MapWidth * MapHeight, sourceData, mapData, maskData, minDepths, maxDepths);
+	}
+}
+
+ZoneFilter::ZoneFilter()
+{
+	_filterByZoneRanges = FilterByZoneRanges;
+}
+
+void ZoneFilter::Apply(const std::shared_ptr<const CalibrationState>& calibration, const CameraIntrinsics& intrinsics,
+	const short*const sourceData, short*const mapData, byte*const maskData)
+{
+	TRACE_SCOPE("ZoneFilter::Apply");
+
+	if (calibration != _calibration)
+		Configure(calibration);
+
+	const int mapWidth = calibration->MapWidth;
+	const int borderPixelCount = (int)_zoneBorderIndices.size();
+
+	// border pixels are checked before the range pass, which may overwrite the source
+	for (int i = 0; i < borderPixelCount; i++)
+	{
+		const int index = _zoneBorderIndices[i];
+		const short depth = sourceData[index];
+		const bool depthIsInZone = depth > 0 &&
+			DmUtils::IsDepthInCalibratedZone(index % mapWidth, index / mapWidth, index, depth, *calibration, intrinsics);
+		_zoneBorderDepths[i] = depthIsInZone ? depth : 0;
+	}
+
+	_filterByZoneRanges(calibration->MapWidth * calibration->MapHeight, sourceData, mapData, maskData,
+		calibration->MinZoneDepths.data(), calibration->MaxZoneDepths.data());
+
+	for (int i = 0; i < borderPixelCount; i++)
+	{
+		const int index = _zoneBorderIndices[i];
+		mapData[index] = _zoneBorderDepths[i];
+		maskData[index] = _zoneBorderDepths[i] > 0 ? 255 : 0;
+	}
+}
+
+void ZoneFilter::Configure(const std::shared_ptr<const CalibrationState>& calibration)
+{
+	_calibration = calibration;
+	_filterByZoneRanges = GetZoneRangeFilter(calibration->MapWidth, calibration->MapHeight);
+
+	_zoneBorderIndices.clear();
+	const int mapLength = calibration->MapWidth * calibration->MapHeight;
+	for (int i = 0; i < mapLength; i++)
+	{
+		if (calibration->ZoneTable[i] == ZoneStatus::ZoneBorder)
+			_zoneBorderIndices.emplace_back(i);
+	}
+
+	_zoneBorderDepths.resize(_zoneBorderIndices.size());
+}
+
+const ZoneRangeFilter ZoneFilter::GetZoneRangeFilter(const int mapWidth, const int mapHeight)
+{
+	// Kinect v2, VGA and the D435 depth modes
+	if (mapWidth == 512 && mapHeight == 424)
+		return FilterByZoneRangesFixed<512, 424>;
+	if (mapWidth == 640 && mapHeight == 480)
+		return FilterByZoneRangesFixed<640, 480>;
+	if (mapWidth == 848 && mapHeight == 480)
+		return FilterByZoneRangesFixed<848, 480>;
+	if (mapWidth == 1280 && mapHeight == 720)
+		return FilterByZoneRangesFixed<1280, 720>;
+
+	return FilterByZoneRanges;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Structures.h"
+
+typedef void(*ZoneRangeFilter)(const int mapLength, const short*const sourceData, short*const mapData,
+	byte*const maskData, const short*const minDepths, const short*const maxDepths);
+
+// filters a depth map by the calibrated zone and builds its mask in one pass, specialized for common resolutions
+class ZoneFilter
+{
+private:
+	std::shared_ptr<const CalibrationState> _calibration;
+	ZoneRangeFilter _filterByZoneRanges;
+	std::vector<int> _zoneBorderIndices;
+	std::vector<short> _zoneBorderDepths;
+
+public:
+	ZoneFilter();
+
+	// the source may be the map itself
+	void Apply(const std::shared_ptr<const CalibrationState>& calibration, const CameraIntrinsics& intrinsics,
+		const short*const sourceData, short*const mapData, byte*const maskData);
+
+private:
+	void Configure(const std::shared_ptr<const CalibrationState>& calibration);
+	static const ZoneRangeFilter GetZoneRangeFilter(const int mapWidth, const int mapHeight);
+};
@@ -89,10 +89,40 @@ namespace DeviceIntegration.FrameProviders
 			DepthFrameStream.Resume();
 		}
 
+		// only providers backed by a native capture library have anything to trace
+		public virtual void SetNativeTracingEnabled(bool enabled)
+		{
+		}
+
+		public virtual bool WriteNativeTrace(string filepath)
+		{
+			return false;
+		}
+
+		// recording happens next to capture, which only providers backed by a native capture library have
+		public virtual bool StartRecording(string directory)
+		{
+			return false;
+		}
+
+		public virtual void StopRecording()
+		{
+		}
+
+		public virtual FrameRecordingStats GetRecordingStats()
+		{
+			return null;
+		}
+
 		public abstract ColorCameraParams GetColorCameraParams();
 
 		public abstract DepthCameraParams GetDepthCameraParams();
 
+		public virtual CameraExtrinsics GetDepthToColorExtrinsics()
+		{
+			return null;
+		}
+
 		public abstract void Start();
 
 		public virtual void Dispose()
@@ -0,0 +1,27 @@
+﻿namespace DeviceIntegration.FrameProviders
+{
+	public class FrameRecordingStats
+	{
+		// framesets that are on disk
+		public long RecordedCount { get; }
+
+		// framesets that were dropped because the disk fell behind or failed
+		public long DroppedCount { get; }
+
+		public long WrittenBytes { get; }
+
+		public int ChunkCount { get; }
+
+		// nothing is recorded after the first failed write
+		public bool WriteFailed { get; }
+
+		public FrameRecordingStats(long recordedCount, long droppedCount, long writtenBytes, int chunkCount, bool writeFailed)
+		{
+			RecordedCount = recordedCount;
+			DroppedCount = droppedCount;
+			WrittenBytes = writtenBytes;
+			ChunkCount = chunkCount;
+			WriteFailed = writeFailed;
+		}
+	}
+}
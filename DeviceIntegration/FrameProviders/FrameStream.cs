@@ -24,7 +24,7 @@ namespace DeviceIntegration.FrameProviders
 			_logger = logger;
 			_name = name;
 
-			_frameQueue = new FixedSizeQueue<T>(5);
+			_frameQueue = new FixedSizeQueue<T>(5, ReleaseFrame);
 			Fps = -1;
 			_lastProcessedFrameTime = DateTime.MinValue;
 
@@ -89,6 +89,11 @@ namespace DeviceIntegration.FrameProviders
 			IsSuspended = false;
 		}
 
+		private static void ReleaseFrame(T frame)
+		{
+			(frame as IPooledFrame)?.Release();
+		}
+
 		private async Task PollFrames(CancellationToken token)
 		{
 			try
@@ -110,6 +115,9 @@ namespace DeviceIntegration.FrameProviders
 						_lastProcessedFrameTime = DateTime.Now;
 						FrameReady?.Invoke(image);
 					}
+
+					// subscribers that keep the frame have taken their own reference by now
+					ReleaseFrame(image);
 				}
 			}
 			catch (Exception ex)
@@ -20,6 +20,9 @@ namespace DeviceIntegration.FrameProviders
 
 		DepthCameraParams GetDepthCameraParams();
 
+		// null if the provider does not know where its cameras are relative to each other
+		CameraExtrinsics GetDepthToColorExtrinsics();
+
 		void Start();
 
 		void SuspendColorStream();
@@ -29,5 +32,15 @@ namespace DeviceIntegration.FrameProviders
 		void SuspendDepthStream();
 
 		void ResumeDepthStream();
+
+		void SetNativeTracingEnabled(bool enabled);
+
+		bool WriteNativeTrace(string filepath);
+
+		bool StartRecording(string directory);
+
+		void StopRecording();
+
+		FrameRecordingStats GetRecordingStats();
 	}
 }
@@ -8,5 +8,8 @@ namespace DeviceIntegration.Native
 		public int Width;
 		public int Height;
 		public byte* Data;
+		public long FrameNumber;
+		public long CaptureTimestampUs;
+		public long ReceivedTimestampUs;
 	}
 }
@@ -2,6 +2,8 @@
 
 #include <librealsense2/rs.hpp>
 #include "SensorWrapper.h"
+#include "SharedFrameRing.h"
+#include "../../DepthMapProcessor/TraceRecorder.h"
 
 SensorWrapper* Wrapper;
 
@@ -20,6 +22,14 @@ DLL_EXPORT DepthCameraIntrinsics GetDepthCameraIntrinsics()
 	return Wrapper->GetDepthCameraIntrinsics();
 }
 
+DLL_EXPORT int GetDepthToColorExtrinsics(CameraExtrinsics* extrinsics)
+{
+	if (Wrapper == nullptr || extrinsics == nullptr)
+		return 0;
+
+	return Wrapper->GetDepthToColorExtrinsics(*extrinsics) ? 1 : 0;
+}
+
 DLL_EXPORT void SubscribeToColorFrames(ColorFrameCallback callback)
 {
 	Wrapper->AddColorSubscriber(callback);
@@ -45,6 +55,90 @@ DLL_EXPORT bool IsDeviceAvailable()
 	return Wrapper->IsSensorAvailable();
 }
 
+DLL_EXPORT void StartSharedFramePublishing(const char* name, int slotCount)
+{
+	if (name == nullptr)
+		return;
+
+	Wrapper->StartSharedFramePublishing(name, slotCount);
+}
+
+DLL_EXPORT void StopSharedFramePublishing()
+{
+	Wrapper->StopSharedFramePublishing();
+}
+
+DLL_EXPORT int StartRecording(const char* directory, int bufferedFramesetCount, int chunkLengthMb)
+{
+	if (directory == nullptr)
+		return 0;
+
+	return Wrapper->StartRecording(directory, bufferedFramesetCount, chunkLengthMb) ? 1 : 0;
+}
+
+DLL_EXPORT void StopRecording()
+{
+	Wrapper->StopRecording();
+}
+
+DLL_EXPORT int GetRecordingStats(RecordingStats* stats)
+{
+	if (stats == nullptr)
+		return 0;
+
+	return Wrapper->GetRecordingStats(*stats) ? 1 : 0;
+}
+
+// readers do not need a frame provider of their own, the sensor stays with the process that publishes its frames
+DLL_EXPORT SharedFrameReader* AttachToSharedFrames(const char* name)
+{
+	if (name == nullptr)
+		return nullptr;
+
+	SharedFrameReader* reader = new SharedFrameReader();
+	if (reader->Attach(name))
+		return reader;
+
+	delete reader;
+
+	return nullptr;
+}
+
+DLL_EXPORT int AcquireSharedFrameset(SharedFrameReader* reader, int skipToLatest, SharedFrameset* frameset)
+{
+	if (reader == nullptr || frameset == nullptr)
+		return 0;
+
+	return reader->AcquireFrameset(skipToLatest != 0, *frameset) ? 1 : 0;
+}
+
+DLL_EXPORT int IsSharedFramesetValid(SharedFrameReader* reader, const SharedFrameset* frameset)
+{
+	if (reader == nullptr || frameset == nullptr)
+		return 0;
+
+	return reader->IsFramesetValid(*frameset) ? 1 : 0;
+}
+
+DLL_EXPORT void DetachFromSharedFrames(SharedFrameReader* reader)
+{
+	if (reader != nullptr)
+		delete reader;
+}
+
+DLL_EXPORT void SetTracingEnabled(int enabled)
+{
+	TraceRecorder::SetEnabled(enabled != 0);
+}
+
+DLL_EXPORT int WriteTrace(const char* filepath)
+{
+	if (filepath == nullptr)
+		return 0;
+
+	return TraceRecorder::WriteTrace(filepath) ? 1 : 0;
+}
+
 DLL_EXPORT int DestroyFrameProvider()
 {
 	if (Wrapper == nullptr)
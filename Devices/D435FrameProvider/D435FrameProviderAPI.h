@@ -4,9 +4,12 @@
 
 #define DLL_EXPORT extern "C" _declspec(dllexport)
 
+class SharedFrameReader;
+
 DLL_EXPORT int CreateFrameProvider();
 
 DLL_EXPORT DepthCameraIntrinsics GetDepthCameraIntrinsics();
+DLL_EXPORT int GetDepthToColorExtrinsics(CameraExtrinsics* extrinsics);
 
 DLL_EXPORT void SubscribeToColorFrames(ColorFrameCallback progressCallback);
 DLL_EXPORT void UnsubscribeFromColorFrames(ColorFrameCallback progressCallback);
@@ -16,4 +19,19 @@ DLL_EXPORT void UnsubscribeFromDepthFrames(DepthFrameCallback progressCallback);
 
 DLL_EXPORT bool IsDeviceAvailable();
 
+DLL_EXPORT void StartSharedFramePublishing(const char* name, int slotCount);
+DLL_EXPORT void StopSharedFramePublishing();
+
+DLL_EXPORT int StartRecording(const char* directory, int bufferedFramesetCount, int chunkLengthMb);
+DLL_EXPORT void StopRecording();
+DLL_EXPORT int GetRecordingStats(RecordingStats* stats);
+
+DLL_EXPORT SharedFrameReader* AttachToSharedFrames(const char* name);
+DLL_EXPORT int AcquireSharedFrameset(SharedFrameReader* reader, int skipToLatest, SharedFrameset* frameset);
+DLL_EXPORT int IsSharedFramesetValid(SharedFrameReader* reader, const SharedFrameset* frameset);
+DLL_EXPORT void DetachFromSharedFrames(SharedFrameReader* reader);
+
+DLL_EXPORT void SetTracingEnabled(int enabled);
+DLL_EXPORT int WriteTrace(const char* filepath);
+
 DLL_EXPORT int DestroyFrameProvider();
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "FrameRecorder.h"
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "../../DepthMapProcessor/TraceRecorder.h"
+
+namespace
+{
+	const unsigned int ChunkMagic = 0x43455246; // "FREC"
+	const unsigned int ChunkVersion = 1;
+	const int MinBufferedFramesetCount = 2;
+	const int MinChunkLengthMb = 16;
+	const int ColorBytesPerPixel = 3;
+
+	const std::string GetChunkPath(const std::string& directory, const int chunkIndex)
+	{
+		char filename[32];
+		snprintf(filename, sizeof(filename), "frames_%05d.frec", chunkIndex);
+
+		return directory + "/" + filename;
+	}
+}
+
+FrameRecorder::FrameRecorder(const std::string& directory, const int bufferedFramesetCount, const int chunkLengthMb)
+	: _directory(directory), _chunkLengthBytes((long long)std::max(chunkLengthMb, MinChunkLengthMb) * 1024 * 1024)
+{
+	_buffers.resize(std::max(bufferedFramesetCount, MinBufferedFramesetCount));
+	for (int i = 0; i < _buffers.size(); i++)
+		_freeBuffers.emplace_back(i);
+	_stopping = false;
+
+	_sequence = 0;
+	_recordedCount = 0;
+	_droppedCount = 0;
+	_writtenBytes = 0;
+	_chunkCount = 0;
+	_writeFailed = false;
+
+	_chunkHandle = nullptr;
+	_chunkIndex = 0;
+	_chunkOffsetBytes = 0;
+	_batchFramesetCount = 0;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+	// whatever is queued still goes to disk
+	if (_writerThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_queueLock);
+			_stopping = true;
+		}
+		_queueCondition.notify_one();
+		_writerThread.join();
+	}
+
+	CloseChunk();
+}
+
+const bool FrameRecorder::Start()
+{
+	const bool directoryExists = CreateDirectoryA(_directory.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+	if (!directoryExists || !OpenChunk())
+		return false;
+
+	_writerThread = std::thread(&FrameRecorder::WriteQueuedFramesets, this);
+
+	return true;
+}
+
+const bool FrameRecorder::RecordFrameset(const DepthFrame*const depth, const ColorFrame*const color)
+{
+	TRACE_SCOPE("FrameRecorder::RecordFrameset");
+
+	const bool hasDepth = depth != nullptr && depth->Data != nullptr;
+	const bool hasColor = color != nullptr && color->Data != nullptr;
+	if (!hasDepth && !hasColor)
+		return false;
+
+	_sequence++;
+
+	int bufferIndex = -1;
+	{
+		std::lock_guard<std::mutex> lock(_queueLock);
+		if (!_writeFailed && !_freeBuffers.empty())
+		{
+			bufferIndex = _freeBuffers.back();
+			_freeBuffers.pop_back();
+		}
+	}
+
+	if (bufferIndex < 0)
+	{
+		_droppedCount++;
+		return false;
+	}
+
+	// the buffer belongs to this thread until it is queued
+	FramesetBuffer& buffer = _buffers[bufferIndex];
+	RecordedFramesetHeader& header = buffer.Header;
+	header = RecordedFramesetHeader{};
+	header.Sequence = _sequence;
+
+	int depthLengthBytes = 0;
+	if (hasDepth)
+	{
+		header.DepthFrameNumber = depth->FrameNumber;
+		header.DepthCaptureTimestampUs = depth->CaptureTimestampUs;
+		header.DepthReceivedTimestampUs = depth->ReceivedTimestampUs;
+		header.DepthWidth = depth->Width;
+		header.DepthHeight = depth->Height;
+		depthLengthBytes = depth->Width * depth->Height * sizeof(short);
+	}
+
+	int colorLengthBytes = 0;
+	if (hasColor)
+	{
+		header.ColorFrameNumber = color->FrameNumber;
+		header.ColorCaptureTimestampUs = color->CaptureTimestampUs;
+		header.ColorReceivedTimestampUs = color->ReceivedTimestampUs;
+		header.ColorWidth = color->Width;
+		header.ColorHeight = color->Height;
+		header.ColorBytesPerPixel = ColorBytesPerPixel;
+		colorLengthBytes = color->Width * color->Height * ColorBytesPerPixel;
+	}
+
+	// buffers only grow, after the first framesets of a resolution nothing is allocated any more
+	header.DataLengthBytes = depthLengthBytes + colorLengthBytes;
+	if ((int)buffer.Data.size() < header.DataLengthBytes)
+		buffer.Data.resize(header.DataLengthBytes);
+
+	if (hasDepth)
+		memcpy(buffer.Data.data(), depth->Data, depthLengthBytes);
+	if (hasColor)
+		memcpy(buffer.Data.data() + depthLengthBytes, color->Data, colorLengthBytes);
+
+	{
+		std::lock_guard<std::mutex> lock(_queueLock);
+		_pendingBuffers.emplace_back(bufferIndex);
+	}
+	_queueCondition.notify_one();
+
+	return true;
+}
+
+const RecordingStats FrameRecorder::GetStats() const
+{
+	RecordingStats stats{};
+	stats.RecordedCount = _recordedCount;
+	stats.DroppedCount = _droppedCount;
+	stats.WrittenBytes = _writtenBytes;
+	stats.ChunkCount = _chunkCount;
+	stats.WriteFailed = _writeFailed ? 1 : 0;
+
+	return stats;
+}
+
+void FrameRecorder::WriteQueuedFramesets()
+{
+	std::vector<int> batchBuffers;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_queueLock);
+			_queueCondition.wait(lock, [this] { return _stopping || !_pendingBuffers.empty(); });
+			if (_pendingBuffers.empty())
+				return;
+
+			batchBuffers.assign(_pendingBuffers.begin(), _pendingBuffers.end());
+			_pendingBuffers.clear();
+		}
+
+		TRACE_SCOPE("FrameRecorder::WriteBatch");
+
+		// a buffer is given back as soon as it is in the batch, so capture can reuse it while the batch is written
+		for (int i = 0; i < batchBuffers.size(); i++)
+		{
+			const FramesetBuffer& buffer = _buffers[batchBuffers[i]];
+			if (_writeFailed)
+				_droppedCount++;
+			else
+				AppendToBatch(buffer);
+
+			std::lock_guard<std::mutex> lock(_queueLock);
+			_freeBuffers.emplace_back(batchBuffers[i]);
+		}
+
+		if (!FlushBatch())
+			_writeFailed = true;
+	}
+}
+
+void FrameRecorder::AppendToBatch(const FramesetBuffer& buffer)
+{
+	const int framesetLengthBytes = sizeof(RecordedFramesetHeader) + buffer.Header.DataLengthBytes;
+
+	// the index and the footer have to fit into the chunk as well, a chunk takes at least one frameset
+	const long long chunkLengthAfterFrameset = _chunkOffsetBytes + _batch.size() + framesetLengthBytes +
+		(_chunkIndexEntries.size() + 1) * sizeof(RecordingIndexEntry) + sizeof(RecordingChunkFooter);
+	const bool chunkIsFull = !_chunkIndexEntries.empty() && chunkLengthAfterFrameset > _chunkLengthBytes;
+	if (chunkIsFull)
+	{
+		const bool chunkWasSwitched = FlushBatch() && CloseChunk() && OpenChunk();
+		if (!chunkWasSwitched)
+		{
+			_writeFailed = true;
+			_droppedCount++;
+			return;
+		}
+	}
+
+	if (_batch.size() + framesetLengthBytes > _batchLengthBytes && !FlushBatch())
+	{
+		_writeFailed = true;
+		_droppedCount++;
+		return;
+	}
+
+	_chunkIndexEntries.emplace_back(RecordingIndexEntry{ buffer.Header.Sequence, _chunkOffsetBytes + (long long)_batch.size() });
+
+	const byte*const header = (const byte*)&buffer.Header;
+	_batch.insert(_batch.end(), header, header + sizeof(RecordedFramesetHeader));
+	_batch.insert(_batch.end(), buffer.Data.begin(), buffer.Data.begin() + buffer.Header.DataLengthBytes);
+	_batchFramesetCount++;
+}
+
+const bool FrameRecorder::FlushBatch()
+{
+	if (_batch.empty())
+		return true;
+
+	TRACE_SCOPE("FrameRecorder::FlushBatch");
+
+	// framesets only count as recorded once they are on disk
+	const bool batchWasWritten = WriteToChunk(_batch.data(), (int)_batch.size());
+	if (batchWasWritten)
+		_recordedCount += _batchFramesetCount;
+	else
+		_droppedCount += _batchFramesetCount;
+	_batch.clear();
+	_batchFramesetCount = 0;
+
+	return batchWasWritten;
+}
+
+const bool FrameRecorder::OpenChunk()
+{
+	const std::string& path = GetChunkPath(_directory, _chunkIndex);
+	HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	// the whole chunk is reserved at once, so the file system does not extend the file with every write
+	LARGE_INTEGER chunkLength;
+	chunkLength.QuadPart = _chunkLengthBytes;
+	LARGE_INTEGER chunkStart;
+	chunkStart.QuadPart = 0;
+	const bool chunkIsAllocated = SetFilePointerEx(handle, chunkLength, nullptr, FILE_BEGIN) && SetEndOfFile(handle) &&
+		SetFilePointerEx(handle, chunkStart, nullptr, FILE_BEGIN);
+	if (!chunkIsAllocated)
+	{
+		CloseHandle(handle);
+		return false;
+	}
+
+	_chunkHandle = handle;
+	_chunkOffsetBytes = 0;
+	_chunkIndexEntries.clear();
+
+	RecordingChunkHeader header{};
+	header.Magic = ChunkMagic;
+	header.Version = ChunkVersion;
+	header.ChunkIndex = _chunkIndex;
+	if (!WriteToChunk(&header, sizeof(header)))
+		return false;
+
+	_chunkIndex++;
+	_chunkCount++;
+
+	return true;
+}
+
+const bool FrameRecorder::CloseChunk()
+{
+	if (_chunkHandle == nullptr)
+		return true;
+
+	RecordingChunkFooter footer{};
+	footer.IndexOffsetBytes = _chunkOffsetBytes;
+	footer.FramesetCount = (int)_chunkIndexEntries.size();
+	footer.Magic = ChunkMagic;
+
+	const int indexLengthBytes = (int)(_chunkIndexEntries.size() * sizeof(RecordingIndexEntry));
+	const bool indexWasWritten = WriteToChunk(_chunkIndexEntries.data(), indexLengthBytes) &&
+		WriteToChunk(&footer, sizeof(footer));
+
+	// the part of the preallocated chunk that was not used is given back
+	const bool chunkWasTrimmed = SetEndOfFile((HANDLE)_chunkHandle) != 0;
+	CloseHandle((HANDLE)_chunkHandle);
+	_chunkHandle = nullptr;
+
+	return indexWasWritten && chunkWasTrimmed;
+}
+
+const bool FrameRecorder::WriteToChunk(const void*const data, const int lengthBytes)
+{
+	if (_chunkHandle == nullptr)
+		return false;
+
+	if (lengthBytes == 0)
+		return true;
+
+	DWORD writtenLengthBytes = 0;
+	const bool dataWasWritten = WriteFile((HANDLE)_chunkHandle, data, (DWORD)lengthBytes, &writtenLengthBytes, nullptr) &&
+		writtenLengthBytes == (DWORD)lengthBytes;
+	if (!dataWasWritten)
+		return false;
+
+	_chunkOffsetBytes += lengthBytes;
+	_writtenBytes += lengthBytes;
+
+	return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Structures.h"
+
+// a recording is a directory of chunk files: a header, the framesets, and an index and footer once it is closed
+struct RecordingChunkHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	int ChunkIndex;
+	int Reserved;
+};
+
+struct RecordedFramesetHeader
+{
+	long long Sequence; // counts every frameset offered to the recorder, gaps are framesets that were dropped
+	long long DepthFrameNumber;
+	long long DepthCaptureTimestampUs;
+	long long DepthReceivedTimestampUs;
+	long long ColorFrameNumber;
+	long long ColorCaptureTimestampUs;
+	long long ColorReceivedTimestampUs;
+	int DepthWidth; // 0 if the frameset had no depth frame
+	int DepthHeight;
+	int ColorWidth; // 0 if the frameset had no color frame
+	int ColorHeight;
+	int ColorBytesPerPixel;
+	int DataLengthBytes; // depth and color data following the header
+};
+
+struct RecordingIndexEntry
+{
+	long long Sequence;
+	long long OffsetBytes; // of the frameset's header from the start of the chunk
+};
+
+struct RecordingChunkFooter
+{
+	long long IndexOffsetBytes;
+	int FramesetCount;
+	unsigned int Magic;
+};
+
+// records framesets through buffers allocated up front and a writer thread, drops them rather than holding up capture
+class FrameRecorder
+{
+private:
+	struct FramesetBuffer
+	{
+		RecordedFramesetHeader Header;
+		std::vector<byte> Data;
+	};
+
+	const std::string _directory;
+	const long long _chunkLengthBytes;
+	const int _batchLengthBytes = 8 * 1024 * 1024;
+
+	std::vector<FramesetBuffer> _buffers;
+	std::mutex _queueLock;
+	std::condition_variable _queueCondition;
+	std::vector<int> _freeBuffers;
+	std::deque<int> _pendingBuffers;
+	bool _stopping;
+	std::thread _writerThread;
+
+	long long _sequence;
+	std::atomic<long long> _recordedCount;
+	std::atomic<long long> _droppedCount;
+	std::atomic<long long> _writtenBytes;
+	std::atomic<int> _chunkCount;
+	std::atomic<bool> _writeFailed;
+
+	// only used by the writer thread once it is started
+	void* _chunkHandle;
+	int _chunkIndex;
+	long long _chunkOffsetBytes;
+	std::vector<RecordingIndexEntry> _chunkIndexEntries;
+	std::vector<byte> _batch;
+	int _batchFramesetCount;
+
+public:
+	FrameRecorder(const std::string& directory, const int bufferedFramesetCount, const int chunkLengthMb);
+	~FrameRecorder();
+
+	const bool Start();
+
+	// copies the frames and queues them for the writer thread, returns false if the frameset was dropped
+	const bool RecordFrameset(const DepthFrame*const depth, const ColorFrame*const color);
+	const RecordingStats GetStats() const;
+
+private:
+	void WriteQueuedFramesets();
+	void AppendToBatch(const FramesetBuffer& buffer);
+	const bool FlushBatch();
+	const bool OpenChunk();
+	const bool CloseChunk();
+	const bool WriteToChunk(const void*const data, const int lengthBytes);
+};
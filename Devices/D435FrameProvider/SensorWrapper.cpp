@@ -1,5 +1,6 @@
 #include "SensorWrapper.h"
 #include <algorithm>
+#include "../../DepthMapProcessor/TraceRecorder.h"
 
 const short MIN_DEPTH = 300;
 const short MAX_DEPTH = 10000;
@@ -13,6 +14,8 @@ SensorWrapper::SensorWrapper()
 
 	_running = true;
 	_connected = false;
+	_extrinsicsAreKnown = false;
+	memset(&_depthToColorExtrinsics, 0, sizeof(CameraExtrinsics));
 	_queueThread = std::thread(&SensorWrapper::Run, this);
 	_queueThread.detach();
 }
@@ -55,8 +58,66 @@ DepthCameraIntrinsics SensorWrapper::GetDepthCameraIntrinsics() const
 	return intrinsics;
 }
 
+const bool SensorWrapper::GetDepthToColorExtrinsics(CameraExtrinsics& extrinsics)
+{
+	std::lock_guard<std::mutex> lock(_extrinsicsLock);
+	if (!_extrinsicsAreKnown)
+		return false;
+
+	extrinsics = _depthToColorExtrinsics;
+
+	return true;
+}
+
+void SensorWrapper::StartSharedFramePublishing(const std::string& name, const int slotCount)
+{
+	std::lock_guard<std::mutex> lock(_sharedFrameWriterLock);
+	_sharedFrameWriter = std::unique_ptr<SharedFrameWriter>(new SharedFrameWriter(name, slotCount));
+}
+
+void SensorWrapper::StopSharedFramePublishing()
+{
+	std::lock_guard<std::mutex> lock(_sharedFrameWriterLock);
+	_sharedFrameWriter.reset();
+}
+
+const bool SensorWrapper::StartRecording(const std::string& directory, const int bufferedFramesetCount, const int chunkLengthMb)
+{
+	std::unique_ptr<FrameRecorder> recorder(new FrameRecorder(directory, bufferedFramesetCount, chunkLengthMb));
+	if (!recorder->Start())
+		return false;
+
+	std::lock_guard<std::mutex> lock(_frameRecorderLock);
+	_frameRecorder = std::move(recorder);
+
+	return true;
+}
+
+void SensorWrapper::StopRecording()
+{
+	// the recorder finishes writing outside of the lock, capture goes on in the meantime
+	std::unique_ptr<FrameRecorder> recorder;
+	{
+		std::lock_guard<std::mutex> lock(_frameRecorderLock);
+		recorder = std::move(_frameRecorder);
+	}
+}
+
+const bool SensorWrapper::GetRecordingStats(RecordingStats& stats)
+{
+	std::lock_guard<std::mutex> lock(_frameRecorderLock);
+	if (_frameRecorder == nullptr)
+		return false;
+
+	stats = _frameRecorder->GetStats();
+
+	return true;
+}
+
 ColorFrame* SensorWrapper::GetNextColorFrame(const rs2::video_frame& videoFrame)
 {
+	TRACE_SCOPE("SensorWrapper::GetNextColorFrame");
+
 	const int frameWidth = videoFrame.get_width();
 	const int frameHeight = videoFrame.get_height();
 
@@ -72,12 +133,16 @@ ColorFrame* SensorWrapper::GetNextColorFrame(const rs2::video_frame& videoFrame)
 	}
 
 	ConvertFrameToColorFrame(videoFrame, _colorFrame->Data);
+	_colorFrame->FrameNumber = videoFrame.get_frame_number();
+	_colorFrame->CaptureTimestampUs = GetCaptureTimestampUs(videoFrame);
 
 	return _colorFrame;
 }
 
 DepthFrame* SensorWrapper::GetNextDepthFrame(const rs2::depth_frame& depthFrame)
 {
+	TRACE_SCOPE("SensorWrapper::GetNextDepthFrame");
+
 	const int frameWidth = depthFrame.get_width();
 	const int frameHeight = depthFrame.get_height();
 
@@ -93,49 +158,81 @@ DepthFrame* SensorWrapper::GetNextDepthFrame(const rs2::depth_frame& depthFrame)
 	}
 
 	ConvertFrameToDepthFrame(depthFrame, _depthFrame->Data);
+	_depthFrame->FrameNumber = depthFrame.get_frame_number();
+	_depthFrame->CaptureTimestampUs = GetCaptureTimestampUs(depthFrame);
 
 	return _depthFrame;
 }
 
 void SensorWrapper::Run()
 {
-	_pipe.start();
+	UpdateDepthToColorExtrinsics(_pipe.start());
 
 	while (_running)
 	{
 		try
 		{
 			_connected = false;
-			auto frameset = _pipe.wait_for_frames();
+			rs2::frameset frameset;
+			{
+				TRACE_SCOPE("SensorWrapper::WaitForFrames");
+				frameset = _pipe.wait_for_frames();
+			}
 
 			const rs2::depth_frame& depth = frameset.get_depth_frame();
-			if (depth)
-			{
+			const rs2::video_frame& color = frameset.get_color_frame();
+
+			// subscribers in this process and the recorder get the published frames, so nothing is converted twice
+			SharedFrameset publishedFrameset{};
+			PublishFrameset(depth, color, publishedFrameset);
+
+			if (depth || color)
 				_connected = true;
 
-				if (_depthSubscribers.size() == 0)
-					continue;
+			const bool isRecording = IsRecording();
 
-				DepthFrame* depthFrame = GetNextDepthFrame(depth);
+			DepthFrame* depthFrame = nullptr;
+			if (depth && (isRecording || _depthSubscribers.size() > 0))
+			{
+				depthFrame = publishedFrameset.Depth.Data != nullptr
+					? &publishedFrameset.Depth
+					: GetNextDepthFrame(depth);
+				depthFrame->ReceivedTimestampUs = GetSystemTimestampUs();
+			}
 
-				for (uint i = 0; i < _depthSubscribers.size(); i++)
-					_depthSubscribers[i](depthFrame);
+			ColorFrame* colorFrame = nullptr;
+			if (color && (isRecording || _colorSubscribers.size() > 0))
+			{
+				colorFrame = publishedFrameset.Color.Data != nullptr
+					? &publishedFrameset.Color
+					: GetNextColorFrame(color);
+				colorFrame->ReceivedTimestampUs = GetSystemTimestampUs();
 			}
 
-			const rs2::video_frame& color = frameset.get_color_frame();
-			if (color)
+			if (isRecording)
+				RecordFrameset(depthFrame, colorFrame);
+
+			if (depthFrame != nullptr && _depthSubscribers.size() > 0)
 			{
-				_connected = true;
+				TRACE_SCOPE("SensorWrapper::DispatchDepthFrame");
 
-				if (_colorSubscribers.size() == 0)
-					continue;
+				for (uint i = 0; i < _depthSubscribers.size(); i++)
+				{
+					TRACE_SCOPE("SensorWrapper::DepthSubscriberCallback");
+					_depthSubscribers[i](depthFrame);
+				}
+			}
 
-				ColorFrame* depthFrame = GetNextColorFrame(color);
+			if (colorFrame != nullptr && _colorSubscribers.size() > 0)
+			{
+				TRACE_SCOPE("SensorWrapper::DispatchColorFrame");
 
 				for (uint i = 0; i < _colorSubscribers.size(); i++)
-					_colorSubscribers[i](depthFrame);
+				{
+					TRACE_SCOPE("SensorWrapper::ColorSubscriberCallback");
+					_colorSubscribers[i](colorFrame);
+				}
 			}
-
 		}
 		catch (std::exception ex)
 		{
@@ -144,6 +241,92 @@ void SensorWrapper::Run()
 	}
 }
 
+void SensorWrapper::UpdateDepthToColorExtrinsics(const rs2::pipeline_profile& profile)
+{
+	// the extrinsics stay unknown if the pipeline has no color stream
+	try
+	{
+		const rs2::stream_profile& depthProfile = profile.get_stream(RS2_STREAM_DEPTH);
+		const rs2_extrinsics& extrinsics = depthProfile.get_extrinsics_to(profile.get_stream(RS2_STREAM_COLOR));
+
+		std::lock_guard<std::mutex> lock(_extrinsicsLock);
+		memcpy(_depthToColorExtrinsics.Rotation, extrinsics.rotation, sizeof(_depthToColorExtrinsics.Rotation));
+		for (int i = 0; i < 3; i++)
+			_depthToColorExtrinsics.Translation[i] = extrinsics.translation[i] * 1000;
+		_extrinsicsAreKnown = true;
+	}
+	catch (std::exception ex)
+	{
+	}
+}
+
+void SensorWrapper::PublishFrameset(const rs2::depth_frame& depth, const rs2::video_frame& color,
+	SharedFrameset& frameset)
+{
+	std::lock_guard<std::mutex> lock(_sharedFrameWriterLock);
+
+	if (_sharedFrameWriter == nullptr || (!depth && !color))
+		return;
+
+	TRACE_SCOPE("SensorWrapper::PublishFrameset");
+
+	DepthFrame depthInfo{};
+	if (depth)
+	{
+		depthInfo.Width = depth.get_width();
+		depthInfo.Height = depth.get_height();
+		depthInfo.FrameNumber = depth.get_frame_number();
+		depthInfo.CaptureTimestampUs = GetCaptureTimestampUs(depth);
+	}
+
+	ColorFrame colorInfo{};
+	if (color)
+	{
+		colorInfo.Width = color.get_width();
+		colorInfo.Height = color.get_height();
+		colorInfo.FrameNumber = color.get_frame_number();
+		colorInfo.CaptureTimestampUs = GetCaptureTimestampUs(color);
+	}
+
+	if (!_sharedFrameWriter->BeginFrameset(depthInfo, colorInfo, frameset))
+	{
+		frameset = SharedFrameset{};
+		return;
+	}
+
+	if (depth)
+		ConvertFrameToDepthFrame(depth, frameset.Depth.Data);
+
+	if (color)
+		ConvertFrameToColorFrame(color, frameset.Color.Data);
+
+	_sharedFrameWriter->EndFrameset();
+}
+
+const bool SensorWrapper::IsRecording()
+{
+	std::lock_guard<std::mutex> lock(_frameRecorderLock);
+
+	return _frameRecorder != nullptr;
+}
+
+void SensorWrapper::RecordFrameset(const DepthFrame*const depthFrame, const ColorFrame*const colorFrame)
+{
+	std::lock_guard<std::mutex> lock(_frameRecorderLock);
+
+	if (_frameRecorder != nullptr)
+		_frameRecorder->RecordFrameset(depthFrame, colorFrame);
+}
+
+const long long SensorWrapper::GetCaptureTimestampUs(const rs2::frame& frame)
+{
+	// only global and system time are host clock times, hardware clock timestamps can not be compared with them
+	const rs2_timestamp_domain domain = frame.get_frame_timestamp_domain();
+	const bool isHostTime = domain == RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME || domain == RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME;
+
+	return isHostTime ? (long long)(frame.get_timestamp() * 1000) : 0;
+}
+
 void SensorWrapper::ConvertFrameToColorFrame(const rs2::video_frame& frame, byte*const data)
 {
 	const int frameSize = frame.get_width() * frame.get_height() * 3;
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <librealsense2/rs.hpp>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <thread>
 #include "Structures.h"
+#include "SharedFrameRing.h"
+#include "FrameRecorder.h"
 
 class SensorWrapper
 {
@@ -20,6 +24,16 @@ private:
 	ColorFrame* _colorFrame;
 	DepthFrame* _depthFrame;
 
+	std::mutex _sharedFrameWriterLock;
+	std::unique_ptr<SharedFrameWriter> _sharedFrameWriter;
+
+	std::mutex _frameRecorderLock;
+	std::unique_ptr<FrameRecorder> _frameRecorder;
+
+	std::mutex _extrinsicsLock;
+	bool _extrinsicsAreKnown;
+	CameraExtrinsics _depthToColorExtrinsics;
+
 public:
 	SensorWrapper();
 	~SensorWrapper();
@@ -33,12 +47,26 @@ public:
 	void RemoveDepthSubscriber(DepthFrameCallback callback);
 
 	DepthCameraIntrinsics GetDepthCameraIntrinsics() const;
+	// known once the streams are started
+	const bool GetDepthToColorExtrinsics(CameraExtrinsics& extrinsics);
+
+	void StartSharedFramePublishing(const std::string& name, const int slotCount);
+	void StopSharedFramePublishing();
+
+	const bool StartRecording(const std::string& directory, const int bufferedFramesetCount, const int chunkLengthMb);
+	void StopRecording();
+	const bool GetRecordingStats(RecordingStats& stats);
 
 	ColorFrame* GetNextColorFrame(const rs2::video_frame& videoFrame);
 	DepthFrame* GetNextDepthFrame(const rs2::depth_frame& depthFrame);
 
 private:
 	void Run();
+	void UpdateDepthToColorExtrinsics(const rs2::pipeline_profile& profile);
+	void PublishFrameset(const rs2::depth_frame& depth, const rs2::video_frame& color, SharedFrameset& frameset);
+	const bool IsRecording();
+	void RecordFrameset(const DepthFrame*const depthFrame, const ColorFrame*const colorFrame);
+	static const long long GetCaptureTimestampUs(const rs2::frame& frame);
 	void ConvertFrameToDepthFrame(const rs2::depth_frame& frame, short*const data);
 	void ConvertFrameToColorFrame(const rs2::video_frame& frame, byte*const data);
 };
\ No newline at end of file
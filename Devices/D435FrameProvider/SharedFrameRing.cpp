@@ -0,0 +1,298 @@
+#include "SharedFrameRing.h"
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	const unsigned int RingMagic = 0x46524E47; // "FRNG"
+	const unsigned int RingVersion = 2;
+	const int MinSlotCount = 3;
+	const int Alignment = 64;
+
+	const int Align(const int length)
+	{
+		return (length + Alignment - 1) / Alignment * Alignment;
+	}
+
+	const int GetHeaderLength()
+	{
+		return Align(sizeof(SharedFrameRingHeader));
+	}
+
+	const int GetSlotTableLength(const int slotCount)
+	{
+		return Align(slotCount * sizeof(SharedFrameSlot));
+	}
+
+	const int GetSlotLength(const int depthWidth, const int depthHeight, const int colorWidth, const int colorHeight)
+	{
+		return Align(depthWidth * depthHeight * sizeof(short)) + Align(colorWidth * colorHeight * 3);
+	}
+
+	const bool FramesetFitsSlot(const SharedFrameset& frameset, const int slotLengthBytes)
+	{
+		const bool sizesAreValid = frameset.Depth.Width >= 0 && frameset.Depth.Height >= 0 &&
+			frameset.Color.Width >= 0 && frameset.Color.Height >= 0;
+		if (!sizesAreValid)
+			return false;
+
+		// the color data starts after the aligned depth data, as laid out by GetSlotLength
+		const long long depthLength = (long long)frameset.Depth.Width * frameset.Depth.Height * sizeof(short);
+		const long long alignedDepthLength = (depthLength + Alignment - 1) / Alignment * Alignment;
+		const long long colorLength = (long long)frameset.Color.Width * frameset.Color.Height * 3;
+
+		return alignedDepthLength + colorLength <= slotLengthBytes;
+	}
+
+	void FillFrameset(const SharedFrameSlot& slot, const long long sequence, byte*const slotData, SharedFrameset& frameset)
+	{
+		frameset.Sequence = sequence;
+
+		frameset.Depth.Width = slot.DepthWidth;
+		frameset.Depth.Height = slot.DepthHeight;
+		frameset.Depth.Data = slot.DepthWidth > 0 ? (short*)slotData : nullptr;
+		frameset.Depth.FrameNumber = slot.DepthFrameNumber;
+		frameset.Depth.CaptureTimestampUs = slot.DepthTimestampUs;
+		frameset.Depth.ReceivedTimestampUs = 0;
+
+		const int depthLength = Align(slot.DepthWidth * slot.DepthHeight * sizeof(short));
+		frameset.Color.Width = slot.ColorWidth;
+		frameset.Color.Height = slot.ColorHeight;
+		frameset.Color.Data = slot.ColorWidth > 0 ? slotData + depthLength : nullptr;
+		frameset.Color.FrameNumber = slot.ColorFrameNumber;
+		frameset.Color.CaptureTimestampUs = slot.ColorTimestampUs;
+		frameset.Color.ReceivedTimestampUs = 0;
+	}
+}
+
+const long long GetSystemTimestampUs()
+{
+	const auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count();
+}
+
+SharedFrameWriter::SharedFrameWriter(const std::string& name, const int slotCount)
+	: _name(name), _slotCount(std::max(slotCount, MinSlotCount))
+{
+	_mappingHandle = nullptr;
+	_header = nullptr;
+	_slots = nullptr;
+	_slotData = nullptr;
+
+	_sequence = 0;
+	_pendingSlot = nullptr;
+}
+
+SharedFrameWriter::~SharedFrameWriter()
+{
+	if (_header != nullptr)
+		UnmapViewOfFile(_header);
+
+	if (_mappingHandle != nullptr)
+		CloseHandle(_mappingHandle);
+}
+
+const bool SharedFrameWriter::BeginFrameset(const DepthFrame& depth, const ColorFrame& color, SharedFrameset& frameset)
+{
+	const int slotLength = GetSlotLength(depth.Width, depth.Height, color.Width, color.Height);
+	if (_header == nullptr && !CreateMapping(slotLength))
+		return false;
+
+	if (slotLength > _header->SlotLengthBytes)
+		return false;
+
+	_sequence++;
+	const int slotIndex = (int)(_sequence % _slotCount);
+	SharedFrameSlot& slot = _slots[slotIndex];
+
+	// readers holding this slot see it change before any of its data does
+	slot.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.DepthFrameNumber = depth.FrameNumber;
+	slot.DepthTimestampUs = depth.CaptureTimestampUs;
+	slot.ColorFrameNumber = color.FrameNumber;
+	slot.ColorTimestampUs = color.CaptureTimestampUs;
+	slot.DepthWidth = depth.Width;
+	slot.DepthHeight = depth.Height;
+	slot.ColorWidth = color.Width;
+	slot.ColorHeight = color.Height;
+
+	FillFrameset(slot, _sequence, _slotData + (long long)slotIndex * _header->SlotLengthBytes, frameset);
+	frameset.SkippedCount = 0;
+	_pendingSlot = &slot;
+
+	return true;
+}
+
+void SharedFrameWriter::EndFrameset()
+{
+	if (_pendingSlot == nullptr)
+		return;
+
+	_pendingSlot->Sequence.store(_sequence, std::memory_order_release);
+	_header->LatestSequence.store(_sequence, std::memory_order_release);
+	_pendingSlot = nullptr;
+}
+
+const bool SharedFrameWriter::CreateMapping(const int slotLengthBytes)
+{
+	const long long mappingLength = GetHeaderLength() + GetSlotTableLength(_slotCount) + (long long)_slotCount * slotLengthBytes;
+
+	_mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		(DWORD)(mappingLength >> 32), (DWORD)(mappingLength & 0xFFFFFFFF), _name.c_str());
+	if (_mappingHandle == nullptr)
+		return false;
+
+	const bool mappingExisted = GetLastError() == ERROR_ALREADY_EXISTS;
+
+	byte* view = (byte*)MapViewOfFile(_mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(_mappingHandle);
+		_mappingHandle = nullptr;
+		return false;
+	}
+
+	_header = (SharedFrameRingHeader*)view;
+	_slots = (SharedFrameSlot*)(view + GetHeaderLength());
+	_slotData = view + GetHeaderLength() + GetSlotTableLength(_slotCount);
+
+	// readers of a previous writer may still keep the ring alive, it is reused if it has the same shape
+	if (mappingExisted)
+	{
+		const bool ringIsCompatible = _header->Magic == RingMagic && _header->Version == RingVersion &&
+			_header->SlotCount == _slotCount && _header->SlotLengthBytes >= slotLengthBytes;
+		if (!ringIsCompatible)
+		{
+			UnmapViewOfFile(view);
+			CloseHandle(_mappingHandle);
+			_mappingHandle = nullptr;
+			_header = nullptr;
+			return false;
+		}
+
+		_sequence = _header->LatestSequence.load(std::memory_order_acquire);
+
+		return true;
+	}
+
+	_header->Version = RingVersion;
+	_header->SlotCount = _slotCount;
+	_header->SlotLengthBytes = slotLengthBytes;
+	_header->LatestSequence.store(0, std::memory_order_relaxed);
+	for (int i = 0; i < _slotCount; i++)
+		_slots[i].Sequence.store(0, std::memory_order_relaxed);
+
+	// the magic goes last, readers do not use a ring without it
+	std::atomic_thread_fence(std::memory_order_release);
+	_header->Magic = RingMagic;
+
+	return true;
+}
+
+SharedFrameReader::SharedFrameReader()
+{
+	_mappingHandle = nullptr;
+	_header = nullptr;
+	_slots = nullptr;
+	_slotData = nullptr;
+
+	_lastSequence = 0;
+}
+
+SharedFrameReader::~SharedFrameReader()
+{
+	if (_header != nullptr)
+		UnmapViewOfFile(_header);
+
+	if (_mappingHandle != nullptr)
+		CloseHandle(_mappingHandle);
+}
+
+const bool SharedFrameReader::Attach(const std::string& name)
+{
+	if (_header != nullptr)
+		return true;
+
+	_mappingHandle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+	if (_mappingHandle == nullptr)
+		return false;
+
+	const byte* view = (const byte*)MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	const SharedFrameRingHeader* header = (const SharedFrameRingHeader*)view;
+	const bool ringIsReady = view != nullptr && header->Magic == RingMagic && header->Version == RingVersion;
+	if (!ringIsReady)
+	{
+		if (view != nullptr)
+			UnmapViewOfFile(view);
+		CloseHandle(_mappingHandle);
+		_mappingHandle = nullptr;
+		return false;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	_header = header;
+	_slots = (const SharedFrameSlot*)(view + GetHeaderLength());
+	_slotData = view + GetHeaderLength() + GetSlotTableLength(header->SlotCount);
+
+	return true;
+}
+
+const bool SharedFrameReader::AcquireFrameset(const bool skipToLatest, SharedFrameset& frameset)
+{
+	if (_header == nullptr)
+		return false;
+
+	const long long latestSequence = _header->LatestSequence.load(std::memory_order_acquire);
+	if (latestSequence <= _lastSequence)
+		return false;
+
+	// the writer may already be refilling the slot after the latest one, the oldest slot is left to it
+	const long long oldestSafeSequence = std::max(latestSequence - _header->SlotCount + 2, 1LL);
+	const bool isFirstFrameset = _lastSequence == 0;
+	const long long sequence = skipToLatest || isFirstFrameset
+		? latestSequence
+		: std::max(_lastSequence + 1, oldestSafeSequence);
+
+	const int slotIndex = (int)(sequence % _header->SlotCount);
+	const SharedFrameSlot& slot = _slots[slotIndex];
+	if (slot.Sequence.load(std::memory_order_acquire) != sequence)
+		return false;
+
+	FillFrameset(slot, sequence, (byte*)_slotData + (long long)slotIndex * _header->SlotLengthBytes, frameset);
+
+	// the writer may have taken the slot while its description was read, the sizes can be torn then
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (slot.Sequence.load(std::memory_order_relaxed) != sequence)
+		return false;
+
+	if (!FramesetFitsSlot(frameset, _header->SlotLengthBytes))
+		return false;
+
+	frameset.SkippedCount = isFirstFrameset ? 0 : (int)(sequence - _lastSequence - 1);
+
+	// the frames reach this process now, however long ago they were published
+	const long long receivedTimestampUs = GetSystemTimestampUs();
+	frameset.Depth.ReceivedTimestampUs = receivedTimestampUs;
+	frameset.Color.ReceivedTimestampUs = receivedTimestampUs;
+	_lastSequence = sequence;
+
+	return true;
+}
+
+const bool SharedFrameReader::IsFramesetValid(const SharedFrameset& frameset) const
+{
+	if (_header == nullptr)
+		return false;
+
+	// everything read from the view before this point was read before the writer could have touched the slot again
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	const SharedFrameSlot& slot = _slots[frameset.Sequence % _header->SlotCount];
+
+	return slot.Sequence.load(std::memory_order_relaxed) == frameset.Sequence;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "Structures.h"
+
+// shared memory: the header, a descriptor per slot, then the slots' data; a slot's sequence is 0 while it is written
+struct SharedFrameRingHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	int SlotCount;
+	int SlotLengthBytes;
+	std::atomic<long long> LatestSequence;
+};
+
+struct SharedFrameSlot
+{
+	std::atomic<long long> Sequence;
+	long long DepthFrameNumber;
+	long long DepthTimestampUs;
+	long long ColorFrameNumber;
+	long long ColorTimestampUs;
+	int DepthWidth;
+	int DepthHeight;
+	int ColorWidth;
+	int ColorHeight;
+};
+
+// microseconds of the host's system clock, the clock frame timestamps are given in
+const long long GetSystemTimestampUs();
+
+// publishes framesets into a named shared memory ring that is sized by the first frameset
+class SharedFrameWriter
+{
+private:
+	const std::string _name;
+	const int _slotCount;
+
+	void* _mappingHandle;
+	SharedFrameRingHeader* _header;
+	SharedFrameSlot* _slots;
+	byte* _slotData;
+
+	long long _sequence;
+	SharedFrameSlot* _pendingSlot;
+
+public:
+	SharedFrameWriter(const std::string& name, const int slotCount);
+	~SharedFrameWriter();
+
+	// points the frameset to the buffers of the next slot, they are published by EndFrameset;
+	// the frames only describe the size and timing of the frameset, their data is not used
+	const bool BeginFrameset(const DepthFrame& depth, const ColorFrame& color, SharedFrameset& frameset);
+	void EndFrameset();
+
+private:
+	const bool CreateMapping(const int slotLengthBytes);
+};
+
+// attaches to another process's ring, a view stays usable until IsFramesetValid tells that its slot was reused
+class SharedFrameReader
+{
+private:
+	void* _mappingHandle;
+	const SharedFrameRingHeader* _header;
+	const SharedFrameSlot* _slots;
+	const byte* _slotData;
+
+	long long _lastSequence;
+
+public:
+	SharedFrameReader();
+	~SharedFrameReader();
+
+	const bool Attach(const std::string& name);
+	const bool AcquireFrameset(const bool skipToLatest, SharedFrameset& frameset);
+	const bool IsFramesetValid(const SharedFrameset& frameset) const;
+};
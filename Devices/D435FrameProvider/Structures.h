@@ -3,11 +3,16 @@
 typedef unsigned char byte;
 typedef unsigned int uint;
 
+// frame timestamps are microseconds of the host's system clock, the capture timestamp is 0 if the device clock is not
+// synchronized with it
 struct ColorFrame
 {
 	int Width;
 	int Height;
 	byte* Data;
+	long long FrameNumber;
+	long long CaptureTimestampUs;
+	long long ReceivedTimestampUs; // when the frame was handed to subscribers
 };
 
 struct DepthFrame
@@ -15,6 +20,27 @@ struct DepthFrame
 	int Width;
 	int Height;
 	short* Data;
+	long long FrameNumber;
+	long long CaptureTimestampUs;
+	long long ReceivedTimestampUs; // when the frame was handed to subscribers
+};
+
+// a frameset published through shared memory, frame data points into the shared ring and is not owned
+struct SharedFrameset
+{
+	long long Sequence;
+	int SkippedCount; // framesets published since the previously acquired one that were never handed out
+	DepthFrame Depth; // empty if the frameset had no depth frame
+	ColorFrame Color; // empty if the frameset had no color frame
+};
+
+struct RecordingStats
+{
+	long long RecordedCount; // framesets that are on disk
+	long long DroppedCount; // framesets that found no free buffer or could not be written
+	long long WrittenBytes;
+	int ChunkCount;
+	int WriteFailed; // nothing is recorded after the first failed write
 };
 
 struct ColorCameraIntrinsics
@@ -33,6 +59,12 @@ struct DepthCameraIntrinsics
 	float PrincipalPointY;
 };
 
+struct CameraExtrinsics
+{
+	float Rotation[9]; // column-major
+	float Translation[3]; // millimeters
+};
+
 typedef void(__stdcall * ColorFrameCallback)(ColorFrame*);
 
 typedef void(__stdcall * DepthFrameCallback)(DepthFrame*);
\ No newline at end of file
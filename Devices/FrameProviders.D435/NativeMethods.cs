@@ -1,4 +1,5 @@
-﻿using System.Runtime.InteropServices;
+﻿using System;
+using System.Runtime.InteropServices;
 using DeviceIntegration.Native;
 
 namespace FrameProviders.D435
@@ -19,6 +20,9 @@ namespace FrameProviders.D435
 		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern DepthCameraIntrinsics GetDepthCameraIntrinsics();
 
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int GetDepthToColorExtrinsics(out SensorExtrinsics extrinsics);
+
 		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern void SubscribeToColorFrames(ColorFrameCallback progressCallback);
 
@@ -33,5 +37,38 @@ namespace FrameProviders.D435
 
 		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern int DestroyFrameProvider();
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern void StartSharedFramePublishing(string name, int slotCount);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void StopSharedFramePublishing();
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern int StartRecording(string directory, int bufferedFramesetCount, int chunkLengthMb);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void StopRecording();
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int GetRecordingStats(out RecordingStats stats);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern IntPtr AttachToSharedFrames(string name);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int AcquireSharedFrameset(IntPtr reader, int skipToLatest, SharedFrameset* frameset);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int IsSharedFramesetValid(IntPtr reader, SharedFrameset* frameset);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void DetachFromSharedFrames(IntPtr reader);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetTracingEnabled(int enabled);
+
+		[DllImport(LibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern int WriteTrace(string filepath);
 	}
 }
@@ -12,6 +12,7 @@ namespace FrameProviders.D435
 		public void Initialize(IPluginToolset toolset)
 		{
 			toolset.DeviceRegistrator.RegisterDevice(DeviceType.DepthCamera, "d435", typeof(RealsenseD435FrameProvider));
+			toolset.DeviceRegistrator.RegisterDevice(DeviceType.DepthCamera, "d435shared", typeof(RealsenseD435SharedFrameProvider));
 		}
 	}
 }
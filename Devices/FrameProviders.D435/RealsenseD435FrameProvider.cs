@@ -9,12 +9,24 @@ namespace FrameProviders.D435
 {
 	internal class RealsenseD435FrameProvider : FrameProvider
 	{
+		// other processes on this machine read the sensor's frames from here instead of opening the sensor
+		internal const string SharedFramesName = "VolumeCalculatorD435Frames";
+		private const int SharedFrameSlotCount = 4;
+		// frames queued in the streams plus the ones their subscribers hold on to
+		internal const int PooledFrameCount = 8;
+		// about 110MB of framesets at 848x480 depth and 640x480 color, over half a second of disk stalls at 90 fps
+		private const int RecordingBufferedFramesetCount = 64;
+		private const int RecordingChunkLengthMb = 1024;
+
 		private readonly NativeMethods.ColorFrameCallback _colorFrameCallback;
 		private readonly NativeMethods.DepthFrameCallback _depthFramesCallback;
 
 		private readonly object _colorFrameProcessingLock;
 		private readonly object _depthFrameProcessingLock;
 
+		private FrameBufferPool<byte> _colorBufferPool;
+		private FrameBufferPool<short> _depthBufferPool;
+
 		public RealsenseD435FrameProvider(ILogger logger)
 			: base(logger)
 		{
@@ -34,6 +46,7 @@ namespace FrameProviders.D435
 		{
 			Logger.LogInfo("Starting Realsense D435 frame receiver...");
 			NativeMethods.CreateFrameProvider();
+			NativeMethods.StartSharedFramePublishing(SharedFramesName, SharedFrameSlotCount);
 			NativeMethods.SubscribeToColorFrames(_colorFrameCallback);
 			NativeMethods.SubscribeToDepthFrames(_depthFramesCallback);
 		}
@@ -43,16 +56,50 @@ namespace FrameProviders.D435
 			Logger.LogInfo("Disposing Realsense D435 frame receiver...");
 			NativeMethods.UnsubscribeFromColorFrames(_colorFrameCallback);
 			NativeMethods.UnsubscribeFromDepthFrames(_depthFramesCallback);
+			NativeMethods.StopRecording();
+			NativeMethods.StopSharedFramePublishing();
 			NativeMethods.DestroyFrameProvider();
 			base.Dispose();
 		}
 
 		public override ColorCameraParams GetColorCameraParams()
 		{
-			return new ColorCameraParams(69.4f, 42.5f, 1376.13f, 1376.61f, 956.491f, 544.128f);
+			return GetD435ColorCameraParams();
 		}
 
 		public override DepthCameraParams GetDepthCameraParams()
+		{
+			return GetD435DepthCameraParams();
+		}
+
+		public override CameraExtrinsics GetDepthToColorExtrinsics()
+		{
+			// the sensor's own calibration is only known once its streams are started
+			if (NativeMethods.GetDepthToColorExtrinsics(out var extrinsics) == 0)
+			{
+				Logger.LogInfo("Realsense D435 extrinsics are not known yet, using the nominal ones");
+				return GetD435DepthToColorExtrinsics();
+			}
+
+			var rotation = new float[9];
+			var translationMm = new float[3];
+			unsafe
+			{
+				for (var i = 0; i < rotation.Length; i++)
+					rotation[i] = extrinsics.Rotation[i];
+				for (var i = 0; i < translationMm.Length; i++)
+					translationMm[i] = extrinsics.Translation[i];
+			}
+
+			return new CameraExtrinsics(rotation, translationMm);
+		}
+
+		internal static ColorCameraParams GetD435ColorCameraParams()
+		{
+			return new ColorCameraParams(69.4f, 42.5f, 1376.13f, 1376.61f, 956.491f, 544.128f);
+		}
+
+		internal static DepthCameraParams GetD435DepthCameraParams()
 		{
 			//var intristics = NativeMethods.GetDepthCameraIntrinsics();
 			//if (intristics == null)
@@ -62,6 +109,12 @@ namespace FrameProviders.D435
 			//	intristics.PrincipalPointX, intristics.PrincipalPointY, 300, 10000);
 		}
 
+		// the color camera sits about 15mm along X from the depth origin, the left imager, and looks the same way
+		internal static CameraExtrinsics GetD435DepthToColorExtrinsics()
+		{
+			return new CameraExtrinsics(new float[] { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, new float[] { 15, 0, 0 });
+		}
+
 		public override void SuspendColorStream()
 		{
 			if (ColorFrameStream.IsSuspended)
@@ -102,6 +155,45 @@ namespace FrameProviders.D435
 			DepthFrameStream.IsSuspended = false;
 		}
 
+		public override void SetNativeTracingEnabled(bool enabled)
+		{
+			NativeMethods.SetTracingEnabled(enabled ? 1 : 0);
+		}
+
+		public override bool WriteNativeTrace(string filepath)
+		{
+			return NativeMethods.WriteTrace(filepath) != 0;
+		}
+
+		public override bool StartRecording(string directory)
+		{
+			Logger.LogInfo($"Starting to record Realsense D435 frames to {directory}...");
+
+			var recordingStarted = NativeMethods.StartRecording(directory, RecordingBufferedFramesetCount, RecordingChunkLengthMb) != 0;
+			if (!recordingStarted)
+				Logger.LogError($"Failed to start recording to {directory}");
+
+			return recordingStarted;
+		}
+
+		public override void StopRecording()
+		{
+			var stats = GetRecordingStats();
+			NativeMethods.StopRecording();
+
+			if (stats != null)
+				Logger.LogInfo($"Stopped recording Realsense D435 frames, {stats.RecordedCount} framesets recorded, {stats.DroppedCount} dropped");
+		}
+
+		public override FrameRecordingStats GetRecordingStats()
+		{
+			if (NativeMethods.GetRecordingStats(out var stats) == 0)
+				return null;
+
+			return new FrameRecordingStats(stats.RecordedCount, stats.DroppedCount, stats.WrittenBytes, stats.ChunkCount,
+				stats.WriteFailed != 0);
+		}
+
 		private unsafe void ColorFrameCallback(ColorFrame* frame)
 		{
 			if (frame == null)
@@ -115,11 +207,12 @@ namespace FrameProviders.D435
 				try
 				{
 					var dataLength = frame->Width * frame->Height * 3;
+					if (_colorBufferPool?.BufferLength != dataLength)
+						_colorBufferPool = new FrameBufferPool<byte>(dataLength, PooledFrameCount);
 
-					var data = new byte[dataLength];
-					Marshal.Copy(new IntPtr(frame->Data), data, 0, data.Length);
-
-					var image = new ImageData(frame->Width, frame->Height, data, 3);
+					var timing = new FrameTiming(frame->FrameNumber, frame->CaptureTimestampUs, frame->ReceivedTimestampUs);
+					var image = new ImageData(frame->Width, frame->Height, 3, _colorBufferPool, timing);
+					Marshal.Copy(new IntPtr(frame->Data), image.Data, 0, image.Data.Length);
 
 					ColorFrameStream.PushFrame(image);
 				}
@@ -143,9 +236,12 @@ namespace FrameProviders.D435
 				try
 				{
 					var mapLength = frame->Width * frame->Height;
-					var data = new short[mapLength];
-					Marshal.Copy(new IntPtr(frame->Data), data, 0, data.Length);
-					var depthMap = new DepthMap(frame->Width, frame->Height, data);
+					if (_depthBufferPool?.BufferLength != mapLength)
+						_depthBufferPool = new FrameBufferPool<short>(mapLength, PooledFrameCount);
+
+					var timing = new FrameTiming(frame->FrameNumber, frame->CaptureTimestampUs, frame->ReceivedTimestampUs);
+					var depthMap = new DepthMap(frame->Width, frame->Height, _depthBufferPool, timing);
+					Marshal.Copy(new IntPtr(frame->Data), depthMap.Data, 0, depthMap.Data.Length);
 
 					DepthFrameStream.PushFrame(depthMap);
 				}
@@ -0,0 +1,148 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+using System.Threading.Tasks;
+using DeviceIntegration.FrameProviders;
+using Primitives;
+using Primitives.Logging;
+
+namespace FrameProviders.D435
+{
+	// Reads the frames a D435 frame provider of another process publishes, the sensor stays with that process.
+	// Only the copy into managed frames is made here, and frames the publisher overwrote during the copy are dropped.
+	internal class RealsenseD435SharedFrameProvider : FrameProvider
+	{
+		private const int PollingIntervalMs = 5;
+		private const int AttachRetryIntervalMs = 1000;
+
+		private IntPtr _reader;
+		private FrameBufferPool<byte> _colorBufferPool;
+		private FrameBufferPool<short> _depthBufferPool;
+		private bool _started;
+
+		public RealsenseD435SharedFrameProvider(ILogger logger)
+			: base(logger)
+		{
+			Logger.LogInfo("Creating shared Realsense D435 frame receiver...");
+		}
+
+		public override ColorCameraParams GetColorCameraParams()
+		{
+			return RealsenseD435FrameProvider.GetD435ColorCameraParams();
+		}
+
+		public override DepthCameraParams GetDepthCameraParams()
+		{
+			return RealsenseD435FrameProvider.GetD435DepthCameraParams();
+		}
+
+		public override CameraExtrinsics GetDepthToColorExtrinsics()
+		{
+			return RealsenseD435FrameProvider.GetD435DepthToColorExtrinsics();
+		}
+
+		public override void Start()
+		{
+			if (_started)
+				return;
+
+			_started = true;
+			Logger.LogInfo("Starting shared Realsense D435 frame receiver...");
+
+			Paused = false;
+			Task.Factory.StartNew(o => ReadFrames(TokenSource), TaskCreationOptions.LongRunning, TokenSource.Token);
+		}
+
+		public override void Dispose()
+		{
+			Logger.LogInfo("Disposing shared Realsense D435 frame receiver...");
+			_started = false;
+			TokenSource.Cancel();
+			base.Dispose();
+		}
+
+		private async Task ReadFrames(CancellationTokenSource tokenSource)
+		{
+			try
+			{
+				while (!tokenSource.IsCancellationRequested && _reader == IntPtr.Zero)
+				{
+					_reader = NativeMethods.AttachToSharedFrames(RealsenseD435FrameProvider.SharedFramesName);
+					if (_reader == IntPtr.Zero)
+						await Task.Delay(AttachRetryIntervalMs);
+				}
+
+				Logger.LogInfo("Attached to shared Realsense D435 frames");
+
+				while (!tokenSource.IsCancellationRequested)
+				{
+					if (!ReadNextFrameset())
+						await Task.Delay(PollingIntervalMs);
+				}
+			}
+			catch (Exception ex)
+			{
+				Logger.LogException("Failed to read shared Realsense D435 frames", ex);
+			}
+			finally
+			{
+				if (_reader != IntPtr.Zero)
+				{
+					NativeMethods.DetachFromSharedFrames(_reader);
+					_reader = IntPtr.Zero;
+				}
+			}
+		}
+
+		private unsafe bool ReadNextFrameset()
+		{
+			var frameset = new SharedFrameset();
+			if (NativeMethods.AcquireSharedFrameset(_reader, 1, &frameset) == 0)
+				return false;
+
+			var needColorFrame = frameset.Color.Data != null && !ColorFrameStream.IsSuspended && ColorFrameStream.NeedAnyFrame;
+			var needDepthFrame = frameset.Depth.Data != null && !DepthFrameStream.IsSuspended && DepthFrameStream.NeedAnyFrame;
+
+			ImageData image = null;
+			if (needColorFrame)
+			{
+				var dataLength = frameset.Color.Width * frameset.Color.Height * 3;
+				if (_colorBufferPool?.BufferLength != dataLength)
+					_colorBufferPool = new FrameBufferPool<byte>(dataLength, RealsenseD435FrameProvider.PooledFrameCount);
+
+				var timing = new FrameTiming(frameset.Color.FrameNumber, frameset.Color.CaptureTimestampUs,
+					frameset.Color.ReceivedTimestampUs);
+				image = new ImageData(frameset.Color.Width, frameset.Color.Height, 3, _colorBufferPool, timing);
+				Marshal.Copy(new IntPtr(frameset.Color.Data), image.Data, 0, image.Data.Length);
+			}
+
+			DepthMap depthMap = null;
+			if (needDepthFrame)
+			{
+				var mapLength = frameset.Depth.Width * frameset.Depth.Height;
+				if (_depthBufferPool?.BufferLength != mapLength)
+					_depthBufferPool = new FrameBufferPool<short>(mapLength, RealsenseD435FrameProvider.PooledFrameCount);
+
+				var timing = new FrameTiming(frameset.Depth.FrameNumber, frameset.Depth.CaptureTimestampUs,
+					frameset.Depth.ReceivedTimestampUs);
+				depthMap = new DepthMap(frameset.Depth.Width, frameset.Depth.Height, _depthBufferPool, timing);
+				Marshal.Copy(new IntPtr(frameset.Depth.Data), depthMap.Data, 0, depthMap.Data.Length);
+			}
+
+			if (NativeMethods.IsSharedFramesetValid(_reader, &frameset) == 0)
+			{
+				image?.Release();
+				depthMap?.Release();
+				return true;
+			}
+
+			if (image != null)
+				ColorFrameStream.PushFrame(image);
+
+			if (depthMap != null)
+				DepthFrameStream.PushFrame(depthMap);
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,14 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProviders.D435
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct RecordingStats
+	{
+		public long RecordedCount;
+		public long DroppedCount;
+		public long WrittenBytes;
+		public int ChunkCount;
+		public int WriteFailed;
+	}
+}
@@ -0,0 +1,11 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProviders.D435
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal unsafe struct SensorExtrinsics
+	{
+		public fixed float Rotation[9];
+		public fixed float Translation[3];
+	}
+}
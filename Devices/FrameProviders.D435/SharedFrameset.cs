@@ -0,0 +1,15 @@
+﻿using System.Runtime.InteropServices;
+using DeviceIntegration.Native;
+
+namespace FrameProviders.D435
+{
+	// frame data points into the shared ring of the publishing process
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SharedFrameset
+	{
+		public long Sequence;
+		public int SkippedCount;
+		public DepthFrame Depth;
+		public ColorFrame Color;
+	}
+}
@@ -0,0 +1,21 @@
+﻿using System.Collections.Generic;
+using Primitives;
+
+namespace FrameProcessor
+{
+	public class ConveyorObjectData : MeasuredObjectData
+	{
+		// stable while the object is tracked across frames
+		public int ObjectId { get; }
+
+		public int SampleCount { get; }
+
+		public ConveyorObjectData(int objectId, int sampleCount, int lengthMm, int widthMm, int heightMm, long volumeMm3,
+			RelPoint center, IReadOnlyList<RelPoint> footprint)
+			: base(lengthMm, widthMm, heightMm, volumeMm3, center, footprint)
+		{
+			ObjectId = objectId;
+			SampleCount = sampleCount;
+		}
+	}
+}
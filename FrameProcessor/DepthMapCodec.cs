@@ -0,0 +1,86 @@
+﻿using System;
+using System.IO;
+using System.Threading.Tasks;
+using FrameProcessor.Native;
+using DepthMap = Primitives.DepthMap;
+
+namespace FrameProcessor
+{
+	// Lossless binary storage for depth maps backed by the native depth codec
+	public static class DepthMapCodec
+	{
+		public const string FileExtension = ".dmz";
+
+		public static byte[] Encode(DepthMap depthMap)
+		{
+			var maxLength = NativeMethods.GetMaxEncodedDepthMapLength(depthMap.Width, depthMap.Height);
+			var buffer = new byte[maxLength];
+
+			unsafe
+			{
+				fixed (short* depthData = depthMap.Data)
+				fixed (byte* output = buffer)
+				{
+					var nativeDepthMap = new Native.DepthMap
+					{
+						Width = depthMap.Width,
+						Height = depthMap.Height,
+						Data = depthData
+					};
+
+					var encodedLength = NativeMethods.EncodeDepthMap(nativeDepthMap, output, buffer.Length);
+					if (encodedLength < 0)
+						throw new InvalidOperationException("Failed to encode depth map");
+
+					Array.Resize(ref buffer, encodedLength);
+				}
+			}
+
+			return buffer;
+		}
+
+		public static DepthMap Decode(byte[] encodedData)
+		{
+			unsafe
+			{
+				fixed (byte* input = encodedData)
+				{
+					var headerLength = NativeMethods.ReadEncodedDepthMapHeader(input, encodedData.Length, out var width, out var height);
+					if (headerLength < 0)
+						throw new InvalidDataException("Invalid encoded depth map header");
+
+					var depthMap = new DepthMap(width, height);
+
+					fixed (short* depthData = depthMap.Data)
+					{
+						var nativeDepthMap = new Native.DepthMap
+						{
+							Width = width,
+							Height = height,
+							Data = depthData
+						};
+
+						var decodedLength = NativeMethods.DecodeDepthMap(input, encodedData.Length, nativeDepthMap);
+						if (decodedLength < 0)
+							throw new InvalidDataException("Encoded depth map data is corrupted");
+					}
+
+					return depthMap;
+				}
+			}
+		}
+
+		public static async Task SaveDepthMapToFileAsync(DepthMap depthMap, string filepath)
+		{
+			var encodedData = Encode(depthMap);
+			await File.WriteAllBytesAsync(filepath, encodedData);
+		}
+
+		public static async Task<DepthMap> ReadDepthMapFromFileAsync(string filepath)
+		{
+			var encodedData = await File.ReadAllBytesAsync(filepath);
+
+			return Decode(encodedData);
+		}
+	}
+}
@@ -1,10 +1,14 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.IO;
 using FrameProcessor.Native;
 using FrameProviders;
 using Primitives;
 using Primitives.Logging;
 using Primitives.Settings;
 using DepthMap = Primitives.DepthMap;
+using FloorPlane = Primitives.Settings.FloorPlane;
+using RelPoint = Primitives.RelPoint;
 
 namespace FrameProcessor
 {
@@ -15,6 +19,9 @@ namespace FrameProcessor
 
 		private readonly IntPtr _handle;
 
+		// as many objects as the native tracker can follow at once
+		private readonly ConveyorMeasurement[] _conveyorMeasurements;
+
 		public DepthMapProcessor(ILogger logger, ColorCameraParams colorCameraParams, DepthCameraParams depthCameraParams)
 		{
 			_lock = new object();
@@ -27,6 +34,8 @@ namespace FrameProcessor
 			var depthIntrinsics = TypeConverter.DepthParamsToIntrinsics(depthCameraParams);
 
 			_handle = NativeMethods.CreateDepthMapProcessor(colorIntrinsics, depthIntrinsics);
+			_conveyorMeasurements = new ConveyorMeasurement[32];
+			SetCalibrationCacheDirectory(GlobalConstants.AppCachePath);
 		}
 
 		public ObjectVolumeData CalculateVolume(DepthMap depthMap, ImageData colorImage, short calculatedDistance, 
@@ -54,13 +63,15 @@ namespace FrameProcessor
 							DepthMap = &nativeDepthMap,
 							ColorImage = &nativeColorImage,
 							SelectedAlgorithm = selectedAlgorithm,
-							CalculatedDistance = calculatedDistance
+							CalculatedDistance = calculatedDistance,
+							Timing = GetNativeFrameTiming(depthMap.Timing)
 						};
 
 						var nativeResult = NativeMethods.CalculateObjectVolume(_handle, volumeCalculationData);
 
 						var result = nativeResult == null ?
-							null : new ObjectVolumeData(nativeResult->LengthMm, nativeResult->WidthMm, nativeResult->HeightMm);
+							null : new ObjectVolumeData(nativeResult->LengthMm, nativeResult->WidthMm, nativeResult->HeightMm,
+								nativeResult->VolumeMm3, nativeResult->FrameNumber, nativeResult->CaptureTimestampUs);
 						NativeMethods.DisposeCalculationResult(nativeResult);
 
 						return result;
@@ -69,6 +80,86 @@ namespace FrameProcessor
 			}
 		}
 
+		// measures every object in the measurement zone using the depth map only, largest objects first
+		public IReadOnlyList<MeasuredObjectData> CalculateVolumes(DepthMap depthMap)
+		{
+			var objects = new List<MeasuredObjectData>();
+
+			lock (_lock)
+			{
+				unsafe
+				{
+					fixed (short* depthData = depthMap.Data)
+					{
+						var nativeDepthMap = GetNativeDepthMapFromDepthMap(depthMap, depthData);
+
+						var nativeResult = NativeMethods.CalculateObjectVolumes(_handle, nativeDepthMap);
+						if (nativeResult == null)
+							return objects;
+
+						for (var i = 0; i < nativeResult->ObjectCount; i++)
+						{
+							var nativeObject = nativeResult->Objects[i];
+							objects.Add(new MeasuredObjectData(nativeObject.LengthMm, nativeObject.WidthMm,
+								nativeObject.HeightMm, nativeObject.VolumeMm3, GetRelPoint(nativeObject.Center),
+								GetFootprint(nativeObject)));
+						}
+
+						NativeMethods.DisposeMultiVolumeCalculationResult(nativeResult);
+					}
+				}
+			}
+
+			return objects;
+		}
+
+		// feeds a frame of a continuous stream, returns the objects whose measurement was completed with this frame
+		public IReadOnlyList<ConveyorObjectData> ProcessConveyorFrame(DepthMap depthMap)
+		{
+			var objects = new List<ConveyorObjectData>();
+
+			lock (_lock)
+			{
+				unsafe
+				{
+					fixed (short* depthData = depthMap.Data)
+					fixed (ConveyorMeasurement* measurements = _conveyorMeasurements)
+					{
+						var nativeDepthMap = GetNativeDepthMapFromDepthMap(depthMap, depthData);
+
+						var measurementCount = NativeMethods.ProcessConveyorFrame(_handle, nativeDepthMap, measurements,
+							_conveyorMeasurements.Length);
+
+						for (var i = 0; i < measurementCount; i++)
+						{
+							var nativeObject = measurements[i].Measurement;
+							objects.Add(new ConveyorObjectData(measurements[i].ObjectId, measurements[i].SampleCount,
+								nativeObject.LengthMm, nativeObject.WidthMm, nativeObject.HeightMm, nativeObject.VolumeMm3,
+								GetRelPoint(nativeObject.Center), GetFootprint(nativeObject)));
+						}
+					}
+				}
+			}
+
+			return objects;
+		}
+
+		public void SetConveyorSampleCount(int sampleCount)
+		{
+			lock (_lock)
+			{
+				NativeMethods.SetConveyorSampleCount(_handle, sampleCount);
+			}
+		}
+
+		public void ResetConveyorTracking()
+		{
+			lock (_lock)
+			{
+				NativeMethods.ResetConveyorTracking(_handle);
+			}
+		}
+
 		public short CalculateFloorDepth(DepthMap depthMap)
 		{
 			lock (_lock)
@@ -85,6 +176,65 @@ namespace FrameProcessor
 			}
 		}
 
+		public FloorPlane CalculateFloorPlane(DepthMap depthMap)
+		{
+			lock (_lock)
+			{
+				unsafe
+				{
+					fixed (short* depthData = depthMap.Data)
+					{
+						var nativeDepthMap = GetNativeDepthMapFromDepthMap(depthMap, depthData);
+
+						var planeIsFound = NativeMethods.CalculateFloorPlane(_handle, nativeDepthMap, out var plane) > 0;
+						if (!planeIsFound)
+							return null;
+
+						_logger.LogInfo($"Fitted floor plane, {plane.InlierRatio:P0} of the sampled pixels lie on it");
+
+						return new FloorPlane(plane.Offset, plane.SlopeX, plane.SlopeY);
+					}
+				}
+			}
+		}
+
+		// learns the frame as the empty work area, unless the depth map shows an object in the measurement zone
+		public bool UpdateColorBackground(DepthMap depthMap, ImageData colorImage)
+		{
+			if (depthMap?.Data == null || colorImage?.Data == null)
+				return false;
+
+			lock (_lock)
+			{
+				unsafe
+				{
+					fixed (short* depthData = depthMap.Data)
+					fixed (byte* colorData = colorImage.Data)
+					{
+						var nativeDepthMap = GetNativeDepthMapFromDepthMap(depthMap, depthData);
+
+						var nativeColorImage = new ColorImage
+						{
+							Width = colorImage.Width,
+							Height = colorImage.Height,
+							Data = colorData,
+							BytesPerPixel = colorImage.BytesPerPixel
+						};
+
+						return NativeMethods.UpdateColorBackground(_handle, nativeDepthMap, nativeColorImage) > 0;
+					}
+				}
+			}
+		}
+
+		public void ResetColorBackground()
+		{
+			lock (_lock)
+			{
+				NativeMethods.ResetColorBackground(_handle);
+			}
+		}
+
 		public AlgorithmSelectionResult SelectAlgorithm(AlgorithmSelectionData data)
 		{
 			try
@@ -169,6 +319,23 @@ namespace FrameProcessor
 		{
 			var colorRoiRect = CreateColorRoiRectFromSettings(workAreaSettings);
 
+			var floorPlane = workAreaSettings.FloorPlane;
+			var nativeFloorPlane = floorPlane == null
+				? new Native.FloorPlane()
+				: new Native.FloorPlane { Offset = floorPlane.Offset, SlopeX = floorPlane.SlopeX, SlopeY = floorPlane.SlopeY };
+			NativeMethods.SetFloorPlane(_handle, nativeFloorPlane);
+
+			var colorSegmentationMode = workAreaSettings.UseColorBackgroundModel
+				? ColorSegmentationMode.BackgroundModel
+				: ColorSegmentationMode.Canny;
+			NativeMethods.SetColorSegmentationMode(_handle, (int)colorSegmentationMode);
+
+			var depthDecimationFilter = workAreaSettings.UseMedianDepthDecimation
+				? DepthDecimationFilter.Median
+				: DepthDecimationFilter.Min;
+			NativeMethods.SetDepthDecimation(_handle, workAreaSettings.DepthDecimationFactor, (int)depthDecimationFilter);
+			NativeMethods.SetDepthDenoising(_handle, workAreaSettings.UseDepthDenoising ? 1 : 0);
+
 			unsafe
 			{
 				var relPoints = new Native.RelPoint[workAreaSettings.DepthMaskContour.Count];
@@ -186,6 +353,53 @@ namespace FrameProcessor
 			}
 		}
 
+		// rotation is column-major, translation is in millimeters; until set, the cameras are considered coincident
+		public void SetDepthToColorExtrinsics(float[] rotation, float[] translationMm)
+		{
+			if (rotation?.Length != 9 || translationMm?.Length != 3)
+				throw new ArgumentException("Extrinsics require a 3x3 rotation and a 3-component translation");
+
+			lock (_lock)
+			{
+				unsafe
+				{
+					var extrinsics = new Extrinsics();
+					for (var i = 0; i < rotation.Length; i++)
+						extrinsics.Rotation[i] = rotation[i];
+					for (var i = 0; i < translationMm.Length; i++)
+						extrinsics.Translation[i] = translationMm[i];
+
+					NativeMethods.SetDepthToColorExtrinsics(_handle, extrinsics);
+				}
+			}
+		}
+
+		// tracing state is shared by all processor instances in the process
+		public static void SetTracingEnabled(bool enabled)
+		{
+			NativeMethods.SetTracingEnabled(enabled ? 1 : 0);
+		}
+
+		// drains the events recorded since the previous write into a Chrome trace-event file
+		public static bool WriteTrace(string filepath)
+		{
+			return NativeMethods.WriteTrace(filepath) != 0;
+		}
+
+		// latencies are recorded by all processor instances in the process, for frames that carry their timing
+		public static LatencyStats GetLatencyStats(LatencyStage stage)
+		{
+			if (NativeMethods.GetLatencyStats((int)stage, out var stats) == 0)
+				return null;
+
+			return new LatencyStats(stats.Count, stats.MedianUs, stats.P90Us, stats.P99Us, stats.MaxUs);
+		}
+
+		public static void ResetLatencyStats()
+		{
+			NativeMethods.ResetLatencyStats();
+		}
+
 		public void Dispose()
 		{
 			_logger.LogInfo("Disposing depth map processor...");
@@ -193,6 +407,19 @@ namespace FrameProcessor
 			_logger.LogInfo("Disposed depth map processor");
 		}
 
+		private void SetCalibrationCacheDirectory(string path)
+		{
+			try
+			{
+				Directory.CreateDirectory(path);
+				NativeMethods.SetCalibrationCacheDirectory(_handle, path);
+			}
+			catch (Exception ex)
+			{
+				_logger.LogException("Failed to set calibration cache directory, calibration will not be cached", ex);
+			}
+		}
+
 		private static unsafe Native.DepthMap GetNativeDepthMapFromDepthMap(DepthMap depthMap, short* depthData)
 		{
 			return new Native.DepthMap
@@ -203,6 +430,35 @@ namespace FrameProcessor
 			};
 		}
 
+		private static Native.FrameTiming GetNativeFrameTiming(Primitives.FrameTiming timing)
+		{
+			if (timing == null)
+				return new Native.FrameTiming();
+
+			return new Native.FrameTiming
+			{
+				FrameNumber = timing.FrameNumber,
+				CaptureTimestampUs = timing.CaptureTimestampUs,
+				ReceivedTimestampUs = timing.ReceivedTimestampUs
+			};
+		}
+
+		private static RelPoint GetRelPoint(Native.RelPoint point)
+		{
+			return new RelPoint(point.X, point.Y);
+		}
+
+		private static IReadOnlyList<RelPoint> GetFootprint(ObjectMeasurement measurement)
+		{
+			return new List<RelPoint>
+			{
+				GetRelPoint(measurement.Footprint0),
+				GetRelPoint(measurement.Footprint1),
+				GetRelPoint(measurement.Footprint2),
+				GetRelPoint(measurement.Footprint3)
+			};
+		}
+
 		private static RelRect CreateColorRoiRectFromSettings(WorkAreaSettings workAreaSettings)
 		{
 			float x1;
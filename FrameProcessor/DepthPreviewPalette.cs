@@ -0,0 +1,8 @@
+﻿namespace FrameProcessor
+{
+	public enum DepthPreviewPalette
+	{
+		Grayscale = 0,
+		Color = 1
+	}
+}
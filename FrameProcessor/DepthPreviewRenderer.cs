@@ -0,0 +1,95 @@
+﻿using System;
+using System.Collections.Generic;
+using FrameProcessor.Native;
+using Primitives;
+using DepthMap = Primitives.DepthMap;
+using RelPoint = Primitives.RelPoint;
+
+namespace FrameProcessor
+{
+	// Renders depth map previews natively in one pass: cut-off, depth-to-color mapping, resizing and
+	// an optional contour overlay. The preview is written into an image the caller keeps between frames.
+	public sealed class DepthPreviewRenderer : IDisposable
+	{
+		private readonly object _lock;
+		private readonly IntPtr _handle;
+
+		public int PreviewWidth { get; }
+
+		public int PreviewHeight { get; }
+
+		public byte BytesPerPixel { get; }
+
+		public DepthPreviewRenderer(int previewWidth, int previewHeight, DepthPreviewPalette palette)
+		{
+			if (previewWidth <= 0 || previewHeight <= 0)
+				throw new ArgumentException("Preview dimensions must be positive");
+
+			_lock = new object();
+
+			PreviewWidth = previewWidth;
+			PreviewHeight = previewHeight;
+			BytesPerPixel = (byte)(palette == DepthPreviewPalette.Color ? 3 : 1);
+
+			_handle = NativeMethods.CreateDepthPreviewRenderer(previewWidth, previewHeight, (int)palette);
+		}
+
+		// depths outside of [minDepth, maxDepth] and above cutOffDepth are rendered black
+		public void SetDepthRange(short minDepth, short maxDepth, short cutOffDepth)
+		{
+			lock (_lock)
+			{
+				NativeMethods.SetPreviewDepthRange(_handle, minDepth, maxDepth, cutOffDepth);
+			}
+		}
+
+		public ImageData CreatePreviewImage()
+		{
+			return new ImageData(PreviewWidth, PreviewHeight, BytesPerPixel);
+		}
+
+		// contour points are relative to the map, as the work area and the measured footprints are
+		public void Render(DepthMap depthMap, ImageData preview, IReadOnlyList<RelPoint> contour = null)
+		{
+			var previewMatches = preview.Width == PreviewWidth && preview.Height == PreviewHeight &&
+				preview.BytesPerPixel == BytesPerPixel;
+			if (!previewMatches)
+				throw new ArgumentException("Preview image does not match the renderer");
+
+			var contourPoints = new Native.RelPoint[contour?.Count ?? 0];
+			for (var i = 0; i < contourPoints.Length; i++)
+			{
+				contourPoints[i].X = (float)contour[i].X;
+				contourPoints[i].Y = (float)contour[i].Y;
+			}
+
+			lock (_lock)
+			{
+				unsafe
+				{
+					fixed (short* depthData = depthMap.Data)
+					fixed (Native.RelPoint* points = contourPoints)
+					fixed (byte* output = preview.Data)
+					{
+						var nativeDepthMap = new Native.DepthMap
+						{
+							Width = depthMap.Width,
+							Height = depthMap.Height,
+							Data = depthData
+						};
+
+						var renderedLength = NativeMethods.RenderDepthPreview(_handle, nativeDepthMap, points,
+							contourPoints.Length, output, preview.Data.Length);
+						if (renderedLength < 0)
+							throw new ArgumentException("Failed to render a depth preview");
+					}
+				}
+			}
+		}
+
+		public void Dispose()
+		{
+			NativeMethods.DestroyDepthPreviewRenderer(_handle);
+		}
+	}
+}
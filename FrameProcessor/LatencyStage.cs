@@ -0,0 +1,10 @@
+﻿namespace FrameProcessor
+{
+	// stages of a frame's way from the sensor to a measurement result
+	public enum LatencyStage
+	{
+		CaptureToCallback = 0,
+		CallbackToProcessing = 1,
+		ProcessingToResult = 2
+	}
+}
@@ -0,0 +1,31 @@
+﻿namespace FrameProcessor
+{
+	// percentiles are upper bounds of histogram buckets, at most 12.5% above the actual latencies
+	public class LatencyStats
+	{
+		public long Count { get; }
+
+		public long MedianUs { get; }
+
+		public long P90Us { get; }
+
+		public long P99Us { get; }
+
+		public long MaxUs { get; }
+
+		public LatencyStats(long count, long medianUs, long p90Us, long p99Us, long maxUs)
+		{
+			Count = count;
+			MedianUs = medianUs;
+			P90Us = p90Us;
+			P99Us = p99Us;
+			MaxUs = maxUs;
+		}
+
+		public override string ToString()
+		{
+			return $"n={Count} p50={MedianUs / 1000.0:0.0}ms p90={P90Us / 1000.0:0.0}ms p99={P99Us / 1000.0:0.0}ms " +
+				$"max={MaxUs / 1000.0:0.0}ms";
+		}
+	}
+}
@@ -0,0 +1,22 @@
+﻿using System.Collections.Generic;
+using Primitives;
+
+namespace FrameProcessor
+{
+	public class MeasuredObjectData : ObjectVolumeData
+	{
+		// relative to the depth map
+		public RelPoint Center { get; }
+
+		// corners of the object's minimal bounding rectangle, relative to the depth map
+		public IReadOnlyList<RelPoint> Footprint { get; }
+
+		public MeasuredObjectData(int lengthMm, int widthMm, int heightMm, long volumeMm3, RelPoint center,
+			IReadOnlyList<RelPoint> footprint)
+			: base(lengthMm, widthMm, heightMm, volumeMm3)
+		{
+			Center = center;
+			Footprint = footprint;
+		}
+	}
+}
@@ -0,0 +1,8 @@
+﻿namespace FrameProcessor.Native
+{
+	internal enum ColorSegmentationMode
+	{
+		Canny = 0,
+		BackgroundModel = 1
+	}
+}
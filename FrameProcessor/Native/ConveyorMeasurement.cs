@@ -0,0 +1,12 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct ConveyorMeasurement
+	{
+		public int ObjectId;
+		public int SampleCount;
+		public ObjectMeasurement Measurement;
+	}
+}
@@ -0,0 +1,8 @@
+﻿namespace FrameProcessor.Native
+{
+	internal enum DepthDecimationFilter
+	{
+		Min = 0,
+		Median = 1
+	}
+}
@@ -11,13 +11,46 @@ namespace FrameProcessor.Native
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern void DestroyDepthMapProcessor(IntPtr processor);
 
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetTracingEnabled(int enabled);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern int WriteTrace(string filepath);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int GetLatencyStats(int stage, out NativeLatencyStats stats);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void ResetLatencyStats();
+
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern unsafe void SetAlgorithmSettings(IntPtr processor, short floorDepth, short cutOffDepth,
 			RelPoint* polygonPoints, int polygonPointCount, RelRect colorRoiRect);
 
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetDepthToColorExtrinsics(IntPtr processor, Extrinsics extrinsics);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetColorSegmentationMode(IntPtr processor, int mode);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int UpdateColorBackground(IntPtr processor, DepthMap depthMap, ColorImage colorImage);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void ResetColorBackground(IntPtr processor);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetDepthDecimation(IntPtr processor, int factor, int filter);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetDepthDenoising(IntPtr processor, int enabled);
+
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
 		public static extern void SetDebugDirectory(IntPtr processor, string path);
 
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+		public static extern void SetCalibrationCacheDirectory(IntPtr processor, string path);
+
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern unsafe VolumeCalculationResult* CalculateObjectVolume(IntPtr processor, VolumeCalculationData data);
 
@@ -30,7 +63,67 @@ namespace FrameProcessor.Native
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern short CalculateFloorDepth(IntPtr processor, DepthMap depthMap);
 
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int CalculateFloorPlane(IntPtr processor, DepthMap depthMap, out FloorPlane plane);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetFloorPlane(IntPtr processor, FloorPlane plane);
+
 		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
 		public static extern unsafe void DisposeCalculationResult(VolumeCalculationResult* result);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe MultiVolumeCalculationResult* CalculateObjectVolumes(IntPtr processor, DepthMap depthMap);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe void DisposeMultiVolumeCalculationResult(MultiVolumeCalculationResult* result);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int ProcessConveyorFrame(IntPtr processor, DepthMap depthMap,
+			ConveyorMeasurement* measurements, int capacity);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void ResetConveyorTracking(IntPtr processor);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetConveyorSampleCount(IntPtr processor, int sampleCount);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern int GetMaxEncodedDepthMapLength(int width, int height);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int EncodeDepthMap(DepthMap depthMap, byte* output, int outputCapacity);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int ReadEncodedDepthMapHeader(byte* input, int inputLength, out int width, out int height);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int DecodeDepthMap(byte* input, int inputLength, DepthMap depthMap);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr CreateDepthPreviewRenderer(int previewWidth, int previewHeight, int palette);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void SetPreviewDepthRange(IntPtr renderer, short minDepth, short maxDepth, short cutOffDepth);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern unsafe int RenderDepthPreview(IntPtr renderer, DepthMap depthMap, RelPoint* contourPoints,
+			int contourPointCount, byte* output, int outputCapacity);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void DestroyDepthPreviewRenderer(IntPtr renderer);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr CreateSampleAggregator(int minSampleCount, int maxSampleCount, int toleranceMm);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void AddAggregatedSample(IntPtr aggregator, VolumeCalculationResult sample,
+			out SampleAggregate aggregate);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void ResetSampleAggregator(IntPtr aggregator);
+
+		[DllImport(Constants.AnalyzerLibName, CallingConvention = CallingConvention.Cdecl)]
+		public static extern void DestroySampleAggregator(IntPtr aggregator);
 	}
 }
@@ -0,0 +1,11 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal unsafe struct Extrinsics
+	{
+		public fixed float Rotation[9];
+		public fixed float Translation[3];
+	}
+}
@@ -0,0 +1,13 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct FloorPlane
+	{
+		public float Offset;
+		public float SlopeX;
+		public float SlopeY;
+		public float InlierRatio;
+	}
+}
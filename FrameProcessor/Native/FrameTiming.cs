@@ -0,0 +1,12 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct FrameTiming
+	{
+		public long FrameNumber;
+		public long CaptureTimestampUs;
+		public long ReceivedTimestampUs;
+	}
+}
@@ -0,0 +1,11 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal unsafe struct MultiVolumeCalculationResult
+	{
+		public int ObjectCount;
+		public ObjectMeasurement* Objects;
+	}
+}
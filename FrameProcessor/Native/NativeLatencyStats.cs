@@ -0,0 +1,14 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct NativeLatencyStats
+	{
+		public long Count;
+		public long MedianUs;
+		public long P90Us;
+		public long P99Us;
+		public long MaxUs;
+	}
+}
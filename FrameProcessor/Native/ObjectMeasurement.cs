@@ -0,0 +1,18 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct ObjectMeasurement
+	{
+		public int LengthMm;
+		public int WidthMm;
+		public int HeightMm;
+		public long VolumeMm3;
+		public RelPoint Center;
+		public RelPoint Footprint0;
+		public RelPoint Footprint1;
+		public RelPoint Footprint2;
+		public RelPoint Footprint3;
+	}
+}
@@ -0,0 +1,16 @@
+﻿using System.Runtime.InteropServices;
+
+namespace FrameProcessor.Native
+{
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SampleAggregate
+	{
+		public int SampleCount;
+		public int IsConverged;
+		public int IsComplete;
+		public int LengthSpreadMm;
+		public int WidthSpreadMm;
+		public int HeightSpreadMm;
+		public VolumeCalculationResult Result;
+	}
+}
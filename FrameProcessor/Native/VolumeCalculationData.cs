@@ -9,5 +9,6 @@ namespace FrameProcessor.Native
 		public ColorImage* ColorImage;
 		public AlgorithmSelectionStatus SelectedAlgorithm;
 		public short CalculatedDistance;
+		public FrameTiming Timing;
 	}
 }
@@ -8,5 +8,8 @@ namespace FrameProcessor.Native
 		public int LengthMm;
 		public int WidthMm;
 		public int HeightMm;
+		public long VolumeMm3;
+		public long FrameNumber;
+		public long CaptureTimestampUs;
 	}
 }
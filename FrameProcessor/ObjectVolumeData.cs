@@ -8,11 +8,24 @@
 
 		public int HeightMm { get; }
 
-		public ObjectVolumeData(int lengthMm, int widthMm, int heightMm)
+		// integrated over the object's depth blob, 0 if it could not be measured
+		public long VolumeMm3 { get; }
+
+		// of the depth map the object was measured on, 0 if unknown
+		public long FrameNumber { get; }
+
+		// microseconds of the host's system clock since the Unix epoch, 0 if unknown
+		public long CaptureTimestampUs { get; }
+
+		public ObjectVolumeData(int lengthMm, int widthMm, int heightMm, long volumeMm3, long frameNumber = 0,
+			long captureTimestampUs = 0)
 		{
 			LengthMm = lengthMm;
 			WidthMm = widthMm;
 			HeightMm = heightMm;
+			VolumeMm3 = volumeMm3;
+			FrameNumber = frameNumber;
+			CaptureTimestampUs = captureTimestampUs;
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿namespace FrameProcessor
+{
+	public class VolumeSampleAggregate
+	{
+		public int SampleCount { get; }
+
+		// the latest samples agree within the tolerance
+		public bool IsConverged { get; }
+
+		// converged or the maximum sample count was reached, no more samples are needed
+		public bool IsComplete { get; }
+
+		// max - min of each dimension over the latest samples
+		public int LengthSpreadMm { get; }
+
+		public int WidthSpreadMm { get; }
+
+		public int HeightSpreadMm { get; }
+
+		// mode of each dimension and median volume over all samples
+		public ObjectVolumeData Result { get; }
+
+		public VolumeSampleAggregate(int sampleCount, bool isConverged, bool isComplete, int lengthSpreadMm,
+			int widthSpreadMm, int heightSpreadMm, ObjectVolumeData result)
+		{
+			SampleCount = sampleCount;
+			IsConverged = isConverged;
+			IsComplete = isComplete;
+			LengthSpreadMm = lengthSpreadMm;
+			WidthSpreadMm = widthSpreadMm;
+			HeightSpreadMm = heightSpreadMm;
+			Result = result;
+		}
+	}
+}
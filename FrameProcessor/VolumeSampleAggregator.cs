@@ -0,0 +1,59 @@
+﻿using System;
+using FrameProcessor.Native;
+
+namespace FrameProcessor
+{
+	// Aggregates the per-frame results of one measurement as they come in and tells when enough were taken:
+	// once at least minSampleCount samples were added and the latest minSampleCount of them are within toleranceMm
+	// of each other in every dimension, or once maxSampleCount samples were added.
+	public sealed class VolumeSampleAggregator : IDisposable
+	{
+		private readonly object _lock;
+		private readonly IntPtr _handle;
+
+		public VolumeSampleAggregator(int minSampleCount, int maxSampleCount, int toleranceMm)
+		{
+			_lock = new object();
+			_handle = NativeMethods.CreateSampleAggregator(minSampleCount, maxSampleCount, toleranceMm);
+		}
+
+		public VolumeSampleAggregate Add(ObjectVolumeData sample)
+		{
+			var nativeSample = new VolumeCalculationResult
+			{
+				LengthMm = sample.LengthMm,
+				WidthMm = sample.WidthMm,
+				HeightMm = sample.HeightMm,
+				VolumeMm3 = sample.VolumeMm3,
+				FrameNumber = sample.FrameNumber,
+				CaptureTimestampUs = sample.CaptureTimestampUs
+			};
+
+			SampleAggregate aggregate;
+			lock (_lock)
+			{
+				NativeMethods.AddAggregatedSample(_handle, nativeSample, out aggregate);
+			}
+
+			var result = new ObjectVolumeData(aggregate.Result.LengthMm, aggregate.Result.WidthMm,
+				aggregate.Result.HeightMm, aggregate.Result.VolumeMm3, aggregate.Result.FrameNumber,
+				aggregate.Result.CaptureTimestampUs);
+
+			return new VolumeSampleAggregate(aggregate.SampleCount, aggregate.IsConverged != 0, aggregate.IsComplete != 0,
+				aggregate.LengthSpreadMm, aggregate.WidthSpreadMm, aggregate.HeightSpreadMm, result);
+		}
+
+		public void Reset()
+		{
+			lock (_lock)
+			{
+				NativeMethods.ResetSampleAggregator(_handle);
+			}
+		}
+
+		public void Dispose()
+		{
+			NativeMethods.DestroySampleAggregator(_handle);
+		}
+	}
+}
@@ -0,0 +1,17 @@
+﻿namespace FrameProviders
+{
+	// maps a point from one camera's coordinate system to another's: p' = Rotation * p + Translation
+	public class CameraExtrinsics
+	{
+		// 3x3, column-major
+		public float[] Rotation { get; }
+
+		public float[] TranslationMm { get; }
+
+		public CameraExtrinsics(float[] rotation, float[] translationMm)
+		{
+			Rotation = rotation;
+			TranslationMm = translationMm;
+		}
+	}
+}
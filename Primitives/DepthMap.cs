@@ -1,20 +1,30 @@
 ﻿using System;
+using System.Threading;
 
 namespace Primitives
 {
-	public class DepthMap
+	// Maps made from a buffer pool hold one reference when created. The code that keeps a map past the call or event
+	// that handed it over either retains the map and releases it when done, or keeps a copy.
+	public class DepthMap : IPooledFrame
 	{
+		private readonly FrameBufferPool<short> _bufferPool;
+		private int _referenceCount;
+
 		public int Width { get; }
 
 		public int Height { get; }
 
 		public short[] Data { get; }
 
-		public DepthMap(int width, int height, short[] data)
+		// null for maps that did not come from a sensor
+		public FrameTiming Timing { get; }
+
+		public DepthMap(int width, int height, short[] data, FrameTiming timing = null)
 		{
 			Width = width;
 			Height = height;
 			Data = data;
+			Timing = timing;
 		}
 
 		public DepthMap(int width, int height)
@@ -22,14 +32,43 @@ namespace Primitives
 		{
 		}
 
+		public DepthMap(int width, int height, FrameBufferPool<short> bufferPool, FrameTiming timing = null)
+		{
+			if (bufferPool.BufferLength != width * height)
+				throw new ArgumentException($"Pool buffers of length {bufferPool.BufferLength} do not fit a {width}x{height} map");
+
+			Width = width;
+			Height = height;
+			Data = bufferPool.Rent();
+			Timing = timing;
+
+			_bufferPool = bufferPool;
+			_referenceCount = 1;
+		}
+
 		public DepthMap(DepthMap depthMap)
 		{
 			Width = depthMap.Width;
 			Height = depthMap.Height;
+			Timing = depthMap.Timing;
 			Data = depthMap.Data == null ? null : new short[Width * Height];
 
 			if (depthMap.Data != null)
 				Buffer.BlockCopy(depthMap.Data, 0, Data, 0, sizeof(short) * Data.Length);
 		}
+
+		public DepthMap Retain()
+		{
+			if (_bufferPool != null)
+				Interlocked.Increment(ref _referenceCount);
+
+			return this;
+		}
+
+		public void Release()
+		{
+			if (_bufferPool != null && Interlocked.Decrement(ref _referenceCount) == 0)
+				_bufferPool.Return(Data);
+		}
 	}
 }
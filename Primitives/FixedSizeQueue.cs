@@ -6,14 +6,17 @@ namespace Primitives
 	public sealed class FixedSizeQueue<T> : IDisposable
 	{
 		private readonly BlockingCollection<T> _internalQueue;
+		private readonly Action<T> _discardItem;
 
 		public int Size { get; }
 
 		public int Count => _internalQueue.Count;
 
-		public FixedSizeQueue(int size)
+		// discardItem is given the items pushed out of a full queue
+		public FixedSizeQueue(int size, Action<T> discardItem = null)
 		{
 			Size = size;
+			_discardItem = discardItem;
 			_internalQueue = new BlockingCollection<T>();
 		}
 
@@ -28,7 +31,10 @@ namespace Primitives
 			_internalQueue.Add(item);
 
 			while (_internalQueue.Count > Size)
-				_internalQueue.Take();
+			{
+				var discardedItem = _internalQueue.Take();
+				_discardItem?.Invoke(discardedItem);
+			}
 		}
 
 		public T Dequeue()
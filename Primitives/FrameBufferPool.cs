@@ -0,0 +1,41 @@
+﻿using System;
+using System.Collections.Concurrent;
+
+namespace Primitives
+{
+	// Keeps the data buffers of released frames of one size so frames of a stream do not allocate a new one each.
+	// Frame buffers land on the large object heap, reusing them keeps the gen 2 collections away at high frame rates.
+	public sealed class FrameBufferPool<T>
+	{
+		private readonly ConcurrentBag<T[]> _buffers;
+		private readonly int _capacity;
+
+		public int BufferLength { get; }
+
+		public int PooledCount => _buffers.Count;
+
+		public FrameBufferPool(int bufferLength, int capacity)
+		{
+			BufferLength = bufferLength;
+			_capacity = capacity;
+			_buffers = new ConcurrentBag<T[]>();
+
+			for (var i = 0; i < capacity; i++)
+				_buffers.Add(new T[bufferLength]);
+		}
+
+		// a new buffer is made when all of the pooled ones are in use
+		public T[] Rent()
+		{
+			return _buffers.TryTake(out var buffer) ? buffer : new T[BufferLength];
+		}
+
+		public void Return(T[] buffer)
+		{
+			if (buffer == null || buffer.Length != BufferLength || _buffers.Count >= _capacity)
+				return;
+
+			_buffers.Add(buffer);
+		}
+	}
+}
@@ -0,0 +1,21 @@
+﻿namespace Primitives
+{
+	// timestamps are microseconds of the host's system clock since the Unix epoch, 0 if unknown
+	public class FrameTiming
+	{
+		public long FrameNumber { get; }
+
+		// when the sensor captured the frame
+		public long CaptureTimestampUs { get; }
+
+		// when the frame provider handed the frame out
+		public long ReceivedTimestampUs { get; }
+
+		public FrameTiming(long frameNumber, long captureTimestampUs, long receivedTimestampUs)
+		{
+			FrameNumber = frameNumber;
+			CaptureTimestampUs = captureTimestampUs;
+			ReceivedTimestampUs = receivedTimestampUs;
+		}
+	}
+}
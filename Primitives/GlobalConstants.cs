@@ -21,6 +21,8 @@ namespace Primitives
 
 		public static readonly string AppConfigPath = Path.Combine(AppDataPath, "config");
 
+		public static readonly string AppCachePath = Path.Combine(AppDataPath, "cache");
+
 		public static readonly string ConfigFileName = Path.Combine(AppConfigPath, "main.cfg");
 
 		public static readonly string CountersFileName = Path.Combine(AppConfigPath, "counters");
@@ -0,0 +1,8 @@
+﻿namespace Primitives
+{
+	// A frame whose data buffer goes back to a pool once every holder of the frame released it
+	public interface IPooledFrame
+	{
+		void Release();
+	}
+}
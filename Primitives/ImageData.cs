@@ -1,9 +1,14 @@
 ﻿using System;
+using System.Threading;
 
 namespace Primitives
 {
-	public class ImageData
+	// Images made from a buffer pool hold one reference when created, see DepthMap
+	public class ImageData : IPooledFrame
 	{
+		private readonly FrameBufferPool<byte> _bufferPool;
+		private int _referenceCount;
+
 		public int Width { get; }
 
 		public int Height { get; }
@@ -14,12 +19,16 @@ namespace Primitives
 
 		public int Stride => Width * BytesPerPixel;
 
-		public ImageData(int width, int height, byte[] data, byte bytesPerPixel)
+		// null for images that did not come from a sensor
+		public FrameTiming Timing { get; }
+
+		public ImageData(int width, int height, byte[] data, byte bytesPerPixel, FrameTiming timing = null)
 		{
 			Width = width;
 			Height = height;
 			Data = data;
 			BytesPerPixel = bytesPerPixel;
+			Timing = timing;
 		}
 
 		public ImageData(int width, int height, byte bytesPerPixel)
@@ -27,15 +36,46 @@ namespace Primitives
 		{
 		}
 
+		public ImageData(int width, int height, byte bytesPerPixel, FrameBufferPool<byte> bufferPool,
+			FrameTiming timing = null)
+		{
+			if (bufferPool.BufferLength != width * height * bytesPerPixel)
+				throw new ArgumentException($"Pool buffers of length {bufferPool.BufferLength} do not fit a {width}x{height}x{bytesPerPixel} image");
+
+			Width = width;
+			Height = height;
+			BytesPerPixel = bytesPerPixel;
+			Data = bufferPool.Rent();
+			Timing = timing;
+
+			_bufferPool = bufferPool;
+			_referenceCount = 1;
+		}
+
 		public ImageData(ImageData imageData)
 		{
 			Width = imageData.Width;
 			Height = imageData.Height;
 			BytesPerPixel = imageData.BytesPerPixel;
+			Timing = imageData.Timing;
 			Data = imageData.Data == null ? null : new byte[Width * Height * BytesPerPixel];
 
 			if (imageData.Data != null)
 				Buffer.BlockCopy(imageData.Data, 0, Data, 0, sizeof(byte) * Data.Length);
 		}
+
+		public ImageData Retain()
+		{
+			if (_bufferPool != null)
+				Interlocked.Increment(ref _referenceCount);
+
+			return this;
+		}
+
+		public void Release()
+		{
+			if (_bufferPool != null && Interlocked.Decrement(ref _referenceCount) == 0)
+				_bufferPool.Return(Data);
+		}
 	}
 }
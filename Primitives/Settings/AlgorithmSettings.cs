@@ -7,11 +7,19 @@ namespace Primitives.Settings
 	{
 		private const int DefaultTimerValueMs = 1000;
 		private const int DefaultSampleCount = 5;
+		private const int DefaultMinSampleCount = 3;
+		private const int DefaultSampleToleranceMm = 3;
 
 		public WorkAreaSettings WorkArea { get; set; }
 
+		// the most samples a measurement takes
 		public byte SampleDepthMapCount { get; set; }
 
+		// a measurement stops before SampleDepthMapCount once this many latest samples agree within SampleToleranceMm
+		public byte MinSampleDepthMapCount { get; set; }
+
+		public int SampleToleranceMm { get; set; }
+
 		public bool EnableAutoTimer { get; set; }
 
 		public long TimeToStartMeasurementMs { get; set; }
@@ -26,6 +34,9 @@ namespace Primitives.Settings
 		
 		public int PalletHeightMm { get; set; }
 
+		// report the volume integrated over the object's height map instead of the bounding box volume
+		public bool EnableVolumeIntegration { get; set; }
+
 		public AlgorithmSettings(WorkAreaSettings workArea, 
 			byte sampleDepthMapCount, bool enableAutoTimer, long timeToStartMeasurementMs, 
 			bool requireBarcode, WeightUnits selectedWeightUnits, 
@@ -40,6 +51,8 @@ namespace Primitives.Settings
 			PalletWeightGr = palletWeightGr;
 			PalletHeightMm = palletHeightMm;
 			EnablePalletSubtraction = enablePalletSubtraction;
+			MinSampleDepthMapCount = DefaultMinSampleCount;
+			SampleToleranceMm = DefaultSampleToleranceMm;
 		}
 
 		public static AlgorithmSettings GetDefaultSettings()
@@ -53,6 +66,8 @@ namespace Primitives.Settings
 		{
 			var builder = new StringBuilder("AlgorithmSettings:");
 			builder.Append($",sampleCount={SampleDepthMapCount}");
+			builder.Append($",minSampleCount={MinSampleDepthMapCount}");
+			builder.Append($",sampleToleranceMm={SampleToleranceMm}");
 			builder.Append($",enableAutTimer={EnableAutoTimer}");
 			builder.Append($",timeToStartMeasurementMs={TimeToStartMeasurementMs}");
 			builder.Append($",requireBarcode={RequireBarcode}");
@@ -60,6 +75,7 @@ namespace Primitives.Settings
 			builder.Append($",enablePalletSubtraction={EnablePalletSubtraction}");
 			builder.Append($",palletWeightKg={PalletWeightGr}");
 			builder.Append($",palletHeightMm={PalletHeightMm}");
+			builder.Append($",enableVolumeIntegration={EnableVolumeIntegration}");
 
 			return builder.ToString();
 		}
@@ -73,6 +89,13 @@ namespace Primitives.Settings
 			if (SampleDepthMapCount <= 0)
 				SampleDepthMapCount = DefaultSampleCount;
 
+			if (MinSampleDepthMapCount <= 0)
+				MinSampleDepthMapCount = DefaultMinSampleCount;
+
+			// zero is a valid tolerance, samples then have to match exactly
+			if (SampleToleranceMm < 0)
+				SampleToleranceMm = DefaultSampleToleranceMm;
+
 			if (TimeToStartMeasurementMs <= 0)
 				TimeToStartMeasurementMs = DefaultTimerValueMs;
 		}
@@ -0,0 +1,24 @@
+﻿namespace Primitives.Settings
+{
+	// floor depth = Offset + SlopeX * x + SlopeY * y, with x and y in world millimeters
+	public class FloorPlane
+	{
+		public float Offset { get; set; }
+
+		public float SlopeX { get; set; }
+
+		public float SlopeY { get; set; }
+
+		public FloorPlane(float offset, float slopeX, float slopeY)
+		{
+			Offset = offset;
+			SlopeX = slopeX;
+			SlopeY = slopeY;
+		}
+
+		public override string ToString()
+		{
+			return $"Offset={Offset},SlopeX={SlopeX},SlopeY={SlopeY}";
+		}
+	}
+}
@@ -10,6 +10,8 @@ namespace Primitives.Settings
 
 		public bool ShutDownPcByDefault { get; set; }
 
+		public bool EnableNativeTracing { get; set; }
+
 		public string ResultsFilePath => Path.Combine(OutputPath, GlobalConstants.ResultsFileName);
 
 		public string PhotosDirectoryPath => Path.Combine(OutputPath, GlobalConstants.ResultPhotosFolder);
@@ -33,6 +35,7 @@ namespace Primitives.Settings
 			var builder = new StringBuilder("GeneralSettings:");
 			builder.Append($"OutputPath={OutputPath}");
 			builder.Append($",ShutDownPcByDefault={ShutDownPcByDefault}");
+			builder.Append($",EnableNativeTracing={EnableNativeTracing}");
 
 			return builder.ToString();
 		}
@@ -11,6 +11,9 @@ namespace Primitives.Settings
 
 		public short FloorDepth { get; set; }
 
+		// null if the floor is considered parallel to the camera
+		public FloorPlane FloorPlane { get; set; }
+
 		public short MinObjectHeight { get; set; }
 
 		public bool UseColorMask { get; set; }
@@ -26,6 +29,18 @@ namespace Primitives.Settings
 		public bool EnablePerspectiveDmAlgorithm { get; set; }
 
 		public bool EnableRgbAlgorithm { get; set; }
+
+		// segment the color image against a learned model of the empty work area instead of detecting edges
+		public bool UseColorBackgroundModel { get; set; }
+
+		// 2 or 4 finds the object on a map reduced by this factor and refines only the area around it, 0 or 1 disables it
+		public int DepthDecimationFactor { get; set; }
+
+		// blocks of the reduced map take their median depth instead of the nearest one, which is less sensitive to noise
+		public bool UseMedianDepthDecimation { get; set; }
+
+		// removes speckle and fills small holes in the depth map before the object is looked for in it
+		public bool UseDepthDenoising { get; set; }
 		
 		public int RangeMeterCorrectionValueMm { get; set; }
 
@@ -48,6 +63,7 @@ namespace Primitives.Settings
 		{
 			var builder = new StringBuilder("WorkAreaSettings:");
 			builder.Append($"FloorDepth={FloorDepth}");
+			builder.Append($",FloorPlane=({FloorPlane})");
 			builder.Append($",UseColorMask={UseColorMask}");
 			builder.Append($",UseDepthMask={UseDepthMask}");
 			builder.Append($",MinObjectHeight={MinObjectHeight}");
@@ -55,6 +71,10 @@ namespace Primitives.Settings
 			builder.Append($",EnableDmAlgorithm={EnableDmAlgorithm}");
 			builder.Append($",EnablePerspectiveDmAlgorithm={EnablePerspectiveDmAlgorithm}");
 			builder.Append($",EnableRgbAlgorithm={EnableRgbAlgorithm}");
+			builder.Append($",UseColorBackgroundModel={UseColorBackgroundModel}");
+			builder.Append($",DepthDecimationFactor={DepthDecimationFactor}");
+			builder.Append($",UseMedianDepthDecimation={UseMedianDepthDecimation}");
+			builder.Append($",UseDepthDenoising={UseDepthDenoising}");
 
 			return builder.ToString();
 		}
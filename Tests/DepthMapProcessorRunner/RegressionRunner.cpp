@@ -0,0 +1,195 @@
+#include "RegressionRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include "DepthMapProcessorAPI.h"
+
+namespace
+{
+	const long long GetElapsedUs(const std::chrono::steady_clock::time_point& begin)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+		return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	}
+}
+
+RegressionRunner::RegressionRunner(const std::vector<std::string>& caseDirectories, const int workerCount)
+	: _caseDirectories(caseDirectories), _workerCount(std::max(1, workerCount))
+{
+	_nextCaseIndex = 0;
+	_wallTimeUs = 0;
+}
+
+void RegressionRunner::Run()
+{
+	_results.clear();
+	_results.resize(_caseDirectories.size());
+	_nextCaseIndex = 0;
+
+	const auto begin = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> workers;
+	workers.reserve(_workerCount);
+	for (int i = 0; i < _workerCount; i++)
+		workers.emplace_back(&RegressionRunner::RunWorker, this);
+
+	for (auto& worker : workers)
+		worker.join();
+
+	_wallTimeUs = GetElapsedUs(begin);
+}
+
+void RegressionRunner::RunWorker()
+{
+	DepthMapProcessor* processor = CreateProcessor();
+
+	while (true)
+	{
+		const int caseIndex = _nextCaseIndex++;
+		if (caseIndex >= (int)_caseDirectories.size())
+			break;
+
+		CaseResult& result = _results[caseIndex];
+		result.IsProcessed = false;
+		result.Expected = TestCaseDescription{};
+		result.Algorithm = AlgorithmSelectionStatus::Undefined;
+		result.LengthMm = 0;
+		result.WidthMm = 0;
+		result.HeightMm = 0;
+		result.VolumeMm3 = 0;
+		result.FrameCount = 0;
+		result.CaseLatencyUs = 0;
+
+		TestCase testCase;
+		if (!TestCaseReader::ReadTestCase(_caseDirectories[caseIndex], testCase, result.Error))
+		{
+			result.Name = testCase.Name;
+			continue;
+		}
+
+		RunCase(processor, testCase, result);
+	}
+
+	DestroyDepthMapProcessor(processor);
+}
+
+void RegressionRunner::RunCase(DepthMapProcessor* processor, const TestCase& testCase, CaseResult& result) const
+{
+	result.Name = testCase.Name;
+	result.Expected = testCase.Description;
+
+	const short floorDepth = testCase.Description.FloorDepthMm;
+	const short cutOffDepth = floorDepth - testCase.Description.MinObjHeightMm;
+
+	// the same work area the applications use by default
+	RelPoint workAreaPoints[4] = { { 0.2f, 0.2f }, { 0.2f, 0.8f }, { 0.8f, 0.8f }, { 0.8f, 0.2f } };
+	const RelRect colorRoiRect{ 0.2f, 0.2f, 0.6f, 0.6f };
+	SetAlgorithmSettings(processor, floorDepth, cutOffDepth, workAreaPoints, 4, colorRoiRect);
+
+	ColorImage colorImage{};
+	colorImage.Width = testCase.Image.cols;
+	colorImage.Height = testCase.Image.rows;
+	colorImage.BytesPerPixel = testCase.Image.channels();
+	colorImage.Data = testCase.Image.data;
+
+	const auto caseBegin = std::chrono::steady_clock::now();
+
+	const NativeAlgorithmSelectionData selectionData{ &testCase.DepthMaps[0], &colorImage, -1, true, true, true, "" };
+	NativeAlgorithmSelectionResult* selectionResult = SelectAlgorithm(processor, selectionData);
+	result.Algorithm = selectionResult->Status;
+	DisposeAlgorithmSelectionResult(selectionResult);
+
+	const bool algorithmIsSelected = result.Algorithm == AlgorithmSelectionStatus::Dm1 ||
+		result.Algorithm == AlgorithmSelectionStatus::Dm2 || result.Algorithm == AlgorithmSelectionStatus::Rgb;
+	if (!algorithmIsSelected)
+	{
+		result.CaseLatencyUs = GetElapsedUs(caseBegin);
+		result.Error = "algorithm was not selected";
+		return;
+	}
+
+	std::vector<int> lengths;
+	std::vector<int> widths;
+	std::vector<int> heights;
+	std::vector<long long> volumes;
+
+	for (const DepthMap& depthMap : testCase.DepthMaps)
+	{
+		const VolumeCalculationData data{ &depthMap, &colorImage, result.Algorithm, -1 };
+
+		const auto frameBegin = std::chrono::steady_clock::now();
+		VolumeCalculationResult* frameResult = CalculateObjectVolume(processor, data);
+		result.FrameLatenciesUs.emplace_back(GetElapsedUs(frameBegin));
+		result.FrameCount++;
+
+		if (frameResult == nullptr)
+			continue;
+
+		lengths.emplace_back(frameResult->LengthMm);
+		widths.emplace_back(frameResult->WidthMm);
+		heights.emplace_back(frameResult->HeightMm);
+		volumes.emplace_back(frameResult->VolumeMm3);
+		DisposeCalculationResult(frameResult);
+	}
+
+	result.CaseLatencyUs = GetElapsedUs(caseBegin);
+
+	if (lengths.empty())
+	{
+		result.Error = "no frame was measured";
+		return;
+	}
+
+	// aggregated the same way VolumeCalculator does it
+	result.LengthMm = GetMode(lengths);
+	result.WidthMm = GetMode(widths);
+	result.HeightMm = GetMode(heights);
+	result.VolumeMm3 = GetMedian(volumes);
+	result.IsProcessed = true;
+}
+
+DepthMapProcessor* RegressionRunner::CreateProcessor()
+{
+	CameraIntrinsics colorCameraIntrinsics{};
+	colorCameraIntrinsics.FovX = 84.1f;
+	colorCameraIntrinsics.FovY = 53.8f;
+	colorCameraIntrinsics.FocalLengthX = 1081.37f;
+	colorCameraIntrinsics.FocalLengthY = 1081.37f;
+	colorCameraIntrinsics.PrincipalPointX = 959.5f;
+	colorCameraIntrinsics.PrincipalPointY = 539.5f;
+
+	CameraIntrinsics depthCameraIntrinsics{};
+	depthCameraIntrinsics.FovX = 70.6f;
+	depthCameraIntrinsics.FovY = 60.0f;
+	depthCameraIntrinsics.FocalLengthX = 367.7066f;
+	depthCameraIntrinsics.FocalLengthY = 367.7066f;
+	depthCameraIntrinsics.PrincipalPointX = 257.8094f;
+	depthCameraIntrinsics.PrincipalPointY = 207.3965f;
+
+	return CreateDepthMapProcessor(colorCameraIntrinsics, depthCameraIntrinsics);
+}
+
+const int RegressionRunner::GetMode(std::vector<int> values)
+{
+	std::map<int, int> counts;
+	for (const int value : values)
+		counts[value]++;
+
+	auto mode = counts.begin();
+	for (auto it = counts.begin(); it != counts.end(); ++it)
+	{
+		if (it->second > mode->second)
+			mode = it;
+	}
+
+	return mode->first;
+}
+
+const long long RegressionRunner::GetMedian(std::vector<long long> values)
+{
+	std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+
+	return values[values.size() / 2];
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "Structures.h"
+#include "TestCaseReader.h"
+
+class DepthMapProcessor;
+
+struct CaseResult
+{
+	std::string Name;
+	bool IsProcessed;
+	std::string Error;
+	AlgorithmSelectionStatus Algorithm;
+	TestCaseDescription Expected;
+	int LengthMm;
+	int WidthMm;
+	int HeightMm;
+	long long VolumeMm3;
+	int FrameCount;
+	long long CaseLatencyUs;
+	std::vector<long long> FrameLatenciesUs;
+};
+
+// Runs every case on a pool of workers, each worker owns its own processor so no native state is shared.
+// Cases are loaded by the workers as they are picked up, only the processing calls are timed.
+class RegressionRunner
+{
+private:
+	const std::vector<std::string> _caseDirectories;
+	const int _workerCount;
+
+	std::atomic<int> _nextCaseIndex;
+	std::vector<CaseResult> _results;
+	long long _wallTimeUs;
+
+public:
+	RegressionRunner(const std::vector<std::string>& caseDirectories, const int workerCount);
+
+	void Run();
+
+	const std::vector<CaseResult>& GetResults() const { return _results; }
+	const long long GetWallTimeUs() const { return _wallTimeUs; }
+	const int GetWorkerCount() const { return _workerCount; }
+
+private:
+	void RunWorker();
+	void RunCase(DepthMapProcessor* processor, const TestCase& testCase, CaseResult& result) const;
+	static DepthMapProcessor* CreateProcessor();
+	static const int GetMode(std::vector<int> values);
+	static const long long GetMedian(std::vector<long long> values);
+};
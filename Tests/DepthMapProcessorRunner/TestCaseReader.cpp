@@ -0,0 +1,159 @@
+#include "TestCaseReader.h"
+#include <algorithm>
+#include <experimental/filesystem>
+#include <fstream>
+#include <iterator>
+#include "DepthMapProcessorAPI.h"
+
+namespace fs = std::experimental::filesystem;
+
+void TestCase::AddDepthMap(const int width, const int height, std::vector<short>&& data)
+{
+	_depthMapData.emplace_back(std::move(data));
+
+	DepthMap depthMap{};
+	depthMap.Width = width;
+	depthMap.Height = height;
+	depthMap.Data = _depthMapData.back().data();
+	DepthMaps.emplace_back(depthMap);
+}
+
+const std::vector<std::string> TestCaseReader::GetCaseDirectories(const std::string& rootDirectory)
+{
+	std::vector<std::string> caseDirectories;
+
+	std::error_code errorCode;
+	if (!fs::is_directory(rootDirectory, errorCode))
+		return caseDirectories;
+
+	for (const auto& entry : fs::directory_iterator(rootDirectory))
+	{
+		if (fs::is_directory(entry.status()))
+			caseDirectories.emplace_back(entry.path().string());
+	}
+
+	// a stable order keeps reports of two runs comparable line by line
+	std::sort(caseDirectories.begin(), caseDirectories.end());
+
+	return caseDirectories;
+}
+
+const bool TestCaseReader::ReadTestCase(const std::string& caseDirectory, TestCase& testCase, std::string& error)
+{
+	const fs::path casePath(caseDirectory);
+	testCase.Name = casePath.filename().string();
+
+	if (!ReadDescription((casePath / "testdata.txt").string(), testCase.Description))
+	{
+		error = "test data file is missing or insufficient";
+		return false;
+	}
+
+	testCase.Image = cv::imread((casePath / "rgb.png").string(), cv::IMREAD_COLOR);
+	if (testCase.Image.empty())
+	{
+		error = "failed to read rgb.png";
+		return false;
+	}
+
+	std::error_code errorCode;
+	const fs::path mapsPath = casePath / "maps";
+	if (!fs::is_directory(mapsPath, errorCode))
+	{
+		error = "maps folder is missing";
+		return false;
+	}
+
+	std::vector<fs::path> mapPaths;
+	for (const auto& entry : fs::directory_iterator(mapsPath))
+		mapPaths.emplace_back(entry.path());
+	std::sort(mapPaths.begin(), mapPaths.end());
+
+	for (const auto& mapPath : mapPaths)
+	{
+		const std::string extension = mapPath.extension().string();
+		if (extension == ".dm" && !ReadTextDepthMap(mapPath.string(), testCase))
+		{
+			error = "failed to read " + mapPath.filename().string();
+			return false;
+		}
+
+		if (extension == ".dmz" && !ReadEncodedDepthMap(mapPath.string(), testCase))
+		{
+			error = "failed to read " + mapPath.filename().string();
+			return false;
+		}
+	}
+
+	if (testCase.DepthMaps.empty())
+	{
+		error = "no depth maps were found";
+		return false;
+	}
+
+	return true;
+}
+
+const bool TestCaseReader::ReadDescription(const std::string& filepath, TestCaseDescription& description)
+{
+	std::ifstream stream(filepath);
+	if (!stream.good())
+		return false;
+
+	stream >> description.LengthMm >> description.WidthMm >> description.HeightMm
+		>> description.FloorDepthMm >> description.MinObjHeightMm;
+
+	return !stream.fail();
+}
+
+const bool TestCaseReader::ReadTextDepthMap(const std::string& filepath, TestCase& testCase)
+{
+	std::ifstream stream(filepath);
+	if (!stream.good())
+		return false;
+
+	int width = 0;
+	int height = 0;
+	stream >> width >> height;
+	if (stream.fail() || width <= 0 || height <= 0)
+		return false;
+
+	const int mapLength = width * height;
+	std::vector<short> data(mapLength);
+	for (int i = 0; i < mapLength; i++)
+	{
+		if (!(stream >> data[i]))
+			return false;
+	}
+
+	testCase.AddDepthMap(width, height, std::move(data));
+
+	return true;
+}
+
+const bool TestCaseReader::ReadEncodedDepthMap(const std::string& filepath, TestCase& testCase)
+{
+	std::ifstream stream(filepath, std::ios::binary);
+	if (!stream.good())
+		return false;
+
+	const std::vector<byte> encodedData((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	int width = 0;
+	int height = 0;
+	if (ReadEncodedDepthMapHeader(encodedData.data(), (int)encodedData.size(), &width, &height) < 0)
+		return false;
+
+	std::vector<short> data(width * height);
+	DepthMap depthMap{};
+	depthMap.Width = width;
+	depthMap.Height = height;
+	depthMap.Data = data.data();
+
+	if (DecodeDepthMap(encodedData.data(), (int)encodedData.size(), depthMap) < 0)
+		return false;
+
+	testCase.AddDepthMap(width, height, std::move(data));
+
+	return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "OpenCVInclude.h"
+#include "Structures.h"
+
+// A recorded case is a directory laid out the same way VolumeCalculationRunner expects it:
+//   testdata.txt - expected length, width and height, floor depth and min object height in mm, one per line
+//   rgb.png      - color frame used for every depth map of the case
+//   maps/        - depth maps, either text .dm files or encoded .dmz files
+
+struct TestCaseDescription
+{
+	int LengthMm;
+	int WidthMm;
+	int HeightMm;
+	short FloorDepthMm;
+	short MinObjHeightMm;
+};
+
+class TestCase
+{
+private:
+	std::vector<std::vector<short>> _depthMapData;
+
+public:
+	std::string Name;
+	TestCaseDescription Description;
+	std::vector<DepthMap> DepthMaps;
+	cv::Mat Image;
+
+	void AddDepthMap(const int width, const int height, std::vector<short>&& data);
+};
+
+class TestCaseReader
+{
+public:
+	static const std::vector<std::string> GetCaseDirectories(const std::string& rootDirectory);
+	static const bool ReadTestCase(const std::string& caseDirectory, TestCase& testCase, std::string& error);
+
+private:
+	static const bool ReadDescription(const std::string& filepath, TestCaseDescription& description);
+	static const bool ReadTextDepthMap(const std::string& filepath, TestCase& testCase);
+	static const bool ReadEncodedDepthMap(const std::string& filepath, TestCase& testCase);
+};
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RegressionRunner.h"
+#include "TestCaseReader.h"
+
+// usage: DepthMapProcessorRunner [cases directory] [--threads N]
+// the cases directory defaults to the one VolumeCalculationRunner uses, so both runners can share a corpus
+
+const char* TestPathEnvVar = "VCALC_TEST_PATH";
+const char Tab = '\t';
+
+const long long GetPercentile(const std::vector<long long>& sortedValues, const double percentile)
+{
+	if (sortedValues.empty())
+		return 0;
+
+	const int index = (int)std::ceil(percentile / 100.0 * sortedValues.size()) - 1;
+
+	return sortedValues[std::min(std::max(index, 0), (int)sortedValues.size() - 1)];
+}
+
+const double GetAccuracy(const double measured, const double expected)
+{
+	if (expected <= 0)
+		return 0;
+
+	return std::max(0.0, 1 - std::abs(measured - expected) / expected);
+}
+
+const char* GetAlgorithmName(const AlgorithmSelectionStatus algorithm)
+{
+	switch (algorithm)
+	{
+	case AlgorithmSelectionStatus::Dm1:
+		return "Dm1";
+	case AlgorithmSelectionStatus::Dm2:
+		return "Dm2";
+	case AlgorithmSelectionStatus::Rgb:
+		return "Rgb";
+	case AlgorithmSelectionStatus::NoObjectFound:
+		return "NoObject";
+	default:
+		return "-";
+	}
+}
+
+void PrintLatencies(const char* title, std::vector<long long> latenciesUs)
+{
+	std::sort(latenciesUs.begin(), latenciesUs.end());
+
+	std::cout << title << " latency, ms: p50=" << GetPercentile(latenciesUs, 50) / 1000.0
+		<< ", p90=" << GetPercentile(latenciesUs, 90) / 1000.0
+		<< ", p99=" << GetPercentile(latenciesUs, 99) / 1000.0
+		<< ", max=" << GetPercentile(latenciesUs, 100) / 1000.0 << std::endl;
+}
+
+void PrintReport(const RegressionRunner& runner)
+{
+	const std::vector<CaseResult>& results = runner.GetResults();
+
+	std::cout << "Name" << Tab << "Algorithm" << Tab << "GT length" << Tab << "GT width" << Tab << "GT height"
+		<< Tab << "Length" << Tab << "Width" << Tab << "Height" << Tab << "dLength" << Tab << "dWidth" << Tab << "dHeight"
+		<< Tab << "Volume accuracy" << Tab << "Frames" << Tab << "Case ms" << Tab << "Error" << std::endl;
+
+	int processedCount = 0;
+	int frameCount = 0;
+	long long processingTimeUs = 0;
+	double lengthAccuracySum = 0;
+	double widthAccuracySum = 0;
+	double heightAccuracySum = 0;
+	double volumeAccuracySum = 0;
+	std::vector<long long> frameLatenciesUs;
+	std::vector<long long> caseLatenciesUs;
+
+	std::cout << std::fixed << std::setprecision(2);
+
+	for (const CaseResult& result : results)
+	{
+		const TestCaseDescription& expected = result.Expected;
+		const double expectedVolume = (double)expected.LengthMm * expected.WidthMm * expected.HeightMm;
+		const double measuredVolume = (double)result.LengthMm * result.WidthMm * result.HeightMm;
+		const double volumeAccuracy = GetAccuracy(measuredVolume, expectedVolume);
+
+		std::cout << result.Name << Tab << GetAlgorithmName(result.Algorithm);
+		if (result.IsProcessed)
+		{
+			std::cout << Tab << expected.LengthMm << Tab << expected.WidthMm << Tab << expected.HeightMm
+				<< Tab << result.LengthMm << Tab << result.WidthMm << Tab << result.HeightMm
+				<< Tab << result.LengthMm - expected.LengthMm << Tab << result.WidthMm - expected.WidthMm
+				<< Tab << result.HeightMm - expected.HeightMm << Tab << volumeAccuracy * 100 << "%";
+		}
+		else
+			std::cout << Tab << Tab << Tab << Tab << Tab << Tab << Tab << Tab << Tab << Tab;
+		std::cout << Tab << result.FrameCount << Tab << result.CaseLatencyUs / 1000.0 << Tab << result.Error << std::endl;
+
+		frameCount += result.FrameCount;
+		processingTimeUs += result.CaseLatencyUs;
+		frameLatenciesUs.insert(frameLatenciesUs.end(), result.FrameLatenciesUs.begin(), result.FrameLatenciesUs.end());
+		if (result.CaseLatencyUs > 0)
+			caseLatenciesUs.emplace_back(result.CaseLatencyUs);
+
+		if (!result.IsProcessed)
+			continue;
+
+		processedCount++;
+		lengthAccuracySum += GetAccuracy(result.LengthMm, expected.LengthMm);
+		widthAccuracySum += GetAccuracy(result.WidthMm, expected.WidthMm);
+		heightAccuracySum += GetAccuracy(result.HeightMm, expected.HeightMm);
+		volumeAccuracySum += volumeAccuracy;
+	}
+
+	const int failedCount = (int)results.size() - processedCount;
+	const double wallTimeS = runner.GetWallTimeUs() / 1000000.0;
+	// processing time of all workers spread over the workers, file loading is left out
+	const double processingTimeS = processingTimeUs / 1000000.0 / runner.GetWorkerCount();
+	const int accuracyDivider = std::max(processedCount, 1);
+
+	std::cout << std::endl;
+	std::cout << "cases: " << results.size() << ", processed: " << processedCount << ", failed: " << failedCount
+		<< ", workers: " << runner.GetWorkerCount() << std::endl;
+	std::cout << "avg accuracy: length " << lengthAccuracySum / accuracyDivider * 100
+		<< "%, width " << widthAccuracySum / accuracyDivider * 100
+		<< "%, height " << heightAccuracySum / accuracyDivider * 100
+		<< "%, volume " << volumeAccuracySum / accuracyDivider * 100 << "%" << std::endl;
+	std::cout << "wall time: " << wallTimeS << " s, frames: " << frameCount << std::endl;
+	if (processingTimeS > 0)
+	{
+		std::cout << "throughput: " << frameCount / processingTimeS << " frames/s, "
+			<< results.size() / processingTimeS << " cases/s" << std::endl;
+	}
+	PrintLatencies("frame", frameLatenciesUs);
+	PrintLatencies("case", caseLatenciesUs);
+}
+
+int main(int argc, char* argv[])
+{
+	std::string casesDirectory;
+	int workerCount = (int)std::thread::hardware_concurrency();
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--threads" && i + 1 < argc)
+			workerCount = std::atoi(argv[++i]);
+		else
+			casesDirectory = argument;
+	}
+
+	if (casesDirectory.empty())
+	{
+		const char* testPath = std::getenv(TestPathEnvVar);
+		if (testPath != nullptr)
+			casesDirectory = testPath;
+	}
+
+	if (casesDirectory.empty())
+	{
+		std::cout << "usage: DepthMapProcessorRunner [cases directory] [--threads N]" << std::endl;
+		std::cout << "the cases directory can also be set with " << TestPathEnvVar << std::endl;
+		return 1;
+	}
+
+	const std::vector<std::string>& caseDirectories = TestCaseReader::GetCaseDirectories(casesDirectory);
+	if (caseDirectories.empty())
+	{
+		std::cout << "no test cases were found in " << casesDirectory << std::endl;
+		return 1;
+	}
+
+	RegressionRunner runner(caseDirectories, std::min(workerCount, (int)caseDirectories.size()));
+	runner.Run();
+
+	PrintReport(runner);
+
+	const bool allCasesWereProcessed = std::all_of(runner.GetResults().begin(), runner.GetResults().end(),
+		[](const CaseResult& result) { return result.IsProcessed; });
+
+	return allCasesWereProcessed ? 0 : 2;
+}
@@ -149,10 +149,50 @@ void TestVolumeCalculation()
 	delete depthMap;
 }
 
+void TestDepthMapCodec()
+{
+	const DepthMap* const depthMap = Utils::ReadDepthMapFromFile("0.dm");
+	const int mapLength = depthMap->Width * depthMap->Height;
+
+	const int maxEncodedLength = GetMaxEncodedDepthMapLength(depthMap->Width, depthMap->Height);
+	std::vector<byte> encodedData(maxEncodedLength);
+
+	DepthMap decodedMap{};
+	decodedMap.Width = depthMap->Width;
+	decodedMap.Height = depthMap->Height;
+	decodedMap.Data = new short[mapLength];
+
+	const int numTests = 1000;
+	int encodedLength = 0;
+
+	const auto encodeBegin = std::chrono::steady_clock::now();
+	for (int i = 0; i < numTests; i++)
+		encodedLength = EncodeDepthMap(*depthMap, encodedData.data(), maxEncodedLength);
+	const auto encodeEnd = std::chrono::steady_clock::now();
+
+	int decodedLength = 0;
+	for (int i = 0; i < numTests; i++)
+		decodedLength = DecodeDepthMap(encodedData.data(), encodedLength, decodedMap);
+	const auto decodeEnd = std::chrono::steady_clock::now();
+
+	const bool mapsAreEqual = decodedLength == encodedLength &&
+		memcmp(depthMap->Data, decodedMap.Data, mapLength * sizeof(short)) == 0;
+	const auto encodeUs = std::chrono::duration_cast<std::chrono::microseconds>(encodeEnd - encodeBegin).count() / numTests;
+	const auto decodeUs = std::chrono::duration_cast<std::chrono::microseconds>(decodeEnd - encodeEnd).count() / numTests;
+	const float compressionRatio = (mapLength * sizeof(short)) / (float)encodedLength;
+
+	std::cout << "depth codec: lossless=" << (mapsAreEqual ? "yes" : "NO") << ", ratio=" << compressionRatio
+		<< ", encode " << encodeUs << " us, decode " << decodeUs << " us" << std::endl;
+
+	delete[] decodedMap.Data;
+	delete depthMap;
+}
+
 int main(int argc, char* argv[])
 {
 	TestFloorDepth();
 	TestVolumeCalculation();
+	TestDepthMapCodec();
 
 	std::cout << std::endl << "press any button to exit" << std::endl;
 	std::cin.get();
@@ -1,4 +1,5 @@
-﻿using Primitives;
+﻿using FrameProcessor;
+using Primitives;
 using ProcessingUtils;
 
 namespace VolumeCalculationRunner
@@ -41,12 +42,14 @@ namespace VolumeCalculationRunner
 
 		private static async Task<IEnumerable<DepthMap>> ReadDepthMapsFromFolderAsync(string testCaseName, DirectoryInfo directory)
 		{
-			var files = directory.EnumerateFiles().Where(f => f.Extension == ".dm");
+			var files = directory.EnumerateFiles().Where(f => f.Extension == ".dm" || f.Extension == DepthMapCodec.FileExtension);
 
 			var depthMaps = new List<DepthMap>(files.Count());
 			foreach (var file in files)
 			{
-				var depthMap = await DepthMapUtils.ReadDepthMapFromRawFileAsync(file.FullName);
+				var depthMap = file.Extension == DepthMapCodec.FileExtension
+					? await DepthMapCodec.ReadDepthMapFromFileAsync(file.FullName)
+					: await DepthMapUtils.ReadDepthMapFromRawFileAsync(file.FullName);
 				if (depthMap == null)
 				{
 					Console.WriteLine($@"Failed to read depth map from {file.Name} for {testCaseName}");
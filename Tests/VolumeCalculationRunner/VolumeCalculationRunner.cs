@@ -150,18 +150,18 @@ namespace VolumeCalculationRunner
 
 					var cutOffDepth = (short)(testCaseData.FloorDepthMm - testCaseData.MinObjHeightMm);
 					var calctulationData = new VolumeCalculationData(settings.AlgorithmSettings.SampleDepthMapCount,
+						settings.AlgorithmSettings.MinSampleDepthMapCount, settings.AlgorithmSettings.SampleToleranceMm,
 						"000", 0, true, true, true, "", 0);
 
 					processor.SetProcessorSettings(settings);
 
 					var dummyLogger = new DummyLogger();
-					var volumeCalculator = new VolumeCalculator(dummyLogger, processor);
+					using var volumeCalculator = new VolumeCalculator(dummyLogger, processor, calctulationData);
 
 					// pad images to be the same length as maps
 					var duplicatedImagesArray = Enumerable.Repeat(testCaseData.Image, calctulationData.RequiredSampleCount).ToImmutableList();
 
-					var calculationResult = volumeCalculator.Calculate(duplicatedImagesArray, testCaseData.DepthMaps.ToImmutableList(),
-						calctulationData, -1);
+					var calculationResult = volumeCalculator.Calculate(duplicatedImagesArray, testCaseData.DepthMaps.ToImmutableList(), -1);
 
 					var status = calculationResult.Status == CalculationStatus.Successful ? 
 						TestCaseResultType.Success : TestCaseResultType.ProcessingFailure;
@@ -0,0 +1,82 @@
+﻿using FrameProcessor;
+using Primitives;
+
+namespace VolumeCalculatorTests
+{
+	[TestFixture]
+	internal class DepthMapCodecTest
+	{
+		[Test]
+		public void Decode_WhenGivenEncodedEmptyMap_ReturnsEmptyMapOfSameSize()
+		{
+			const int mapWidth = 64;
+			const int mapHeight = 48;
+			var map = new DepthMap(mapWidth, mapHeight);
+
+			var encodedData = DepthMapCodec.Encode(map);
+			var decodedMap = DepthMapCodec.Decode(encodedData);
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(decodedMap.Width, Is.EqualTo(mapWidth));
+				Assert.That(decodedMap.Height, Is.EqualTo(mapHeight));
+				Assert.That(decodedMap.Data, Is.EqualTo(map.Data));
+			});
+		}
+
+		[Test]
+		public void Decode_WhenGivenEncodedMapWithSurfacesHolesAndSpikes_ReturnsIdenticalMap()
+		{
+			const int mapWidth = 320;
+			const int mapHeight = 240;
+			var random = new Random(42);
+			var mapData = new short[mapWidth * mapHeight];
+			for (var j = 0; j < mapHeight; j++)
+			{
+				for (var i = 0; i < mapWidth; i++)
+				{
+					var index = j * mapWidth + i;
+					if (random.Next(10) == 0)
+						mapData[index] = 0;
+					else if (random.Next(500) == 0)
+						mapData[index] = (short)random.Next(short.MinValue, short.MaxValue);
+					else
+						mapData[index] = (short)(1500 + i / 4 + random.Next(3));
+				}
+			}
+
+			var map = new DepthMap(mapWidth, mapHeight, mapData);
+
+			var encodedData = DepthMapCodec.Encode(map);
+			var decodedMap = DepthMapCodec.Decode(encodedData);
+
+			Assert.That(decodedMap.Data, Is.EqualTo(map.Data));
+		}
+
+		[Test]
+		public void Encode_WhenGivenMostlyEmptyMap_ReturnsDataSmallerThanRawMap()
+		{
+			const int mapWidth = 640;
+			const int mapHeight = 480;
+			var map = new DepthMap(mapWidth, mapHeight);
+			for (var i = 0; i < 100; i++)
+				map.Data[mapWidth * 200 + 300 + i] = 1200;
+
+			var encodedData = DepthMapCodec.Encode(map);
+
+			Assert.That(encodedData, Has.Length.LessThan(map.Data.Length * sizeof(short) / 10));
+		}
+
+		[Test]
+		public void Decode_WhenGivenTruncatedData_ThrowsInvalidDataException()
+		{
+			var map = new DepthMap(16, 9);
+			map.Data[5] = 800;
+
+			var encodedData = DepthMapCodec.Encode(map);
+			var truncatedData = encodedData.Take(encodedData.Length - 1).ToArray();
+
+			Assert.Throws<InvalidDataException>(() => DepthMapCodec.Decode(truncatedData));
+		}
+	}
+}
@@ -1,12 +1,19 @@
 using FrameProcessor;
+using FrameProviders;
 using Primitives;
 using Primitives.Logging;
+using Primitives.Settings;
 
 namespace VolumeCalculatorTests
 {
 	[TestFixture]
 	internal class DepthMapProcessorTest : IDisposable
 	{
+		// the scene of the measurement tests: a flat floor seen by a 128x96 depth camera
+		private const short FloorDepth = 1500;
+		private const int MapWidth = 128;
+		private const int MapHeight = 96;
+
 		private ILogger _logger;
 
 		[SetUp]
@@ -69,6 +76,40 @@ namespace VolumeCalculatorTests
 			Assert.That(floorDepth, Is.EqualTo(modeDepthValue));
 		}
 
+		[Test]
+		public void CalculateFloorPlane_WhenGivenAnEmptyMap_ReturnsNull()
+		{
+			var emptyMap = new DepthMap(MapWidth, MapHeight, new short[MapWidth * MapHeight]);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			var floorPlane = processor.CalculateFloorPlane(emptyMap);
+			Assert.That(floorPlane, Is.Null);
+		}
+
+		[Test]
+		public void CalculateFloorPlane_WhenGivenAFlatFloor_ReturnsAPlaneWithoutSlope()
+		{
+			var map = new DepthMap(MapWidth, MapHeight, CreateFloorMapData());
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			var floorPlane = processor.CalculateFloorPlane(map);
+			Assert.That(floorPlane, Is.Not.Null);
+			Assert.That(floorPlane.Offset, Is.EqualTo(FloorDepth).Within(1));
+			Assert.That(floorPlane.SlopeX, Is.EqualTo(0).Within(0.001));
+			Assert.That(floorPlane.SlopeY, Is.EqualTo(0).Within(0.001));
+		}
+
+		[Test]
+		public void UpdateColorBackground_WhenSceneIsEmpty_LearnsTheFrame()
+		{
+			var image = new ImageData(MapWidth, MapHeight, new byte[MapWidth * MapHeight * 3], 3);
+			var map = new DepthMap(MapWidth, MapHeight, CreateFloorMapData());
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			var frameWasLearned = processor.UpdateColorBackground(map, image);
+			Assert.That(frameWasLearned, Is.True);
+		}
+
 		[Test]
 		public void SelectAlgorithm_WhenMapAndImageAreEmpty_ReturnsNoObjectFoundResult()
 		{
@@ -82,6 +123,302 @@ namespace VolumeCalculatorTests
 			Assert.That(algorithmSelectionResult.Status, Is.EqualTo(AlgorithmSelectionStatus.NoObjectFound));
 		}
 
+		[TestCase(0, 0)]
+		[TestCase(1, 3)]
+		[TestCase(2, 1)]
+		[TestCase(3, 2)]
+		public void SelectAlgorithm_WhenObjectHasMinimumDetectableSize_FindsItInAnyAlignment(int offsetX, int offsetY)
+		{
+			// the empty scene probe samples every 4th pixel of every 4th row
+			const int minDetectableObjectSizePx = 4;
+			const short objectDepth = 1300;
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var emptyMap = new DepthMap(MapWidth, MapHeight, CreateFloorMapData());
+
+			var mapData = CreateFloorMapData();
+			for (var j = 0; j < minDetectableObjectSizePx; j++)
+			{
+				for (var i = 0; i < minDetectableObjectSizePx; i++)
+					mapData[(MapHeight / 2 + offsetY + j) * MapWidth + MapWidth / 2 + offsetX + i] = objectDepth;
+			}
+			var map = new DepthMap(MapWidth, MapHeight, mapData);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+
+			// the probe only runs once the processor has seen a frame of this resolution
+			var emptyResult = processor.SelectAlgorithm(new AlgorithmSelectionData(emptyMap, image, 0, true, false, false, ""));
+			Assert.That(emptyResult.Status, Is.EqualTo(AlgorithmSelectionStatus.NoObjectFound));
+
+			var result = processor.SelectAlgorithm(new AlgorithmSelectionData(map, image, 0, true, false, false, ""));
+			Assert.That(result.Status, Is.EqualTo(AlgorithmSelectionStatus.Dm1));
+		}
+
+		[TestCase(2, false)]
+		[TestCase(4, false)]
+		[TestCase(4, true)]
+		public void CalculateVolume_WhenDepthIsDecimated_MeasuresAsAtFullResolution(int decimationFactor, bool useMedian)
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 51, 37, 23, 17, 1300);
+			var map = new DepthMap(MapWidth, MapHeight, mapData);
+
+			var workArea = CreateWorkArea();
+			using var processor = CreateProcessor(workArea);
+			var fullResolutionResult = processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			workArea.DepthDecimationFactor = decimationFactor;
+			workArea.UseMedianDepthDecimation = useMedian;
+			processor.SetWorkAreaSettings(workArea);
+			var decimatedResult = processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			Assert.That(fullResolutionResult, Is.Not.Null);
+			Assert.That(decimatedResult, Is.Not.Null);
+			Assert.Multiple(() =>
+			{
+				Assert.That(decimatedResult.LengthMm, Is.EqualTo(fullResolutionResult.LengthMm));
+				Assert.That(decimatedResult.WidthMm, Is.EqualTo(fullResolutionResult.WidthMm));
+				Assert.That(decimatedResult.HeightMm, Is.EqualTo(fullResolutionResult.HeightMm));
+				Assert.That(decimatedResult.VolumeMm3, Is.EqualTo(fullResolutionResult.VolumeMm3));
+			});
+		}
+
+		[TestCase(false, 10)]
+		[TestCase(true, 1)]
+		public void CalculateVolume_WhenGivenABoxOnAFlatFloor_MeasuresItsVolume(bool useIntegratedVolume, double tolerancePercent)
+		{
+			const short objectDepth = 1300;
+			const int objectWidthPx = 40;
+			const int objectHeightPx = 30;
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 44, 33, objectWidthPx, objectHeightPx, objectDepth);
+			var map = new DepthMap(MapWidth, MapHeight, mapData);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			var result = processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			// every pixel of the box's top covers depth / focal length millimeters on a side
+			var depthCameraParams = GetDepthCameraParams();
+			var lengthMm = objectWidthPx * objectDepth / depthCameraParams.FocalLengthX;
+			var widthMm = objectHeightPx * objectDepth / depthCameraParams.FocalLengthY;
+			var expectedVolumeMm3 = lengthMm * widthMm * (FloorDepth - objectDepth);
+
+			// the box dimensions run between the centers of the edge pixels, half a pixel short on every side
+			Assert.That(result, Is.Not.Null);
+			var volumeMm3 = useIntegratedVolume ? result.VolumeMm3 : (long)result.LengthMm * result.WidthMm * result.HeightMm;
+			Assert.That(volumeMm3, Is.EqualTo(expectedVolumeMm3).Within(tolerancePercent).Percent);
+		}
+
+		[Test]
+		public void CalculateVolume_WhenDepthIsDenoised_IgnoresSpeckleAndHoles()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 51, 37, 23, 17, 1300);
+			var cleanMap = new DepthMap(MapWidth, MapHeight, mapData.ToArray());
+
+			// a flying pixel next to the box and a few missing pixels on its edge
+			mapData[30 * MapWidth + 80] = 1250;
+			mapData[37 * MapWidth + 60] = 0;
+			mapData[45 * MapWidth + 73] = 0;
+			var noisyMap = new DepthMap(MapWidth, MapHeight, mapData);
+
+			var workArea = CreateWorkArea();
+			using var processor = CreateProcessor(workArea);
+			var cleanResult = processor.CalculateVolume(cleanMap, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			workArea.UseDepthDenoising = true;
+			processor.SetWorkAreaSettings(workArea);
+			var denoisedResult = processor.CalculateVolume(noisyMap, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			Assert.That(cleanResult, Is.Not.Null);
+			Assert.That(denoisedResult, Is.Not.Null);
+			Assert.Multiple(() =>
+			{
+				Assert.That(denoisedResult.LengthMm, Is.EqualTo(cleanResult.LengthMm));
+				Assert.That(denoisedResult.WidthMm, Is.EqualTo(cleanResult.WidthMm));
+				Assert.That(denoisedResult.HeightMm, Is.EqualTo(cleanResult.HeightMm));
+			});
+		}
+
+		[Test]
+		public void CalculateVolume_WhenObjectMovesInTheImage_MeasuresTheSameFootprint()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var centeredMapData = CreateFloorMapData();
+			FillRect(centeredMapData, MapWidth, 51, 37, 23, 17, 1300);
+			var centeredMap = new DepthMap(MapWidth, MapHeight, centeredMapData);
+			var shiftedMapData = CreateFloorMapData();
+			FillRect(shiftedMapData, MapWidth, 80, 60, 23, 17, 1300);
+			var shiftedMap = new DepthMap(MapWidth, MapHeight, shiftedMapData);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			var centeredResult = processor.CalculateVolume(centeredMap, image, 0, AlgorithmSelectionStatus.Dm1);
+			var shiftedResult = processor.CalculateVolume(shiftedMap, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			Assert.That(centeredResult, Is.Not.Null);
+			Assert.That(shiftedResult, Is.Not.Null);
+			Assert.Multiple(() =>
+			{
+				Assert.That(centeredResult.LengthMm, Is.GreaterThan(centeredResult.WidthMm));
+				Assert.That(shiftedResult.LengthMm, Is.EqualTo(centeredResult.LengthMm));
+				Assert.That(shiftedResult.WidthMm, Is.EqualTo(centeredResult.WidthMm));
+			});
+		}
+
+		[Test]
+		public void CalculateVolume_WhenDepthMapHasTiming_ReportsItsFrameAndRecordsLatencies()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 51, 37, 23, 17, 1300);
+
+			var receivedTimestampUs = (DateTime.UtcNow - DateTime.UnixEpoch).Ticks / 10;
+			var captureTimestampUs = receivedTimestampUs - 20000;
+			var timing = new FrameTiming(42, captureTimestampUs, receivedTimestampUs);
+			var map = new DepthMap(MapWidth, MapHeight, mapData, timing);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+
+			DepthMapProcessor.ResetLatencyStats();
+			var result = processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+			var captureToCallbackStats = DepthMapProcessor.GetLatencyStats(LatencyStage.CaptureToCallback);
+			var processingToResultStats = DepthMapProcessor.GetLatencyStats(LatencyStage.ProcessingToResult);
+
+			Assert.That(result, Is.Not.Null);
+			Assert.Multiple(() =>
+			{
+				Assert.That(result.FrameNumber, Is.EqualTo(42));
+				Assert.That(result.CaptureTimestampUs, Is.EqualTo(captureTimestampUs));
+				Assert.That(captureToCallbackStats.Count, Is.EqualTo(1));
+				Assert.That(captureToCallbackStats.MedianUs, Is.EqualTo(20000));
+				Assert.That(processingToResultStats.Count, Is.EqualTo(1));
+			});
+		}
+
+		[Test]
+		public void CalculateVolume_WhenFrameChangesInPlaceAfterSelection_MeasuresTheNewContent()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 51, 37, 23, 17, 1300);
+			var map = new DepthMap(MapWidth, MapHeight, mapData);
+
+			var workArea = CreateWorkArea();
+			using var processor = CreateProcessor(workArea);
+
+			var selection = processor.SelectAlgorithm(new AlgorithmSelectionData(map, image, 0, true, false, false, ""));
+			var selectedFrameResult = processor.CalculateVolume(map, image, 0, selection.Status);
+
+			// a pooled buffer is refilled with the next frame, the analysis of the previous one must not be reused
+			FillRect(mapData, MapWidth, 41, 27, 43, 37, 1300);
+			var refilledFrameResult = processor.CalculateVolume(map, image, 0, selection.Status);
+
+			using var freshProcessor = CreateProcessor(workArea);
+			var expectedResult = freshProcessor.CalculateVolume(map, image, 0, selection.Status);
+
+			Assert.That(selectedFrameResult, Is.Not.Null);
+			Assert.That(refilledFrameResult, Is.Not.Null);
+			Assert.Multiple(() =>
+			{
+				Assert.That(refilledFrameResult.LengthMm, Is.GreaterThan(selectedFrameResult.LengthMm));
+				Assert.That(refilledFrameResult.LengthMm, Is.EqualTo(expectedResult.LengthMm));
+				Assert.That(refilledFrameResult.WidthMm, Is.EqualTo(expectedResult.WidthMm));
+				Assert.That(refilledFrameResult.HeightMm, Is.EqualTo(expectedResult.HeightMm));
+			});
+		}
+
+		[Test]
+		public void CalculateVolumes_WhenGivenTwoObjects_MeasuresBothLargestFirst()
+		{
+			var mapData = CreateFloorMapData();
+			FillRect(mapData, MapWidth, 40, 35, 20, 20, 1300);
+			FillRect(mapData, MapWidth, 75, 45, 10, 10, 1400);
+			var map = new DepthMap(MapWidth, MapHeight, mapData);
+
+			using var processor = CreateProcessor(CreateWorkArea());
+
+			var objects = processor.CalculateVolumes(map);
+			Assert.That(objects, Has.Count.EqualTo(2));
+			Assert.That(objects[0].HeightMm, Is.EqualTo(200));
+			Assert.That(objects[1].HeightMm, Is.EqualTo(100));
+			Assert.That(objects[0].Center.X, Is.LessThan(objects[1].Center.X));
+			Assert.That(objects[0].Footprint, Has.Count.EqualTo(4));
+		}
+
+		[Test]
+		public void ProcessConveyorFrame_WhenObjectMovesThroughTheZone_ReportsItOnce()
+		{
+			using var processor = CreateProcessor(CreateWorkArea());
+
+			var reportedObjects = new List<ConveyorObjectData>();
+			for (var x = 10; x < 110; x += 4)
+			{
+				var mapData = CreateFloorMapData();
+				FillRect(mapData, MapWidth, x, 40, 16, 16, 1300);
+				reportedObjects.AddRange(processor.ProcessConveyorFrame(new DepthMap(MapWidth, MapHeight, mapData)));
+			}
+
+			Assert.That(reportedObjects, Has.Count.EqualTo(1));
+			Assert.That(reportedObjects[0].ObjectId, Is.EqualTo(1));
+			Assert.That(reportedObjects[0].HeightMm, Is.EqualTo(200));
+		}
+
+		[Test]
+		public void WriteTrace_WhenTracingIsEnabled_WritesTheTracedStages()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var map = new DepthMap(MapWidth, MapHeight, CreateFloorMapData());
+			var tracePath = Path.GetTempFileName();
+
+			using var processor = CreateProcessor(CreateWorkArea());
+			try
+			{
+				DepthMapProcessor.SetTracingEnabled(true);
+				processor.SelectAlgorithm(new AlgorithmSelectionData(map, image, 0, true, true, true, ""));
+				var traceWasWritten = DepthMapProcessor.WriteTrace(tracePath);
+
+				Assert.That(traceWasWritten, Is.True);
+				Assert.That(File.ReadAllText(tracePath), Does.Contain("\"name\":\"DepthMapProcessor::SelectAlgorithm\""));
+			}
+			finally
+			{
+				DepthMapProcessor.SetTracingEnabled(false);
+				File.Delete(tracePath);
+			}
+		}
+
+		[Test]
+		public void CalculateVolume_WhenProcessorIsRestarted_LoadsTheCalibrationFromTheCache()
+		{
+			var image = new ImageData(1, 1, new byte[3], 3);
+			var map = new DepthMap(MapWidth, MapHeight, CreateFloorMapData());
+			var tracePath = Path.GetTempFileName();
+
+			// the first processor leaves the calibration of the work area in the cache
+			using (var processor = CreateProcessor(CreateWorkArea()))
+				processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+
+			try
+			{
+				DepthMapProcessor.SetTracingEnabled(true);
+				using (var processor = CreateProcessor(CreateWorkArea()))
+					processor.CalculateVolume(map, image, 0, AlgorithmSelectionStatus.Dm1);
+				DepthMapProcessor.WriteTrace(tracePath);
+
+				// only the update that the settings start is traced under this name, the frame did not have to start one
+				var trace = File.ReadAllText(tracePath);
+				Assert.That(trace, Does.Contain("\"name\":\"CalibrationUtils::LoadOrBuildCalibration\""));
+				Assert.That(trace, Does.Not.Contain("\"name\":\"CalibrationUtils::BuildCalibration\""));
+			}
+			finally
+			{
+				DepthMapProcessor.SetTracingEnabled(false);
+				File.Delete(tracePath);
+			}
+		}
+
 		[Test]
 		public void SelectAlgorithm_WhenNoModeIsAvailable_ReturnsNoModesAreAvailable()
 		{
@@ -148,5 +485,40 @@ namespace VolumeCalculatorTests
 		{
 			_logger?.Dispose();
 		}
+
+		private DepthMapProcessor CreateProcessor(WorkAreaSettings workArea)
+		{
+			var processor = new DepthMapProcessor(_logger, TestUtils.GetDummyColorCameraParams(), GetDepthCameraParams());
+			processor.SetWorkAreaSettings(workArea);
+
+			return processor;
+		}
+
+		private static DepthCameraParams GetDepthCameraParams()
+		{
+			return new DepthCameraParams(70.6f, 60.0f, 92.0f, 92.0f, 64.0f, 48.0f, 300, 10000);
+		}
+
+		private static WorkAreaSettings CreateWorkArea()
+		{
+			var workArea = WorkAreaSettings.GetDefaultSettings();
+			workArea.FloorDepth = FloorDepth;
+
+			return workArea;
+		}
+
+		private static short[] CreateFloorMapData()
+		{
+			return Enumerable.Repeat(FloorDepth, MapWidth * MapHeight).ToArray();
+		}
+
+		private static void FillRect(short[] mapData, int mapWidth, int x, int y, int width, int height, short depth)
+		{
+			for (var j = y; j < y + height; j++)
+			{
+				for (var i = x; i < x + width; i++)
+					mapData[j * mapWidth + i] = depth;
+			}
+		}
 	}
 }
@@ -93,5 +93,18 @@ namespace VolumeCalculatorTests
 				Assert.That(queue, Has.Count.EqualTo(queueSize));
 			});
 		}
+
+		[Test]
+		public void Enqueue_WhenGivenTheNumberOfElementsAboveTheLimit_DiscardsTheOldestItems()
+		{
+			const int queueSize = 2;
+			var discardedItems = new List<int>();
+			var queue = new FixedSizeQueue<int>(queueSize, discardedItems.Add);
+
+			for (var i = 0; i < queueSize + 2; i++)
+				queue.Enqueue(i);
+
+			Assert.That(discardedItems, Is.EqualTo(new[] { 0, 1 }));
+		}
 	}
 }
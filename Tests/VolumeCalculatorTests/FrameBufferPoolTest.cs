@@ -0,0 +1,82 @@
+﻿using Primitives;
+
+namespace VolumeCalculatorTests
+{
+	[TestFixture]
+	internal class FrameBufferPoolTest
+	{
+		private const int MapWidth = 4;
+		private const int MapHeight = 3;
+
+		[Test]
+		public void Ctor_WhenGivenCapacity_PreallocatesBuffers()
+		{
+			var pool = new FrameBufferPool<short>(MapWidth * MapHeight, 2);
+
+			Assert.That(pool.PooledCount, Is.EqualTo(2));
+		}
+
+		[Test]
+		public void Release_WhenMapHasNoOtherReferences_ReturnsItsBufferForTheNextMap()
+		{
+			var pool = new FrameBufferPool<short>(MapWidth * MapHeight, 1);
+			var depthMap = new DepthMap(MapWidth, MapHeight, pool);
+
+			depthMap.Release();
+			var nextDepthMap = new DepthMap(MapWidth, MapHeight, pool);
+
+			Assert.That(nextDepthMap.Data, Is.SameAs(depthMap.Data));
+		}
+
+		[Test]
+		public void Release_WhenMapIsRetained_KeepsItsBufferUntilTheLastRelease()
+		{
+			var pool = new FrameBufferPool<short>(MapWidth * MapHeight, 1);
+			var depthMap = new DepthMap(MapWidth, MapHeight, pool);
+
+			depthMap.Retain();
+			depthMap.Release();
+			var countAfterFirstRelease = pool.PooledCount;
+			depthMap.Release();
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(countAfterFirstRelease, Is.Zero);
+				Assert.That(pool.PooledCount, Is.EqualTo(1));
+			});
+		}
+
+		[Test]
+		public void Rent_WhenPoolIsEmpty_ReturnsANewBuffer()
+		{
+			var pool = new FrameBufferPool<byte>(MapWidth * MapHeight * 3, 1);
+			var image = new ImageData(MapWidth, MapHeight, 3, pool);
+
+			var nextImage = new ImageData(MapWidth, MapHeight, 3, pool);
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(nextImage.Data, Is.Not.SameAs(image.Data));
+				Assert.That(nextImage.Data, Has.Length.EqualTo(MapWidth * MapHeight * 3));
+			});
+		}
+
+		[Test]
+		public void Return_WhenPoolIsFull_DropsTheBuffer()
+		{
+			var pool = new FrameBufferPool<short>(MapWidth * MapHeight, 1);
+
+			pool.Return(new short[MapWidth * MapHeight]);
+
+			Assert.That(pool.PooledCount, Is.EqualTo(1));
+		}
+
+		[Test]
+		public void Ctor_WhenPoolBuffersDoNotFitTheMap_Throws()
+		{
+			var pool = new FrameBufferPool<short>(MapWidth * MapHeight, 1);
+
+			Assert.Throws<ArgumentException>(() => new DepthMap(MapWidth + 1, MapHeight, pool));
+		}
+	}
+}
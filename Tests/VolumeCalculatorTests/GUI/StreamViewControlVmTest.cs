@@ -101,6 +101,22 @@ namespace VolumeCalculatorTests.GUI
 			});
 		}
 
+		[Test]
+		public void UpdateDepthImage_WhenMapIsWiderThanThePreview_DownscalesItProportionally()
+		{
+			var depthMap = new DepthMap(1280, 720);
+			var vm = new StreamViewControlVm(_logger);
+
+			vm.UpdateDepthImage(depthMap);
+			vm.Dispose();
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(vm.DepthImageBitmap.Width, Is.EqualTo(640));
+				Assert.That(vm.DepthImageBitmap.Height, Is.EqualTo(360));
+			});
+		}
+
 		[Test]
 		public void UpdateDepthImage_WhenGivenValidDepthMap_CreatesProperImage()
 		{
@@ -0,0 +1,31 @@
+﻿using Primitives.Settings;
+using VCClient.ViewModels;
+
+namespace VolumeCalculatorTests.GUI
+{
+	[TestFixture]
+	internal class WorkAreaSettingsVmTest
+	{
+		[TestCase(false)]
+		[TestCase(true)]
+		public void GetSettings_WhenCreatedFromSettings_KeepsTheSettingsNotEditableInTheClient(bool useColorBackgroundModel)
+		{
+			var settings = WorkAreaSettings.GetDefaultSettings();
+			settings.UseColorBackgroundModel = useColorBackgroundModel;
+			settings.DepthDecimationFactor = 4;
+			settings.UseMedianDepthDecimation = true;
+			settings.UseDepthDenoising = true;
+			var vm = new WorkAreaSettingsVm(settings);
+
+			var result = vm.GetSettings();
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(result.UseColorBackgroundModel, Is.EqualTo(useColorBackgroundModel));
+				Assert.That(result.DepthDecimationFactor, Is.EqualTo(4));
+				Assert.That(result.UseMedianDepthDecimation, Is.True);
+				Assert.That(result.UseDepthDenoising, Is.True);
+			});
+		}
+	}
+}
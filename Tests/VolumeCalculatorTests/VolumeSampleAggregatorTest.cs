@@ -0,0 +1,64 @@
+﻿using FrameProcessor;
+
+namespace VolumeCalculatorTests
+{
+	[TestFixture]
+	internal class VolumeSampleAggregatorTest
+	{
+		[Test]
+		public void Add_WhenLatestSamplesAgree_ConvergesAfterTheMinimumSampleCount()
+		{
+			using var aggregator = new VolumeSampleAggregator(3, 10, 2);
+
+			var first = aggregator.Add(new ObjectVolumeData(100, 50, 30, 150000));
+			var second = aggregator.Add(new ObjectVolumeData(101, 50, 31, 156000));
+			var third = aggregator.Add(new ObjectVolumeData(100, 51, 30, 153000));
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(first.IsComplete, Is.False);
+				Assert.That(second.IsComplete, Is.False);
+				Assert.That(third.IsConverged, Is.True);
+				Assert.That(third.IsComplete, Is.True);
+				Assert.That(third.SampleCount, Is.EqualTo(3));
+				Assert.That(third.Result.LengthMm, Is.EqualTo(100));
+				Assert.That(third.Result.WidthMm, Is.EqualTo(50));
+				Assert.That(third.Result.HeightMm, Is.EqualTo(30));
+				Assert.That(third.Result.VolumeMm3, Is.EqualTo(153000));
+			});
+		}
+
+		[Test]
+		public void Add_WhenSamplesDisagree_CompletesAtTheMaximumSampleCountWithoutConverging()
+		{
+			using var aggregator = new VolumeSampleAggregator(2, 4, 2);
+
+			VolumeSampleAggregate aggregate = null;
+			foreach (var lengthMm in new[] { 100, 120, 100, 140 })
+				aggregate = aggregator.Add(new ObjectVolumeData(lengthMm, 50, 30, 0));
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(aggregate.IsConverged, Is.False);
+				Assert.That(aggregate.IsComplete, Is.True);
+				Assert.That(aggregate.LengthSpreadMm, Is.EqualTo(40));
+				Assert.That(aggregate.Result.LengthMm, Is.EqualTo(100));
+			});
+		}
+
+		[Test]
+		public void Add_WhenSampleHasFrameTiming_AttributesTheResultToTheLatestSample()
+		{
+			using var aggregator = new VolumeSampleAggregator(3, 5, 2);
+
+			aggregator.Add(new ObjectVolumeData(100, 50, 30, 0, 7, 1000));
+			var aggregate = aggregator.Add(new ObjectVolumeData(100, 50, 30, 0, 8, 2000));
+
+			Assert.Multiple(() =>
+			{
+				Assert.That(aggregate.Result.FrameNumber, Is.EqualTo(8));
+				Assert.That(aggregate.Result.CaptureTimestampUs, Is.EqualTo(2000));
+			});
+		}
+	}
+}
@@ -105,6 +105,7 @@ namespace VCClient.ViewModels
 		{
 			_dashboardControlVm?.Dispose();
 			_testDataGenerationControlVm?.Dispose();
+			_streamViewControlVm?.Dispose();
 		}
 
 		public void UpdateSettings(ApplicationSettings settings)
@@ -16,6 +16,7 @@ namespace VCClient.ViewModels
 		private bool _enablePalletSubtraction;
 		private double _palletWeightKg;
 		private int _palletHeightMm;
+		private bool _enableVolumeIntegration;
 
 		public byte SampleCount
 		{
@@ -71,6 +72,12 @@ namespace VCClient.ViewModels
 			set => SetField(ref _palletHeightMm, value, nameof(PalletHeightMm));
 		}
 
+		public bool EnableVolumeIntegration
+		{
+			get => _enableVolumeIntegration;
+			set => SetField(ref _enableVolumeIntegration, value, nameof(EnableVolumeIntegration));
+		}
+
 		public void FillValuesFromSettings(ApplicationSettings settings)
 		{
 			OutputPath = settings.GeneralSettings.OutputPath;
@@ -83,6 +90,7 @@ namespace VCClient.ViewModels
 			EnablePalletSubtraction = settings.AlgorithmSettings.EnablePalletSubtraction;
 			PalletWeightKg = settings.AlgorithmSettings.PalletWeightGr / 1000;
 			PalletHeightMm = settings.AlgorithmSettings.PalletHeightMm;
+			EnableVolumeIntegration = settings.AlgorithmSettings.EnableVolumeIntegration;
 		}
 	}
 }
\ No newline at end of file
@@ -46,7 +46,10 @@ namespace VCClient.ViewModels
 		public ApplicationSettings GetSettings()
 		{
 			var newGeneralSettings = new GeneralSettings(MiscControlVm.OutputPath,
-				_oldSettings.GeneralSettings.ShutDownPcByDefault);
+				_oldSettings.GeneralSettings.ShutDownPcByDefault)
+			{
+				EnableNativeTracing = _oldSettings.GeneralSettings.EnableNativeTracing
+			};
 			
 			var oldIoSettings = _oldSettings.IoSettings;
 			var newIoSettings = new IoSettings(oldIoSettings.ActiveCameraName, oldIoSettings.ActiveScales,
@@ -57,7 +60,12 @@ namespace VCClient.ViewModels
 			var newAlgorithmSettings = new AlgorithmSettings(newWorkAreaSettings, MiscControlVm.SampleCount, 
 				MiscControlVm.EnableAutoTimer, MiscControlVm.TimeToStartMeasurementMs, MiscControlVm.RequireBarcode, 
 				MiscControlVm.SelectedWeightUnits, MiscControlVm.EnablePalletSubtraction, 
-				MiscControlVm.PalletWeightKg * 1000, MiscControlVm.PalletHeightMm);
+				MiscControlVm.PalletWeightKg * 1000, MiscControlVm.PalletHeightMm)
+			{
+				EnableVolumeIntegration = MiscControlVm.EnableVolumeIntegration,
+				MinSampleDepthMapCount = _oldSettings.AlgorithmSettings.MinSampleDepthMapCount,
+				SampleToleranceMm = _oldSettings.AlgorithmSettings.SampleToleranceMm
+			};
 
 			return new ApplicationSettings(newGeneralSettings, newIoSettings, newAlgorithmSettings, _oldSettings.IntegrationSettings);
 		}
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Windows.Media.Imaging;
+using FrameProcessor;
 using GuiCommon;
 using Primitives;
 using Primitives.Logging;
@@ -7,9 +8,12 @@ using Primitives.Settings;
 
 namespace VCClient.ViewModels
 {
-	internal class StreamViewControlVm : BaseViewModel
+	internal class StreamViewControlVm : BaseViewModel, IDisposable
 	{
+		private const int MaxDepthPreviewWidth = 640;
+
 		private readonly ILogger _logger;
+		private readonly object _depthPreviewLock;
 
 		private short _minDepth;
 		private short _floorDepth;
@@ -23,6 +27,12 @@ namespace VCClient.ViewModels
 		private bool _useDepthMask;
 		private MaskPolygonControlVm _depthMaskPolygonControlVm;
 
+		private DepthPreviewRenderer _depthPreviewRenderer;
+		private ImageData _depthPreview;
+		private int _depthPreviewSourceWidth;
+		private int _depthPreviewSourceHeight;
+		private bool _isDisposed;
+
 		public WriteableBitmap ColorImageBitmap
 		{
 			get => _colorImageBitmap;
@@ -62,6 +72,7 @@ namespace VCClient.ViewModels
 		public StreamViewControlVm(ILogger logger)
 		{
 			_logger = logger;
+			_depthPreviewLock = new object();
 
 			ColorMaskPolygonControlVm = new MaskPolygonControlVm();
 			DepthMaskPolygonControlVm = new MaskPolygonControlVm();
@@ -104,8 +115,18 @@ namespace VCClient.ViewModels
 		{
 			try
 			{
-				var filteredMap = DepthMapUtils.GetDepthFilteredDepthMap(depthMap, _cutOffDepth);
-				var depthMapImage = DepthMapUtils.GetColorizedDepthMapData(filteredMap, _minDepth, _floorDepth);
+				// the preview buffer is reused by the next frame, the UI thread gets a copy of it;
+				// the lock is not held while waiting for the UI thread, which takes it on disposal
+				ImageData depthMapImage;
+				lock (_depthPreviewLock)
+				{
+					var preview = RenderDepthPreview(depthMap);
+					if (preview == null)
+						return;
+
+					depthMapImage = new ImageData(preview);
+				}
+
 				Dispatcher.Invoke(() =>
 				{
 					DepthImageBitmap = GraphicsUtils.GetWriteableBitmapFromImageData(depthMapImage);
@@ -116,5 +137,43 @@ namespace VCClient.ViewModels
 				_logger.LogException("failed to receive a depth frame", ex);
 			}
 		}
+
+		public void Dispose()
+		{
+			lock (_depthPreviewLock)
+			{
+				_isDisposed = true;
+				_depthPreviewRenderer?.Dispose();
+				_depthPreviewRenderer = null;
+			}
+		}
+
+		private ImageData RenderDepthPreview(DepthMap depthMap)
+		{
+			// frames still come in while the application shuts down
+			if (_isDisposed)
+				return null;
+
+			var sourceSizeChanged = depthMap.Width != _depthPreviewSourceWidth || depthMap.Height != _depthPreviewSourceHeight;
+			if (_depthPreviewRenderer == null || sourceSizeChanged)
+			{
+				if (depthMap.Width <= 0 || depthMap.Height <= 0)
+					return null;
+
+				var previewWidth = Math.Min(depthMap.Width, MaxDepthPreviewWidth);
+				var previewHeight = Math.Max(1, depthMap.Height * previewWidth / depthMap.Width);
+
+				_depthPreviewRenderer?.Dispose();
+				_depthPreviewRenderer = new DepthPreviewRenderer(previewWidth, previewHeight, DepthPreviewPalette.Grayscale);
+				_depthPreview = _depthPreviewRenderer.CreatePreviewImage();
+				_depthPreviewSourceWidth = depthMap.Width;
+				_depthPreviewSourceHeight = depthMap.Height;
+			}
+
+			_depthPreviewRenderer.SetDepthRange(_minDepth, _floorDepth, _cutOffDepth);
+			_depthPreviewRenderer.Render(depthMap, _depthPreview);
+
+			return _depthPreview;
+		}
 	}
 }
@@ -70,6 +70,8 @@ namespace VCClient.ViewModels
 
 		public ICommand CalculateFloorDepthCommand { get; }
 
+		public ICommand CalculateFloorPlaneCommand { get; }
+
 		public WorkAreaSettingsControlVm(ILogger logger, DepthMapProcessor depthMapProcessor, DepthCameraParams depthCameraParams)
 		{
 			_logger = logger;
@@ -78,6 +80,7 @@ namespace VCClient.ViewModels
 			MaxDepth = depthCameraParams.MaxDepth;
 
 			CalculateFloorDepthCommand = new CommandHandler(CalculateFloorDepth, true);
+			CalculateFloorPlaneCommand = new CommandHandler(CalculateFloorPlane, true);
 		}
 
 
@@ -103,6 +106,7 @@ namespace VCClient.ViewModels
 					throw new ArgumentException("Floor depth calculation: return a value less than zero");
 
 				WorkAreaVm.FloorDepth = floorDepth;
+				WorkAreaVm.FloorPlane = null;
 				_logger.LogInfo($"Caculated floor depth as {floorDepth}mm");
 			}
 			catch (Exception ex)
@@ -115,6 +119,41 @@ namespace VCClient.ViewModels
 			}
 		}
 		
+		private void CalculateFloorPlane()
+		{
+			try
+			{
+				if (_latestDepthMap == null)
+				{
+					AutoClosingMessageBox.Show("Нет кадров для обработки!", "Ошибка");
+					_logger.LogInfo("Attempted a floor plane calculation with no maps");
+
+					return;
+				}
+
+				var floorPlane = _depthMapProcessor.CalculateFloorPlane(_latestDepthMap);
+				if (floorPlane == null)
+				{
+					AutoClosingMessageBox.Show("Не удалось найти плоскость пола, уберите объекты из рабочей зоны", "Ошибка");
+					_logger.LogInfo("Failed to fit a floor plane");
+
+					return;
+				}
+
+				WorkAreaVm.FloorDepth = (short)floorPlane.Offset;
+				WorkAreaVm.FloorPlane = floorPlane;
+				_logger.LogInfo($"Calculated floor plane as {floorPlane}");
+			}
+			catch (Exception ex)
+			{
+				_logger.LogException("Failed to calculate floor plane!", ex);
+
+				AutoClosingMessageBox.Show(
+					"Во время вычисления произошла ошибка, автоматический расчёт не был выполнен",
+					"Ошибка");
+			}
+		}
+
 		public void SetColorFrame(ImageData image)
 		{
 			HasReceivedAColorImage = true;
@@ -127,7 +166,7 @@ namespace VCClient.ViewModels
 		{
 			HasReceivedADepthMap = true;
 			WorkAreaVm.DepthMaskPolygonControlVm.CanEditPolygon = true;
-			_latestDepthMap = depthMap;
+			_latestDepthMap = new DepthMap(depthMap);
 
 			var filteredMap = DepthMapUtils.GetDepthFilteredDepthMap(depthMap, WorkAreaVm.CutOffDepth);
 
@@ -5,7 +5,14 @@ namespace VCClient.ViewModels
 {
 	internal class WorkAreaSettingsVm : BaseViewModel
 	{
+		// not editable in the client, kept as they were
+		private readonly int _depthDecimationFactor;
+		private readonly bool _useMedianDepthDecimation;
+		private readonly bool _useDepthDenoising;
+		private readonly bool _useColorBackgroundModel;
+
 		private short _floorDepth;
+		private FloorPlane _floorPlane;
 		private short _minObjHeight;
 		private bool _useColorMask;
 		private MaskPolygonControlVm _colorMaskRectangleControlVm;
@@ -17,7 +24,26 @@ namespace VCClient.ViewModels
 		public short FloorDepth
 		{
 			get => _floorDepth;
-			set => SetField(ref _floorDepth, value, nameof(FloorDepth));
+			set
+			{
+				if (value == _floorDepth)
+					return;
+
+				// the floor is built from the plane when there is one, an edited depth moves the plane with it
+				if (_floorPlane != null)
+				{
+					var offset = _floorPlane.Offset + value - _floorDepth;
+					FloorPlane = new FloorPlane(offset, _floorPlane.SlopeX, _floorPlane.SlopeY);
+				}
+
+				SetField(ref _floorDepth, value, nameof(FloorDepth));
+			}
+		}
+
+		public FloorPlane FloorPlane
+		{
+			get => _floorPlane;
+			set => SetField(ref _floorPlane, value, nameof(FloorPlane));
 		}
 
 		public short MinObjHeight
@@ -61,6 +87,7 @@ namespace VCClient.ViewModels
 		public WorkAreaSettingsVm(WorkAreaSettings settings)
 		{
 			FloorDepth = settings.FloorDepth;
+			FloorPlane = settings.FloorPlane;
 			MinObjHeight = settings.MinObjectHeight;
 			UseColorMask = settings.UseColorMask;
 			ColorMaskRectangleControlVm = new MaskPolygonControlVm();
@@ -69,6 +96,10 @@ namespace VCClient.ViewModels
 			DepthMaskPolygonControlVm = new MaskPolygonControlVm();
 			DepthMaskPolygonControlVm.SetPolygonPoints(settings.DepthMaskContour);
 			RangeMeterCorrectionValue = settings.RangeMeterCorrectionValueMm;
+			_depthDecimationFactor = settings.DepthDecimationFactor;
+			_useMedianDepthDecimation = settings.UseMedianDepthDecimation;
+			_useDepthDenoising = settings.UseDepthDenoising;
+			_useColorBackgroundModel = settings.UseColorBackgroundModel;
 		}
 
 		public WorkAreaSettings GetSettings()
@@ -77,7 +108,14 @@ namespace VCClient.ViewModels
 			var depthMaskPoints = DepthMaskPolygonControlVm.GetPolygonPoints();
 
 			return new WorkAreaSettings(FloorDepth, MinObjHeight, UseColorMask, colorMaskPoints, UseDepthMask,
-				depthMaskPoints, RangeMeterCorrectionValue);
+				depthMaskPoints, RangeMeterCorrectionValue)
+			{
+				FloorPlane = FloorPlane,
+				DepthDecimationFactor = _depthDecimationFactor,
+				UseMedianDepthDecimation = _useMedianDepthDecimation,
+				UseDepthDenoising = _useDepthDenoising,
+				UseColorBackgroundModel = _useColorBackgroundModel
+			};
 		}
 	}
 }
\ No newline at end of file
@@ -76,7 +76,7 @@ namespace VCConfigurator
 		{
 			IoCircuitNames = new ObservableCollection<string> { "", "keusb24r" };
 			RangeMeterNames = new ObservableCollection<string> { "", "custom", "fake" };
-			CameraNames = new ObservableCollection<string> { "kinectv2", "d435", "local" };
+			CameraNames = new ObservableCollection<string> { "kinectv2", "d435", "d435shared", "local" };
 
 			ScalesSettings = new ScalesSettingsVm();
 			IpCameraSettings = new IpCameraSettingsVm();
@@ -1,11 +1,13 @@
 ﻿using ExtIntegration;
 using FrameProcessor;
 using CommonUtils;
+using Primitives;
 using Primitives.Calculation;
 using Primitives.Logging;
 using Primitives.Settings;
 using DeviceIntegration;
 using System;
+using System.IO;
 using System.Net.Http;
 using System.Threading.Tasks;
 using VCServer.DeviceHandling;
@@ -23,6 +25,7 @@ namespace VCServer
 		private ISettingsHandler _settingsHandler;
 		private ApplicationSettings _settings;
 		private RequestProcessor _requestProcessor;
+		private bool _nativeTracingEnabled;
 
 		public ServerComponentsHandler(ILogger logger, HttpClient httpClient)
 		{
@@ -50,12 +53,21 @@ namespace VCServer
 			DmProcessor = new DepthMapProcessor(logger, colorCameraParams, depthCameraParams);
 			DmProcessor.SetProcessorSettings(_settings);
 
+			// the color search is narrowed to the depth object, which needs to know where the color camera is
+			var depthToColorExtrinsics = frameProvider.GetDepthToColorExtrinsics();
+			if (depthToColorExtrinsics != null)
+				DmProcessor.SetDepthToColorExtrinsics(depthToColorExtrinsics.Rotation, depthToColorExtrinsics.TranslationMm);
+
 			Calculator = new CalculationRequestHandler(logger, DmProcessor, DeviceManager.DeviceSet);
 			Calculator.UpdateSettings(_settings);
 			Calculator.CalculationFinished += OnCalculationFinished;
 			Calculator.CalculationStatusChanged += OnStatusChanged;
 			DeviceManager.DeviceEventGenerator.BarcodeReady += Calculator.UpdateBarcode;
 			DeviceManager.DeviceEventGenerator.WeightMeasurementReady += Calculator.UpdateWeight;
+
+			// the frame provider did not exist yet when the settings were first applied
+			if (_nativeTracingEnabled)
+				frameProvider.SetNativeTracingEnabled(true);
 		}
 
 		public async Task InitializeIntegrationsAsync(ILogger integrationLogger)
@@ -92,6 +104,8 @@ namespace VCServer
 		public void Dispose()
 		{
 			_settingsHandler.SaveAsync(_settings);
+			if (_nativeTracingEnabled)
+				WriteNativeTraces();
 			DeviceManager?.Dispose();
 			DisposeSubSystems();
 		}
@@ -119,6 +133,7 @@ namespace VCServer
 			DmProcessor?.SetProcessorSettings(settings);
 			DeviceManager?.DeviceEventGenerator?.UpdateSettings(settings);
 			_requestProcessor?.UpdateSettings(settings);
+			UpdateNativeTracing(settings.GeneralSettings.EnableNativeTracing);
 
 			ApplicationSettingsChanged?.Invoke(settings);
 
@@ -154,5 +169,45 @@ namespace VCServer
 			_requestProcessor.UpdateCalculationStatus(status);
 			DeviceManager.DeviceStateUpdater.UpdateCalculationStatus(status);
 		}
+
+		// traces are written when tracing gets switched off, so a session covers everything since it was switched on
+		private void UpdateNativeTracing(bool enabled)
+		{
+			if (enabled == _nativeTracingEnabled)
+				return;
+
+			if (!enabled)
+				WriteNativeTraces();
+
+			DepthMapProcessor.SetTracingEnabled(enabled);
+			DeviceManager?.DeviceSet?.FrameProvider?.SetNativeTracingEnabled(enabled);
+			_nativeTracingEnabled = enabled;
+
+			_logger.LogInfo($"Native tracing is {(enabled ? "enabled" : "disabled")}");
+		}
+
+		private void WriteNativeTraces()
+		{
+			try
+			{
+				var tracesDirectory = Path.Combine(GlobalConstants.AppLogsPath, "traces");
+				Directory.CreateDirectory(tracesDirectory);
+
+				var sessionName = DateTime.Now.ToString("yyyyMMdd_HHmmss");
+				var processorTracePath = Path.Combine(tracesDirectory, $"{sessionName}_processor.json");
+				var cameraTracePath = Path.Combine(tracesDirectory, $"{sessionName}_camera.json");
+
+				if (DepthMapProcessor.WriteTrace(processorTracePath))
+					_logger.LogInfo($"Native processor trace was written to {processorTracePath}");
+
+				var frameProvider = DeviceManager?.DeviceSet?.FrameProvider;
+				if (frameProvider != null && frameProvider.WriteNativeTrace(cameraTracePath))
+					_logger.LogInfo($"Native camera trace was written to {cameraTracePath}");
+			}
+			catch (Exception ex)
+			{
+				_logger.LogException("Failed to write native traces", ex);
+			}
+		}
 	}
 }
@@ -87,8 +87,8 @@ namespace VCServer
 			var fullImagePath = Path.Combine(_imageSavingPath, $"{itemIndex}.png");
 			await ImageUtils.SaveImageDataToFileAsync(image, fullImagePath);
 
-			var fullMapPath = Path.Combine(_mapSavingPath, $"{itemIndex}.dm");
-			await DepthMapUtils.SaveDepthMapToRawFileAsync(map, fullMapPath);
+			var fullMapPath = Path.Combine(_mapSavingPath, $"{itemIndex}{DepthMapCodec.FileExtension}");
+			await DepthMapCodec.SaveDepthMapToFileAsync(map, fullMapPath);
 
 			_samplesLeft--;
 
@@ -107,7 +107,7 @@ namespace VCServer
 
 		private void OnColorFrameReady(ImageData image)
 		{
-			_latestColorFrame = image;
+			_latestColorFrame = new ImageData(image);
 
 			_colorFrameReady = true;
 
@@ -119,7 +119,7 @@ namespace VCServer
 
 		private void OnDepthFrameReady(DepthMap depthMap)
 		{
-			_latestDepthMap = depthMap;
+			_latestDepthMap = new DepthMap(depthMap);
 
 			_depthFrameReady = true;
 
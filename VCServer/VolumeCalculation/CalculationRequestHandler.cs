@@ -15,6 +15,8 @@ namespace VCServer.VolumeCalculation
 {
 	public sealed class CalculationRequestHandler : IDisposable
 	{
+		private const int ColorBackgroundUpdateIntervalMs = 500;
+
 		private readonly ILogger _logger;
 		private readonly DepthMapProcessor _dmProcessor;
 		private readonly DeviceSet _deviceManager;
@@ -42,6 +44,12 @@ namespace VCServer.VolumeCalculation
 		private WeightUnits _selectedWeightUnits;
 		private ApplicationSettings _settings;
 		private bool _subtractPalletValues;
+		private bool _useIntegratedVolume;
+		private volatile bool _useColorBackgroundModel;
+
+		private readonly object _latestDepthMapLock;
+		private DepthMap _latestDepthMap;
+		private DateTime _lastColorBackgroundUpdateTime;
 
 		private VolumeCalculationLogic _volumeCalculator;
 
@@ -54,10 +62,17 @@ namespace VCServer.VolumeCalculation
 			_logger = logger;
 			_dmProcessor = dmProcessor;
 			_deviceManager = deviceSet;
+			_latestDepthMapLock = new object();
 
 			_autoStartingCheckingTimer = new Timer(200) { AutoReset = true };
 			_autoStartingCheckingTimer.Elapsed += RunUpdateRoutine;
 			_autoStartingCheckingTimer.Start();
+
+			if (_deviceManager.FrameProvider != null)
+			{
+				_deviceManager.FrameProvider.DepthFrameReady += OnDepthFrameReady;
+				_deviceManager.FrameProvider.ColorFrameReady += OnColorFrameReady;
+			}
 		}
 
 		private bool CalculationRunning { get; set; }
@@ -90,6 +105,18 @@ namespace VCServer.VolumeCalculation
 		{
 			_autoStartingCheckingTimer?.Dispose();
 			_pendingTimer?.Dispose();
+
+			if (_deviceManager.FrameProvider != null)
+			{
+				_deviceManager.FrameProvider.DepthFrameReady -= OnDepthFrameReady;
+				_deviceManager.FrameProvider.ColorFrameReady -= OnColorFrameReady;
+			}
+
+			lock (_latestDepthMapLock)
+			{
+				_latestDepthMap?.Release();
+				_latestDepthMap = null;
+			}
 		}
 
 		public event Action<CalculationResultData> CalculationFinished;
@@ -151,6 +178,7 @@ namespace VCServer.VolumeCalculation
 					var calculationIndex = IoUtils.GetCurrentUniversalObjectCounter(GlobalConstants.CountersFileName);
 
 					var calculationData = new VolumeCalculationData(_settings.AlgorithmSettings.SampleDepthMapCount,
+						_settings.AlgorithmSettings.MinSampleDepthMapCount, _settings.AlgorithmSettings.SampleToleranceMm,
 						_lastBarcode, calculationIndex, dm1Enabled, dm2Enabled, rgbEnabled,
 						_settings.GeneralSettings.PhotosDirectoryPath, activeWorkArea.RangeMeterCorrectionValueMm);
 
@@ -184,6 +212,8 @@ namespace VCServer.VolumeCalculation
 
 			_subtractPalletValues = settings.AlgorithmSettings.EnablePalletSubtraction;
 			_palletHeightMm = settings.AlgorithmSettings.PalletHeightMm;
+			_useIntegratedVolume = settings.AlgorithmSettings.EnableVolumeIntegration;
+			_useColorBackgroundModel = settings.AlgorithmSettings.WorkArea.UseColorBackgroundModel;
 			CreateAutoStartTimer(settings.AlgorithmSettings.EnableAutoTimer,
 				settings.AlgorithmSettings.TimeToStartMeasurementMs);
 		}
@@ -250,6 +280,50 @@ namespace VCServer.VolumeCalculation
 			StartCalculation(null);
 		}
 
+		private void OnDepthFrameReady(DepthMap depthMap)
+		{
+			lock (_latestDepthMapLock)
+			{
+				_latestDepthMap?.Release();
+				_latestDepthMap = depthMap.Retain();
+			}
+		}
+
+		// keeps the model of the empty work area up to date between measurements
+		private void OnColorFrameReady(ImageData image)
+		{
+			if (!_useColorBackgroundModel || CalculationRunning)
+				return;
+
+			var scalesAreLoaded = _currentWeighingStatus == MeasurementStatus.Measuring ||
+								_currentWeighingStatus == MeasurementStatus.Measured;
+			if (scalesAreLoaded)
+				return;
+
+			var now = DateTime.Now;
+			if ((now - _lastColorBackgroundUpdateTime).TotalMilliseconds < ColorBackgroundUpdateIntervalMs)
+				return;
+
+			_lastColorBackgroundUpdateTime = now;
+
+			DepthMap latestDepthMap;
+			lock (_latestDepthMapLock)
+				latestDepthMap = _latestDepthMap?.Retain();
+
+			try
+			{
+				_dmProcessor.UpdateColorBackground(latestDepthMap, image);
+			}
+			catch (Exception ex)
+			{
+				_logger.LogException("Failed to update the color background model", ex);
+			}
+			finally
+			{
+				latestDepthMap?.Release();
+			}
+		}
+
 		private void OnCalculationFinished(VolumeCalculationResultData resultData)
 		{
 			try
@@ -265,7 +339,11 @@ namespace VCServer.VolumeCalculation
 				var correctedWidth =
 					(int)(_subtractPalletValues ? result.WidthMm / correctedUnitCount : result.WidthMm);
 				var correctedHeight = _subtractPalletValues ? result.HeightMm - _palletHeightMm : result.HeightMm;
-				var correctedVolume = correctedLength * correctedWidth * correctedHeight;
+				var boxVolume = correctedLength * correctedWidth * correctedHeight;
+
+				// the integrated volume covers the whole blob, so it can not be split between pallet and units
+				var integratedVolumeIsUsable = _useIntegratedVolume && !_subtractPalletValues && result.VolumeMm3 > 0;
+				var correctedVolume = integratedVolumeIsUsable ? result.VolumeMm3 : boxVolume;
 
 				var calculationResult = new CalculationResult(_calculationTime, _lastBarcode, _lastWeightGr,
 					_selectedWeightUnits, _lastUnitCount, correctedLength, correctedWidth, correctedHeight,
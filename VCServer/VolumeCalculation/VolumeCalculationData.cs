@@ -2,8 +2,13 @@
 {
 	internal sealed class VolumeCalculationData
 	{
+		// the most samples the measurement takes
 		public int RequiredSampleCount { get; }
 
+		public int MinSampleCount { get; }
+
+		public int SampleToleranceMm { get; }
+
 		public string Barcode { get; }
 
 		public int CalculationIndex { get; }
@@ -18,11 +23,13 @@
 
 		public int RangeMeterCorrectionValue { get; }
 
-		public VolumeCalculationData(int requiredSampleCount,
+		public VolumeCalculationData(int requiredSampleCount, int minSampleCount, int sampleToleranceMm,
 			string barcode, int calculationIndex, bool dm1AlgorithmEnabled, bool dm2AlgorithmEnabled,
 			bool rgbAlgorithmEnabled, string photosDirectoryPath, int rangeMeterCorrectionValue)
 		{
 			RequiredSampleCount = requiredSampleCount;
+			MinSampleCount = minSampleCount;
+			SampleToleranceMm = sampleToleranceMm;
 			Barcode = barcode;
 			CalculationIndex = calculationIndex;
 			Dm1AlgorithmEnabled = dm1AlgorithmEnabled;
@@ -1,5 +1,4 @@
 ﻿using System;
-using System.Collections.Generic;
 using System.IO;
 using System.Threading;
 using System.Threading.Tasks;
@@ -26,8 +25,6 @@ namespace VCServer.VolumeCalculation
 		private readonly IRangeMeter _rangeMeter;
 		private readonly IIpCamera _ipCamera;
 
-		private readonly VolumeCalculationData _calculationData;
-		private readonly int _requiredSampleCount;
 		private readonly string _barcode;
 		private readonly int _calculationIndex;
 		private readonly short _floorDepth;
@@ -42,8 +39,19 @@ namespace VCServer.VolumeCalculation
 		private ImageData _latestColorFrame;
 		private DepthMap _latestDepthMap;
 
-		private readonly List<ImageData> _images;
-		private readonly List<DepthMap> _depthMaps;
+		// frames wait here for a frame of the other stream, a complete pair is handed over to a single worker
+		// which measures the samples off the frame streams' threads, the newest pair waits while it is busy;
+		// the calculator is disposed under the lock once the measurement is finished and the worker is idle.
+		// Pooled frames are retained while they are kept here and released once they are no longer needed
+		private readonly object _sampleLock;
+		private ImageData _pendingImage;
+		private DepthMap _pendingDepthMap;
+		private bool _isMeasuring;
+		private bool _isFinished;
+
+		// only touched by the worker
+		private int _sampleCount;
+		private short _calculatedDistance;
 
 		private readonly VolumeCalculator _calculator;
 
@@ -57,8 +65,6 @@ namespace VCServer.VolumeCalculation
 			_rangeMeter = rangeMeter;
 			_ipCamera = ipCamera;
 
-			_calculationData = calculationData;
-			_requiredSampleCount = calculationData.RequiredSampleCount;
 			_barcode = calculationData.Barcode;
 			_calculationIndex = calculationData.CalculationIndex;
 			_photoDirectoryPath = calculationData.PhotosDirectoryPath;
@@ -66,10 +72,8 @@ namespace VCServer.VolumeCalculation
 			_cutOffDepth = workArea.GetCutOffDepth();
 			_rangeMeterCorrectionValueMm = calculationData.RangeMeterCorrectionValue;
 
-			_images = new List<ImageData>();
-			_depthMaps = new List<DepthMap>();
-
-			_calculator = new VolumeCalculator(logger, processor);
+			_sampleLock = new object();
+			_calculator = new VolumeCalculator(logger, processor, calculationData);
 
 			frameProvider.UnrestrictedDepthFrameReady += OnDepthFrameReady;
 			frameProvider.UnrestrictedColorFrameReady += OnColorFrameReady;
@@ -100,20 +104,121 @@ namespace VCServer.VolumeCalculation
 		private void AbortInternal(CalculationStatus status)
 		{
 			CleanUp();
-			var result = new ObjectVolumeData(0, 0, 0);
-			var resultData = new VolumeCalculationResultData(result, status, _latestColorFrame,
+			var result = new ObjectVolumeData(0, 0, 0, 0);
+			var resultData = new VolumeCalculationResultData(result, status, GetLatestColorFrameCopy(),
 					AlgorithmSelectionStatus.Undefined, false);
+			ReleaseFrames();
 			CalculationFinished?.Invoke(resultData);
 		}
 
-		private async Task PerformCalculation()
+		private void StartMeasuring()
 		{
-			await SaveDebugDataAsync($"{_barcode}_{_calculationIndex}");
-			var calculatedDistance = GetCalculatedDistance();
+			if (_isMeasuring || !TryTakePendingSample(out var image, out var depthMap))
+				return;
+
+			_isMeasuring = true;
+			Task.Run(() => MeasureSamples(image, depthMap));
+		}
+
+		private bool TryTakePendingSample(out ImageData image, out DepthMap depthMap)
+		{
+			image = _pendingImage;
+			depthMap = _pendingDepthMap;
+			if (image == null || depthMap == null)
+				return false;
+
+			_pendingImage = null;
+			_pendingDepthMap = null;
+
+			return true;
+		}
+
+		private void MeasureSamples(ImageData image, DepthMap depthMap)
+		{
+			while (true)
+			{
+				var result = MeasureSample(image, depthMap);
+				image.Release();
+				depthMap.Release();
+
+				lock (_sampleLock)
+				{
+					if (_isFinished)
+					{
+						// the calculation timed out while the sample was measured
+						_isMeasuring = false;
+						_calculator.Dispose();
+						return;
+					}
+
+					if (result == null)
+					{
+						if (TryTakePendingSample(out image, out depthMap))
+							continue;
+
+						_isMeasuring = false;
+						return;
+					}
+
+					_isFinished = true;
+					_isMeasuring = false;
+					_calculator.Dispose();
+				}
+
+				FinishCalculation(result);
+				return;
+			}
+		}
+
+		private VolumeCalculationResultData MeasureSample(ImageData image, DepthMap depthMap)
+		{
+			_sampleCount++;
+			_logger.LogInfo($"added sample, count={_sampleCount}");
+
+			// nothing observes the worker, so the exceptions end the calculation here
+			try
+			{
+				if (_sampleCount == 1)
+					_calculatedDistance = GetCalculatedDistance();
+
+				return _calculator.AddSample(depthMap, image, _calculatedDistance);
+			}
+			catch (Exception ex)
+			{
+				_logger.LogException("Failed to measure a sample", ex);
+				return new VolumeCalculationResultData(null, CalculationStatus.CalculationError, GetLatestColorFrameCopy(),
+					AlgorithmSelectionStatus.Undefined, false);
+			}
+		}
 
-			var result = _calculator.Calculate(_images, _depthMaps, _calculationData, calculatedDistance);
+		private async Task FinishCalculation(VolumeCalculationResultData result)
+		{
+			CleanUp();
+			await SaveDebugDataAsync($"{_barcode}_{_calculationIndex}");
+			ReleaseFrames();
 			CalculationFinished?.Invoke(result);
-			_updateTimeoutTimer.Stop();
+		}
+
+		// the result outlives the frames, which go back to the provider's pool
+		private ImageData GetLatestColorFrameCopy()
+		{
+			lock (_sampleLock)
+				return _latestColorFrame == null ? null : new ImageData(_latestColorFrame);
+		}
+
+		private void ReleaseFrames()
+		{
+			lock (_sampleLock)
+			{
+				_pendingImage?.Release();
+				_pendingImage = null;
+				_pendingDepthMap?.Release();
+				_pendingDepthMap = null;
+				_latestColorFrame?.Release();
+				_latestColorFrame = null;
+				_latestDepthMap?.Release();
+				_latestDepthMap = null;
+			}
 		}
 
 		private short GetCalculatedDistance()
@@ -143,36 +248,50 @@ namespace VCServer.VolumeCalculation
 
 		private void OnColorFrameReady(ImageData image)
 		{
-			if (_images.Count == _requiredSampleCount)
-				return;
-
-			_logger.LogInfo($"added color frame, count={_images.Count}");
+			lock (_sampleLock)
+			{
+				if (_isFinished)
+					return;
 
-			_latestColorFrame = image;
-			_images.Add(image);
+				// samples outlive the frame event, the frames are kept from going back to the provider's pool until then
+				_pendingImage?.Release();
+				_pendingImage = image.Retain();
+				_latestColorFrame?.Release();
+				_latestColorFrame = image.Retain();
 
-			if (_depthMaps.Count == _requiredSampleCount)
-				PerformCalculation();
+				StartMeasuring();
+			}
 		}
 
 		private void OnDepthFrameReady(DepthMap depthMap)
 		{
-			if (_depthMaps.Count == _requiredSampleCount)
-				return;
-
-			_logger.LogInfo($"added depth frame, count={_depthMaps.Count}");
+			lock (_sampleLock)
+			{
+				if (_isFinished)
+					return;
 
-			_latestDepthMap = depthMap;
-			_depthMaps.Add(depthMap);
+				_pendingDepthMap?.Release();
+				_pendingDepthMap = depthMap.Retain();
+				_latestDepthMap?.Release();
+				_latestDepthMap = depthMap.Retain();
 
-			if (_images.Count == _requiredSampleCount)
-				PerformCalculation();
+				StartMeasuring();
+			}
 		}
 
 		private void OnTimerElapsed(object sender, ElapsedEventArgs e)
 		{
-			var samplesCollected = _depthMaps?.Count ?? 0;
-			_logger.LogInfo($"Timeout timer elapsed (samples collected={samplesCollected}), aborting calculation...");
+			lock (_sampleLock)
+			{
+				if (_isFinished)
+					return;
+
+				_isFinished = true;
+				if (!_isMeasuring)
+					_calculator.Dispose();
+			}
+
+			_logger.LogInfo($"Timeout timer elapsed (samples collected={_sampleCount}), aborting calculation...");
 
 			CleanUp();
 			AbortInternal(CalculationStatus.TimedOut);
@@ -198,6 +317,9 @@ namespace VCServer.VolumeCalculation
 
 					await DepthMapUtils.SaveDepthMapImageToFile(_latestDepthMap, depthFileName,
 						depthCameraParams.MinDepth, depthCameraParams.MaxDepth, _cutOffDepth);
+
+					var rawDepthFileName = $"{baseFilePath}_depth{DepthMapCodec.FileExtension}";
+					await DepthMapCodec.SaveDepthMapToFileAsync(_latestDepthMap, rawDepthFileName);
 				}
 
 				var cameraIsEnabled = _ipCamera != null && _ipCamera.Initialized();
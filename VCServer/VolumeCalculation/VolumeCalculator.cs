@@ -1,6 +1,5 @@
 ﻿using System;
 using System.Collections.Generic;
-using System.Linq;
 using FrameProcessor;
 using Primitives;
 using Primitives.Calculation;
@@ -8,75 +7,113 @@ using Primitives.Logging;
 
 namespace VCServer.VolumeCalculation
 {
-	internal sealed class VolumeCalculator
+	// Measures one object from samples that are given to it one at a time, the algorithm is selected on the first
+	// sample. The measurement is complete once the samples converge or RequiredSampleCount samples were taken.
+	internal sealed class VolumeCalculator : IDisposable
 	{
 		private readonly ILogger _logger;
 		private readonly DepthMapProcessor _processor;
+		private readonly VolumeCalculationData _data;
+		private readonly VolumeSampleAggregator _aggregator;
 
-		public VolumeCalculator(ILogger logger, DepthMapProcessor processor)
+		private ImageData _firstImage;
+		private AlgorithmSelectionResult _algorithmSelectionResult;
+		private int _sampleCount;
+		private VolumeSampleAggregate _aggregate;
+
+		public VolumeCalculator(ILogger logger, DepthMapProcessor processor, VolumeCalculationData data)
 		{
 			_logger = logger;
 			_processor = processor;
+			_data = data;
+			_aggregator = new VolumeSampleAggregator(data.MinSampleCount, data.RequiredSampleCount, data.SampleToleranceMm);
+		}
+
+		public void Dispose()
+		{
+			_aggregator.Dispose();
 		}
 
 		public VolumeCalculationResultData Calculate(IReadOnlyList<ImageData> images, IReadOnlyList<DepthMap> depthMaps,
-			VolumeCalculationData data, short calculatedDistance)
+			short calculatedDistance)
 		{
-			if (images.Count == 0 || depthMaps.Count == 0)
+			var sampleCount = Math.Min(images.Count, depthMaps.Count);
+			if (sampleCount == 0)
 				throw new ArgumentException("not enough input frames");
 
-			var firstImage = images[0];
+			for (var i = 0; i < sampleCount; i++)
+			{
+				var result = AddSample(depthMaps[i], images[i], calculatedDistance);
+				if (result != null)
+					return result;
+			}
 
-			var algorithmSelectionData = new AlgorithmSelectionData(depthMaps[0], firstImage, calculatedDistance,
-				data.Dm1AlgorithmEnabled, data.Dm2AlgorithmEnabled, data.RgbAlgorithmEnabled, data.PhotosDirectoryPath);
+			return GetResult();
+		}
 
-			var algorithmSelectionResult = _processor.SelectAlgorithm(algorithmSelectionData);
-			var algorithm = algorithmSelectionResult.Status;
-			var rangeMeterWasUsed = algorithmSelectionResult.RangeMeterWasUsed;
-			if (!algorithmSelectionResult.IsSelected)
-				return new VolumeCalculationResultData(null, CalculationStatus.FailedToSelectAlgorithm,
-					firstImage, algorithm, algorithmSelectionResult.RangeMeterWasUsed);
+		// null while the measurement needs more samples
+		public VolumeCalculationResultData AddSample(DepthMap depthMap, ImageData image, short calculatedDistance)
+		{
+			if (_firstImage == null)
+			{
+				// the photo goes out with the result, the sample frames may go back to their pool before that
+				_firstImage = new ImageData(image);
+
+				var algorithmSelectionData = new AlgorithmSelectionData(depthMap, image, calculatedDistance,
+					_data.Dm1AlgorithmEnabled, _data.Dm2AlgorithmEnabled, _data.RgbAlgorithmEnabled, _data.PhotosDirectoryPath);
 
-			var results = new List<ObjectVolumeData>();
+				_algorithmSelectionResult = _processor.SelectAlgorithm(algorithmSelectionData);
+				if (!_algorithmSelectionResult.IsSelected)
+					return new VolumeCalculationResultData(null, CalculationStatus.FailedToSelectAlgorithm, _firstImage,
+						_algorithmSelectionResult.Status, _algorithmSelectionResult.RangeMeterWasUsed);
+			}
+
+			_sampleCount++;
 
-			for (var i = 0; i < data.RequiredSampleCount; i++)
+			var sample = _processor.CalculateVolume(depthMap, image, calculatedDistance, _algorithmSelectionResult.Status);
+			if (sample != null)
 			{
-				var currentResult = _processor.CalculateVolume(depthMaps[i], images[i], calculatedDistance, algorithm);
-				results.Add(currentResult);
+				_aggregate = _aggregator.Add(sample);
+				_logger.LogInfo($"Measured sample {_sampleCount}: {{{sample.LengthMm} {sample.WidthMm} {sample.HeightMm}}}, " +
+					$"spread of the latest samples {{{_aggregate.LengthSpreadMm} {_aggregate.WidthSpreadMm} {_aggregate.HeightSpreadMm}}}");
 			}
 
-			var aggregatedResult = AggregateCalculationsData(results);
-			var resultStatus = aggregatedResult != null
-				? CalculationStatus.Successful
-				: CalculationStatus.CalculationError;
+			var isComplete = _aggregate?.IsComplete == true || _sampleCount >= _data.RequiredSampleCount;
 
-			return new VolumeCalculationResultData(aggregatedResult, resultStatus, firstImage, algorithm, rangeMeterWasUsed);
+			return isComplete ? GetResult() : null;
 		}
 
-		private ObjectVolumeData AggregateCalculationsData(IReadOnlyList<ObjectVolumeData> results)
+		private VolumeCalculationResultData GetResult()
 		{
-			try
+			var result = _aggregate?.Result;
+			var resultStatus = result != null
+				? CalculationStatus.Successful
+				: CalculationStatus.CalculationError;
+
+			if (_aggregate != null)
 			{
-				var lengths = results.Where(r => r != null).Select(r => r.LengthMm);
-				var widths = results.Where(r => r != null).Select(r => r.WidthMm);
-				var heights = results.Where(r => r != null).Select(r => r.HeightMm);
+				var stopReason = _aggregate.IsConverged ? "converged" : "reached the sample limit";
+				_logger.LogInfo($"Measurement {stopReason} after {_sampleCount} samples: " +
+					$"{{{result.LengthMm} {result.WidthMm} {result.HeightMm}}}");
+			}
+
+			LogLatencies(result);
 
-				var joinedLengths = string.Join(",", lengths);
-				var joinedWidths = string.Join(",", widths);
-				var joinedHeights = string.Join(",", heights);
-				_logger.LogInfo($"Measured values: {{{joinedLengths}}}; {{{joinedWidths}}}; {{{joinedHeights}}}");
+			return new VolumeCalculationResultData(result, resultStatus, _firstImage, _algorithmSelectionResult.Status,
+				_algorithmSelectionResult.RangeMeterWasUsed);
+		}
 
-				var modeLength = lengths.GroupBy(x => x).OrderByDescending(g => g.Count()).First().Key;
-				var modeWidth = widths.GroupBy(x => x).OrderByDescending(g => g.Count()).First().Key;
-				var modeHeight = heights.GroupBy(x => x).OrderByDescending(g => g.Count()).First().Key;
+		private void LogLatencies(ObjectVolumeData result)
+		{
+			if (result == null || result.CaptureTimestampUs <= 0)
+				return;
 
-				return new ObjectVolumeData(modeLength, modeWidth, modeHeight);
-			}
-			catch (Exception ex)
-			{
-				_logger.LogException("Failed to aggregate calculation results", ex);
-				return null;
-			}
+			var nowUs = (DateTime.UtcNow - DateTime.UnixEpoch).Ticks / 10;
+			var latencyMs = (nowUs - result.CaptureTimestampUs) / 1000.0;
+			_logger.LogInfo($"Measured frame {result.FrameNumber}, {latencyMs:0.0}ms after it was captured");
+
+			foreach (LatencyStage stage in Enum.GetValues(typeof(LatencyStage)))
+				_logger.LogInfo($"{stage} latency: {DepthMapProcessor.GetLatencyStats(stage)}");
 		}
 	}
 }